@@ -0,0 +1,121 @@
+/**
+ * @file AudioArena.cpp
+ * @brief One pre-faulted, aligned mapping that audio buffers are carved from
+ */
+
+#include "AudioArena.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+
+namespace {
+
+// "[never]" in the THP mode means madvise(MADV_HUGEPAGE) succeeds but does nothing
+bool transparentHugePagesEnabled() {
+    char mode[128] = {};
+    FILE* f = std::fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (!f) return false;
+    bool ok = std::fgets(mode, sizeof(mode), f) != nullptr;
+    std::fclose(f);
+    return ok && std::strstr(mode, "[never]") == nullptr;
+}
+
+} // namespace
+
+AudioArena::~AudioArena() {
+    release();
+}
+
+size_t AudioArena::hugePageSize() {
+    static size_t cached = 0;
+    if (cached != 0) return cached;
+
+    size_t kb = 0;
+    if (FILE* f = std::fopen("/proc/meminfo", "r")) {
+        char line[128];
+        while (std::fgets(line, sizeof(line), f)) {
+            if (std::sscanf(line, "Hugepagesize: %zu kB", &kb) == 1) break;
+        }
+        std::fclose(f);
+    }
+    cached = kb > 0 ? kb * 1024 : 2 * 1024 * 1024;
+    return cached;
+}
+
+bool AudioArena::allocate(size_t bytes, bool hugePages) {
+    release();
+    if (bytes == 0) return false;
+
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE;
+    size_t size = bytes;
+    void* base = MAP_FAILED;
+
+    if (hugePages) {
+        // Explicit huge pages need a reserved pool (vm.nr_hugepages)
+        size_t hugePage = hugePageSize();
+        size = (bytes + hugePage - 1) & ~(hugePage - 1);
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        if (base != MAP_FAILED) {
+            m_backing = "hugetlb";
+        } else {
+            // Fall back to normal pages, asking for THP before they are populated.
+            // THP needs huge-page-aligned ranges: over-map, then trim both ends.
+            void* raw = mmap(nullptr, size + hugePage, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw != MAP_FAILED) {
+                uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+                uintptr_t aligned = (start + hugePage - 1) & ~(static_cast<uintptr_t>(hugePage) - 1);
+                if (aligned > start) munmap(raw, aligned - start);
+                size_t tail = (start + size + hugePage) - (aligned + size);
+                if (tail > 0) munmap(reinterpret_cast<void*>(aligned + size), tail);
+                base = reinterpret_cast<void*>(aligned);
+
+                bool thp = transparentHugePagesEnabled() && madvise(base, size, MADV_HUGEPAGE) == 0;
+                volatile uint8_t* page = static_cast<uint8_t*>(base);
+                size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                for (size_t offset = 0; offset < size; offset += pageSize) page[offset] = 0;
+                m_backing = thp ? "thp" : "4k";
+            }
+        }
+    } else {
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        m_backing = "4k";
+    }
+
+    if (base == MAP_FAILED) {
+        m_backing = "none";
+        return false;
+    }
+
+    m_base = static_cast<uint8_t*>(base);
+    m_size = size;
+    m_used = 0;
+    return true;
+}
+
+uint8_t* AudioArena::carve(size_t bytes, size_t alignment) {
+    if (!m_base) return nullptr;
+
+    size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+    if (offset > m_size || bytes > m_size - offset) return nullptr;
+
+    m_used = offset + bytes;
+    return m_base + offset;
+}
+
+void AudioArena::release() {
+    if (m_base) {
+        munmap(m_base, m_size);
+    }
+    m_base = nullptr;
+    m_size = 0;
+    m_used = 0;
+    m_backing = "none";
+}
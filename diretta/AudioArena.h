@@ -0,0 +1,64 @@
+/**
+ * @file AudioArena.h
+ * @brief One pre-faulted, aligned mapping that audio buffers are carved from
+ *
+ * Buffers are sized once from the configured maximum format and carved out
+ * of the arena at startup, so nothing on the audio path reallocates after the
+ * first track (format changes only reuse the carved space). Carved blocks are
+ * never freed individually; the whole mapping goes away with the arena.
+ */
+
+#ifndef SQUEEZE2DIRETTA_AUDIOARENA_H
+#define SQUEEZE2DIRETTA_AUDIOARENA_H
+
+#include <cstddef>
+#include <cstdint>
+
+class AudioArena {
+public:
+    static constexpr size_t DEFAULT_ALIGNMENT = 64;
+
+    AudioArena() = default;
+    ~AudioArena();
+
+    AudioArena(const AudioArena&) = delete;
+    AudioArena& operator=(const AudioArena&) = delete;
+
+    /**
+     * @brief Map and pre-fault the arena (replaces any previous mapping)
+     * @param hugePages Try MAP_HUGETLB (needs vm.nr_hugepages), then
+     *                  transparent huge pages via madvise(MADV_HUGEPAGE)
+     * @return false if the mapping failed
+     */
+    bool allocate(size_t bytes, bool hugePages = false);
+
+    /**
+     * @brief Huge page size of this kernel (2 MB on x86-64 and 4K-page arm64,
+     *        32 MB with 16K pages), from /proc/meminfo
+     */
+    static size_t hugePageSize();
+
+    /**
+     * @brief Carve an aligned block, nullptr if the arena is exhausted
+     */
+    uint8_t* carve(size_t bytes, size_t alignment = DEFAULT_ALIGNMENT);
+
+    void release();
+
+    size_t capacity() const { return m_size; }
+    size_t used() const { return m_used; }
+    bool valid() const { return m_base != nullptr; }
+
+    /**
+     * @brief Backing pages: "hugetlb", "thp" (madvise), or "4k"
+     */
+    const char* backing() const { return m_backing; }
+
+private:
+    uint8_t* m_base = nullptr;
+    size_t m_size = 0;
+    size_t m_used = 0;
+    const char* m_backing = "none";
+};
+
+#endif // SQUEEZE2DIRETTA_AUDIOARENA_H
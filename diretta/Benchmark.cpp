@@ -0,0 +1,506 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Built-in micro-benchmarks (--bench <name>)
+ */
+
+#include "Benchmark.h"
+#include "AudioArena.h"
+#include "ConvertPool.h"
+#include "CpuInfo.h"
+#include "MemcpyCalibration.h"
+#include "DirettaRingBuffer.h"
+#include "PerfCounter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+constexpr uint64_t DTLB_READ_MISS = PERF_COUNT_HW_CACHE_DTLB |
+                                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+constexpr uint64_t LLC_READ_MISS = PERF_COUNT_HW_CACHE_LL |
+                                   (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+int64_t threadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// Missing counters (no PMU access, or the event is not supported) stay at -1
+struct ThreadMeasure {
+    double cpuMs = 0;
+    int64_t dtlbMisses = -1;
+    int64_t llcMisses = -1;
+};
+
+// CPU time, dTLB and LLC read misses of the calling thread while fn() runs
+template <typename Fn>
+ThreadMeasure measureThread(Fn fn) {
+    PerfCounterGroup perf;
+    int dtlb = perf.add(PERF_TYPE_HW_CACHE, DTLB_READ_MISS);
+    int llc = perf.add(PERF_TYPE_HW_CACHE, LLC_READ_MISS);
+
+    ThreadMeasure m;
+    perf.reset();
+    perf.enable();
+    int64_t cpuStart = threadCpuNs();
+    fn();
+    m.cpuMs = (threadCpuNs() - cpuStart) / 1e6;
+    perf.disable();
+
+    uint64_t values[PerfCounterGroup::MAX_COUNTERS] = {};
+    if (perf.read(values)) {
+        if (dtlb >= 0) m.dtlbMisses = static_cast<int64_t>(values[dtlb]);
+        if (llc >= 0) m.llcMisses = static_cast<int64_t>(values[llc]);
+    }
+    return m;
+}
+
+//=============================================================================
+// Ring producer/consumer harness (ring, ntstore)
+//=============================================================================
+
+namespace RingBench {
+    constexpr size_t RING_BYTES = 16 * 1024 * 1024;       // DirettaBuffer::MAX_BUFFER_BYTES
+    constexpr size_t PUSH_BYTES = 16384;                  // Wrapper pipe chunk
+    constexpr size_t POP_BYTES = 5648;                    // DSD512 stereo, 1ms buffer
+    constexpr uint64_t TOTAL_BYTES = 2048ULL * 1024 * 1024;
+}
+
+struct RingBenchParams {
+    bool hugePages = false;
+    size_t streamThreshold = SIZE_MAX;    // DirettaRingBuffer::setStreamingStoreThreshold()
+    size_t hotSetBytes = 0;               // Consumer working set read after every pop
+};
+
+struct RingBenchResult {
+    std::string backing;
+    double wallMs = 0;
+    double streamedPct = 0;
+    ThreadMeasure producer;
+    ThreadMeasure consumer;
+};
+
+bool runRingOnce(const RingBenchParams& params, RingBenchResult& result) {
+    using namespace RingBench;
+
+    AudioArena arena;
+    if (!arena.allocate(RING_BYTES + AudioArena::DEFAULT_ALIGNMENT, params.hugePages)) {
+        return false;
+    }
+    auto ring = std::make_unique<DirettaRingBuffer>();
+    ring->attachStorage(arena.carve(RING_BYTES), RING_BYTES);
+    ring->resize(RING_BYTES, 0x00);
+    ring->setStreamingStoreThreshold(params.streamThreshold);
+    result.backing = arena.backing();
+
+    std::vector<uint8_t> src(PUSH_BYTES, 0x55);
+    std::vector<uint8_t> dst(POP_BYTES);
+    std::vector<uint8_t> hotSet(params.hotSetBytes, 0x01);
+    volatile uint64_t hotSum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        result.producer = measureThread([&]() {
+            uint64_t pushed = 0;
+            while (pushed < TOTAL_BYTES) {
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>(PUSH_BYTES, TOTAL_BYTES - pushed));
+                size_t n = ring->push(src.data(), chunk);
+                if (n == 0) std::this_thread::yield();
+                pushed += n;
+            }
+        });
+    });
+
+    result.consumer = measureThread([&]() {
+        uint64_t popped = 0;
+        while (popped < TOTAL_BYTES) {
+            size_t n = ring->pop(dst.data(), POP_BYTES);
+            if (n == 0) std::this_thread::yield();
+            popped += n;
+
+            // Stand-in for the worker's and the SDK's own hot data
+            uint64_t sum = 0;
+            for (size_t i = 0; i < hotSet.size(); i += 64) sum += hotSet[i];
+            hotSum = hotSum + sum;
+        }
+    });
+    producer.join();
+
+    result.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.streamedPct = 100.0 * ring->streamedBytes() / std::max<uint64_t>(ring->writtenBytes(), 1);
+    return true;
+}
+
+void printMeasure(double cpuMs, int64_t counter) {
+    std::cout << std::setw(12) << std::fixed << std::setprecision(1) << cpuMs;
+    if (counter >= 0) {
+        std::cout << std::setw(14) << counter;
+    } else {
+        std::cout << std::setw(14) << "n/a";
+    }
+}
+
+//=============================================================================
+// ring: huge pages vs 4K pages
+//=============================================================================
+
+int benchRing() {
+    using namespace RingBench;
+
+    std::cout << "Benchmark: ring — " << RING_BYTES / (1024 * 1024) << " MB ring, "
+              << TOTAL_BYTES / (1024 * 1024) << " MB through, push " << PUSH_BYTES
+              << " / pop " << POP_BYTES << " bytes, huge page " << AudioArena::hugePageSize() / 1024
+              << " KB" << std::endl;
+    std::cout << "  backing      wall ms   producer: cpu ms   dTLB miss   consumer: cpu ms   dTLB miss"
+              << std::endl;
+
+    bool perfMissing = false;
+    for (bool huge : {false, true}) {
+        RingBenchParams params;
+        params.hugePages = huge;
+        RingBenchResult r;
+        if (!runRingOnce(params, r)) {
+            std::cout << "  " << (huge ? "huge" : "4k") << ": mapping failed" << std::endl;
+            continue;
+        }
+        std::cout << "  " << std::left << std::setw(8) << r.backing << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(1) << r.wallMs << "      ";
+        printMeasure(r.producer.cpuMs, r.producer.dtlbMisses);
+        std::cout << "       ";
+        printMeasure(r.consumer.cpuMs, r.consumer.dtlbMisses);
+        std::cout << std::endl;
+        perfMissing |= r.producer.dtlbMisses < 0;
+    }
+
+    if (perfMissing) {
+        std::cout << "  (dTLB counters unavailable: no PMU access — check perf_event_paranoid)" << std::endl;
+    }
+    std::cout << "  Huge pages: run with --hugepages (reserve a pool with vm.nr_hugepages for hugetlbfs,"
+              << " otherwise THP in madvise mode is used)" << std::endl;
+    return 0;
+}
+
+//=============================================================================
+// ntstore: cached vs streaming ring writes
+//=============================================================================
+
+int benchNtStore() {
+    using namespace RingBench;
+    constexpr size_t HOT_SET_BYTES = 512 * 1024;
+
+    const CpuCaches& caches = cpuCaches();
+    std::cout << "Benchmark: ntstore — " << RING_BYTES / (1024 * 1024) << " MB ring kept full, "
+              << TOTAL_BYTES / (1024 * 1024) << " MB through, consumer hot set "
+              << HOT_SET_BYTES / 1024 << " KB, LLC " << caches.llc / 1024 << " KB (L"
+              << caches.llcLevel << ")" << std::endl;
+    if (caches.llc >= RING_BYTES) {
+        std::cout << "  (LLC larger than the ring: --nt-stores auto would keep cached stores here)" << std::endl;
+    }
+    std::cout << "  stores       wall ms   streamed   producer: cpu ms    LLC miss   consumer: cpu ms    LLC miss"
+              << std::endl;
+
+    bool perfMissing = false;
+    for (bool stream : {false, true}) {
+        RingBenchParams params;
+        params.streamThreshold = stream ? 0 : SIZE_MAX;
+        params.hotSetBytes = HOT_SET_BYTES;
+        RingBenchResult r;
+        if (!runRingOnce(params, r)) {
+            std::cout << "  mapping failed" << std::endl;
+            return 1;
+        }
+        std::cout << "  " << std::left << std::setw(8) << (stream ? "stream" : "cached") << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(1) << r.wallMs
+                  << std::setw(10) << r.streamedPct << "%  ";
+        printMeasure(r.producer.cpuMs, r.producer.llcMisses);
+        std::cout << "       ";
+        printMeasure(r.consumer.cpuMs, r.consumer.llcMisses);
+        std::cout << std::endl;
+        perfMissing |= r.consumer.llcMisses < 0;
+    }
+
+    if (perfMissing) {
+        std::cout << "  (LLC counters unavailable: no PMU access — check perf_event_paranoid)" << std::endl;
+    }
+    return 0;
+}
+
+//=============================================================================
+// pop: exact-size consumer copy vs generic pop()
+//=============================================================================
+
+// TSC ticks on x86, nanoseconds elsewhere (the ARM generic timer is too coarse)
+#if defined(__x86_64__) || defined(__i386__)
+inline uint64_t readTimer() { return __rdtsc(); }
+constexpr const char* TIMER_UNIT = "TSC cycles";
+#else
+inline uint64_t readTimer() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+constexpr const char* TIMER_UNIT = "ns";
+#endif
+
+struct PopFormat {
+    const char* name;
+    size_t bytes;            // bytesPerBuffer
+    size_t alternateBytes;   // One frame more (44.1k family), 0 if none
+    uint32_t remainder;      // Frames remainder per 1000 cycles (see configureRingPCM)
+};
+
+struct PopDistribution {
+    double mean = 0;
+    uint64_t p50 = 0, p99 = 0, p999 = 0, max = 0;
+};
+
+PopDistribution distribution(std::vector<uint64_t>& samples) {
+    std::sort(samples.begin(), samples.end());
+    PopDistribution d;
+    double sum = 0;
+    for (uint64_t v : samples) sum += static_cast<double>(v);
+    d.mean = sum / samples.size();
+    d.p50 = samples[samples.size() / 2];
+    d.p99 = samples[samples.size() * 99 / 100];
+    d.p999 = samples[samples.size() * 999 / 1000];
+    d.max = samples.back();
+    return d;
+}
+
+int benchPop() {
+    constexpr size_t RING_BYTES = 1024 * 1024;
+    constexpr size_t REFILL_BYTES = 65536;
+    constexpr int POPS = 200000;
+    constexpr int BLOCK = 1000;    // Alternate the two paths every BLOCK pops
+
+    const PopFormat formats[] = {
+        {"44.1k/16", 176, 180, 100},
+        {"44.1k/32", 352, 360, 100},
+        {"192k/32", 1536, 0, 0},
+        {"705.6k/32", 5640, 5648, 600},
+        {"DSD512", 5648, 0, 0},
+        {"768k/32", 6144, 0, 0},
+        {"DSD1024", 11288, 0, 0},
+    };
+
+    std::cout << "Benchmark: pop — " << POPS << " pops per path, " << TIMER_UNIT << " per pop()" << std::endl;
+    std::cout << "  format       bytes  path         mean     p50     p99   p99.9     max" << std::endl;
+
+    auto ring = std::make_unique<DirettaRingBuffer>();
+    ring->resize(RING_BYTES, 0x00);
+    std::vector<uint8_t> refill(REFILL_BYTES, 0x33);
+    std::vector<uint8_t> dest(16384);
+
+    for (const PopFormat& format : formats) {
+        std::vector<uint64_t> samples[2];
+        samples[0].reserve(POPS);
+        samples[1].reserve(POPS);
+        uint32_t acc = 0;
+
+        for (int done = 0; done < 2 * POPS; done += BLOCK) {
+            int path = (done / BLOCK) % 2;    // 0 = generic, 1 = exact
+            if (path == 1) {
+                ring->setConsumerBufferSize(format.bytes, format.alternateBytes);
+            } else {
+                ring->setConsumerBufferSize(0);
+            }
+
+            for (int i = 0; i < BLOCK; i++) {
+                size_t len = format.bytes;
+                acc += format.remainder;
+                if (acc >= 1000) {
+                    acc -= 1000;
+                    len = format.alternateBytes;
+                }
+                if (ring->getAvailable() < len) ring->push(refill.data(), REFILL_BYTES);
+
+                uint64_t t0 = readTimer();
+                ring->pop(dest.data(), len);
+                uint64_t t1 = readTimer();
+                samples[path].push_back(t1 - t0);
+            }
+        }
+
+        for (int path = 0; path < 2; path++) {
+            PopDistribution d = distribution(samples[path]);
+            std::cout << "  " << std::left << std::setw(12) << format.name << std::right
+                      << std::setw(6) << format.bytes << "  " << std::left
+                      << std::setw(8) << (path == 0 ? "generic" : "exact") << std::right
+                      << std::setw(9) << std::fixed << std::setprecision(1) << d.mean
+                      << std::setw(8) << d.p50 << std::setw(8) << d.p99
+                      << std::setw(8) << d.p999 << std::setw(8) << d.max << std::endl;
+        }
+    }
+    std::cout << "  generic: memcpy_audio(); exact: copy compiled for the buffer size,"
+              << " as selected in configureRing*()" << std::endl;
+    return 0;
+}
+
+//=============================================================================
+// memcpy: strategy calibration
+//=============================================================================
+
+int benchMemcpy(const BenchOptions& options) {
+    std::cout << "Benchmark: memcpy — memcpy_audio() strategies on " << cpuModelName() << std::endl;
+    std::vector<MemcpyCandidate> results = calibrateMemcpy();
+
+    std::cout << "  strategy       score";
+    for (const MemcpyTiming& t : results.front().timings) {
+        std::cout << std::setw(16) << (std::to_string(t.bytes) + " B");
+    }
+    std::cout << std::endl;
+
+    for (const MemcpyCandidate& candidate : results) {
+        std::cout << "  " << std::left << std::setw(12) << memcpyStrategyName(candidate.strategy) << std::right
+                  << std::setw(8) << std::fixed << std::setprecision(3) << candidate.score;
+        for (const MemcpyTiming& t : candidate.timings) {
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(0) << t.meanNs << "/" << t.p99Ns << "/" << t.stddevNs;
+            std::cout << std::setw(16) << cell.str();
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "  cells: mean/p99/stddev ns per copy; score: mean + p99 + stddev relative to the best at each size,"
+              << " averaged (1.000 = best everywhere)" << std::endl;
+
+    std::string error;
+    if (saveMemcpyCalibration(options.stateDir, results, error)) {
+        std::cout << "  Pinned " << memcpyStrategyName(results.front().strategy) << ", saved to "
+                  << options.stateDir << " (used from the next start)" << std::endl;
+    } else {
+        std::cout << "  Best: " << memcpyStrategyName(results.front().strategy) << " — not saved: "
+                  << error << std::endl;
+    }
+    return 0;
+}
+
+//=============================================================================
+// convert: producer conversion split over 1-4 threads (--convert-threads)
+//=============================================================================
+
+struct ConvertCase {
+    const char* name;
+    bool dsd;
+    DirettaRingBuffer::DSDConversionMode mode;
+    double inputBytesPerSec;    // Real-time rate of the ring input
+};
+
+// Input MB/s through the ring's conversion, the ring drained between chunks
+double convertThroughput(DirettaRingBuffer& ring, const ConvertCase& c, const std::vector<uint8_t>& chunk) {
+    constexpr size_t TOTAL_BYTES = 256 * 1024 * 1024;
+    size_t chunks = TOTAL_BYTES / chunk.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < chunks; i++) {
+        if (ring.getFreeSpace() < chunk.size()) ring.clear();
+        if (c.dsd) {
+            ring.pushDSDPlanarOptimized(chunk.data(), chunk.size(), 2, c.mode);
+        } else {
+            ring.push24BitPacked(chunk.data(), chunk.size());
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(chunks * chunk.size()) / seconds / 1e6;
+}
+
+int benchConvert() {
+    using Mode = DirettaRingBuffer::DSDConversionMode;
+    constexpr size_t RING_BYTES = 1024 * 1024;
+    constexpr size_t CHUNK_BYTES = 65536;    // Largest ingest chunk (DSD512/DSD1024)
+    constexpr int MAX_CONVERTERS = 4;
+
+    const ConvertCase cases[] = {
+        {"DSD1024 rev+swap", true, Mode::BitReverseAndSwap, 45158400.0 * 2 / 8},
+        {"DSD1024 interleave", true, Mode::Passthrough, 45158400.0 * 2 / 8},
+        {"768k/24 pack", false, Mode::Passthrough, 768000.0 * 2 * 4},
+    };
+
+    unsigned int cpus = std::max(1u, std::thread::hardware_concurrency());
+    int converters = std::min<int>(MAX_CONVERTERS, std::max<int>(3, static_cast<int>(cpus)));
+    std::cout << "Benchmark: convert — " << CHUNK_BYTES / 1024 << " KB chunks into the ring, 1-"
+              << converters << " converting threads (ingest + --convert-threads), " << cpus
+              << " CPUs" << std::endl;
+    std::cout << "  format               threads    MB/s in   speedup   x real time" << std::endl;
+
+    auto ring = std::make_unique<DirettaRingBuffer>();
+    ring->resize(RING_BYTES, 0x00);
+    std::vector<uint8_t> chunk(CHUNK_BYTES);
+    for (size_t i = 0; i < chunk.size(); i++) chunk[i] = static_cast<uint8_t>(i * 7 + 1);
+
+    for (const ConvertCase& c : cases) {
+        double single = 0;
+        for (int threads = 1; threads <= converters; threads++) {
+            ConvertPool pool;
+            if (threads > 1) pool.start(threads - 1, ThreadPolicy());
+            ring->setConvertPool(threads > 1 ? &pool : nullptr);
+
+            double mbps = convertThroughput(*ring, c, chunk);
+            if (threads == 1) single = mbps;
+            std::cout << "  " << std::left << std::setw(20) << c.name << std::right
+                      << std::setw(8) << threads << std::setw(11) << std::fixed << std::setprecision(0) << mbps
+                      << std::setw(9) << std::setprecision(2) << mbps / single << "x"
+                      << std::setw(13) << std::setprecision(0) << mbps * 1e6 / c.inputBytesPerSec << std::endl;
+            ring->setConvertPool(nullptr);
+        }
+    }
+    if (static_cast<int>(cpus) < converters) {
+        std::cout << "  (fewer CPUs than threads: the extra threads only time-share)" << std::endl;
+    }
+    std::cout << "  Ring stage only (planar DSD / S32 in); the wrapper's de-interleave is split the same way."
+              << " Pin with --thread convert=@<cpus>" << std::endl;
+    return 0;
+}
+
+struct BenchEntry {
+    const char* name;
+    int (*run)(const BenchOptions& options);
+};
+
+const BenchEntry BENCHMARKS[] = {
+    {"ring", [](const BenchOptions&) { return benchRing(); }},
+    {"ntstore", [](const BenchOptions&) { return benchNtStore(); }},
+    {"memcpy", benchMemcpy},
+    {"pop", [](const BenchOptions&) { return benchPop(); }},
+    {"convert", [](const BenchOptions&) { return benchConvert(); }},
+};
+
+} // namespace
+
+int runBenchmark(const std::string& name, const BenchOptions& options) {
+    int status = 0;
+    bool found = false;
+    for (const BenchEntry& bench : BENCHMARKS) {
+        if (name == "all" || name == bench.name) {
+            found = true;
+            status |= bench.run(options);
+            std::cout << std::endl;
+        }
+    }
+
+    if (!found) {
+        std::cerr << "Unknown benchmark: " << name << " (available:";
+        for (const BenchEntry& bench : BENCHMARKS) std::cerr << " " << bench.name;
+        std::cerr << ", all)" << std::endl;
+        return 1;
+    }
+    return status;
+}
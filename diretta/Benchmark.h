@@ -0,0 +1,35 @@
+/**
+ * @file Benchmark.h
+ * @brief Built-in micro-benchmarks (--bench <name>)
+ *
+ * Run standalone, without squeezelite or a Diretta target, on the machine
+ * that will do the playback:
+ *
+ *   ring      Producer/consumer through the ring: 4K pages vs huge pages
+ *             (wall time, CPU time and dTLB misses per thread)
+ *   ntstore   Same, cached vs streaming ring writes, with the consumer
+ *             walking a hot working set (LLC misses per thread)
+ *   memcpy    Time every memcpy_audio() strategy at ring copy sizes, pin
+ *             and store the best (see MemcpyCalibration.h)
+ *   pop       Per-pop timing distribution (p50/p99/p99.9) of the exact-size
+ *             consumer copy against the generic pop()
+ *   convert   Producer conversion throughput with 1, 2, 3 (and 4) converting
+ *             threads, i.e. the scaling of --convert-threads
+ */
+
+#ifndef SQUEEZE2DIRETTA_BENCHMARK_H
+#define SQUEEZE2DIRETTA_BENCHMARK_H
+
+#include <string>
+
+struct BenchOptions {
+    std::string stateDir;       // Where calibrating benchmarks store results
+};
+
+/**
+ * @brief Run one benchmark (or "all")
+ * @return Process exit code
+ */
+int runBenchmark(const std::string& name, const BenchOptions& options);
+
+#endif // SQUEEZE2DIRETTA_BENCHMARK_H
@@ -0,0 +1,101 @@
+/**
+ * @file BufferLearning.cpp
+ * @brief Ring latency targets learned per Diretta target and rate family
+ */
+
+#include "BufferLearning.h"
+#include "StateFile.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+constexpr const char* STATE_FILE = "buffer.state";
+
+const char* const FAMILIES[] = {
+    "pcm48k", "pcm96k", "pcm192k", "pcm384k", "pcm768k", "pcm1536k",
+    "dsd64", "dsd128", "dsd256", "dsd512", "dsd1024"
+};
+
+// Zones share one file: read-merge-write one at a time
+std::mutex g_saveMutex;
+
+std::string formatMs(double ms) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << ms;
+    return out.str();
+}
+
+} // namespace
+
+void BufferLearning::open(const std::string& stateDir, const std::string& targetName) {
+    m_stateDir = stateDir;
+    m_prefix.clear();
+    for (char c : targetName) {
+        m_prefix += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    if (m_prefix.empty()) m_prefix = "target";
+    m_entries.clear();
+    m_dirty = false;
+
+    if (m_stateDir.empty()) return;
+    StateFile state(m_stateDir, STATE_FILE);
+    if (!state.load()) return;
+    for (const char* family : FAMILIES) {
+        unsigned int ms = static_cast<unsigned int>(std::atoi(state.get(key(family, "ms"), "0").c_str()));
+        if (ms == 0) continue;
+        Entry& entry = m_entries[family];
+        entry.ms = ms;
+        entry.stallMs = std::atof(state.get(key(family, "stall_ms"), "0").c_str());
+        entry.jitterMs = std::atof(state.get(key(family, "jitter_ms"), "0").c_str());
+    }
+}
+
+std::string BufferLearning::rateFamily(bool dsd, uint32_t sampleRate) {
+    // Nearest power-of-two multiple of the base rate (44.1k and 48k alike)
+    double base = dsd ? 2822400.0 : 48000.0;
+    int multiple = 1;
+    while (multiple < 32 && sampleRate > base * multiple * 1.5) multiple *= 2;
+    return dsd ? "dsd" + std::to_string(64 * multiple) : "pcm" + std::to_string(48 * multiple) + "k";
+}
+
+unsigned int BufferLearning::learnedMs(const std::string& family) const {
+    auto it = m_entries.find(family);
+    return it != m_entries.end() ? it->second.ms : 0;
+}
+
+void BufferLearning::remember(const std::string& family, unsigned int ms, double stallMs, double jitterMs) {
+    Entry& entry = m_entries[family];
+    if (entry.ms == ms && std::fabs(entry.stallMs - stallMs) < 0.05 && std::fabs(entry.jitterMs - jitterMs) < 0.05) {
+        return;
+    }
+    entry.ms = ms;
+    entry.stallMs = stallMs;
+    entry.jitterMs = jitterMs;
+    m_dirty = true;
+}
+
+bool BufferLearning::save(std::string& error) {
+    if (!m_dirty || m_stateDir.empty()) return true;
+
+    std::lock_guard<std::mutex> lock(g_saveMutex);
+    StateFile state(m_stateDir, STATE_FILE);
+    state.load();
+    for (const auto& it : m_entries) {
+        state.set(key(it.first, "ms"), std::to_string(it.second.ms));
+        state.set(key(it.first, "stall_ms"), formatMs(it.second.stallMs));
+        state.set(key(it.first, "jitter_ms"), formatMs(it.second.jitterMs));
+    }
+    if (!state.save(error)) return false;
+    m_dirty = false;
+    return true;
+}
+
+std::string BufferLearning::key(const std::string& family, const char* field) const {
+    return m_prefix + "." + family + "." + field;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file BufferLearning.h
+ * @brief Ring latency targets learned per Diretta target and rate family
+ *
+ * In adaptive mode (DirettaConfig::adaptiveBuffer) DirettaSync starts each
+ * format at the target learned for its rate family, or at the upper bound
+ * when nothing is known yet, shrinks it while playback stays clean and grows
+ * it after an underrun. What it settles on is kept in buffer.state under the
+ * state directory, one entry per target and family, so the next start (and
+ * the next track of that family) begins there instead of starting over.
+ */
+
+#ifndef SQUEEZE2DIRETTA_BUFFERLEARNING_H
+#define SQUEEZE2DIRETTA_BUFFERLEARNING_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+class BufferLearning {
+public:
+    /**
+     * @brief Load what was learned for this target (by name)
+     * @param stateDir State directory; empty = learn for this run only
+     */
+    void open(const std::string& stateDir, const std::string& targetName);
+
+    /**
+     * @brief Family of formats that share a target: PCM by 48 kHz multiple
+     *        (pcm48k ... pcm1536k, 44.1k rates with their 48k neighbour),
+     *        DSD by 64fs multiple (dsd64 ... dsd1024)
+     * @param sampleRate PCM sample rate or DSD bit rate
+     */
+    static std::string rateFamily(bool dsd, uint32_t sampleRate);
+
+    /**
+     * @brief Learned latency target in ms, 0 if there is none
+     */
+    unsigned int learnedMs(const std::string& family) const;
+
+    /**
+     * @brief Record where a family settled and the worst producer stall and
+     *        consumer interval jitter seen; written by save()
+     */
+    void remember(const std::string& family, unsigned int ms, double stallMs, double jitterMs);
+
+    /**
+     * @brief Merge this target's entries into the state file (entries of
+     *        other targets, e.g. other zones, are kept). No-op if unchanged.
+     * @param error Set to the reason on failure
+     */
+    bool save(std::string& error);
+
+private:
+    struct Entry {
+        unsigned int ms = 0;
+        double stallMs = 0.0;
+        double jitterMs = 0.0;
+    };
+
+    std::string key(const std::string& family, const char* field) const;
+
+    std::string m_stateDir;
+    std::string m_prefix;                  // Sanitized target name
+    std::map<std::string, Entry> m_entries;
+    bool m_dirty = false;
+};
+
+#endif // SQUEEZE2DIRETTA_BUFFERLEARNING_H
@@ -0,0 +1,577 @@
+/**
+ * @file Calibration.cpp
+ * @brief Calibration mode (--calibrate): lowest stable settings per rate family
+ */
+
+#include "Calibration.h"
+#include "BufferLearning.h"
+#include "DirettaSync.h"
+#include "SqStream.h"
+#include "StateFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+//=============================================================================
+// Test signal (the squeezelite stand-in of a run)
+//=============================================================================
+
+struct Segment {
+    bool dsd = false;
+    uint32_t rate = 0;                 // PCM sample rate or DSD bit rate
+    double seconds = 0.0;
+};
+
+SqStream::DsdContainer containerFor(const std::string& dsdFormat) {
+    if (dsdFormat == "dop") return SqStream::DOP;
+    return dsdFormat == ":u32le" ? SqStream::U32_LE : SqStream::U32_BE;
+}
+
+//=============================================================================
+// Calibration runs
+//=============================================================================
+
+// Longest a run may take beyond the audio it plays (enable(), target
+// discovery, format changes), before it is stopped
+constexpr int RUN_OVERHEAD_S = 60;
+
+// --target-latency steps, tried from the top until a run underruns
+const unsigned int LATENCY_STEPS_MS[] = {150, 100, 70, 50, 35, 25, DirettaBuffer::ADAPTIVE_MIN_MS};
+
+// Cycle time factors tried against the calculated cycle time
+const double CYCLE_FACTORS[] = {0.8, 1.25};
+
+const char* const FAMILIES[] = {
+    "pcm48k", "pcm96k", "pcm192k", "pcm384k", "pcm768k", "pcm1536k",
+    "dsd64", "dsd128", "dsd256", "dsd512", "dsd1024"
+};
+
+struct Family {
+    std::string name;
+    bool dsd = false;
+    uint32_t rates[2] = {0, 0};        // 44.1k-based, 48k-based
+};
+
+// pcm<N>k: N/48 times 44.1k and 48k; dsd<N>: N/64 times DSD64 (both bases)
+bool familyFromName(const std::string& name, Family& family) {
+    bool dsd = name.compare(0, 3, "dsd") == 0;
+    if (!dsd && (name.compare(0, 3, "pcm") != 0 || name.back() != 'k')) return false;
+    int n = std::atoi(name.c_str() + 3);
+    int unit = dsd ? 64 : 48;
+    if (n < unit || n % unit != 0) return false;
+    uint32_t multiple = static_cast<uint32_t>(n / unit);
+    family.name = name;
+    family.dsd = dsd;
+    family.rates[0] = multiple * (dsd ? 2822400 : 44100);
+    family.rates[1] = multiple * (dsd ? 3072000 : 48000);
+    return BufferLearning::rateFamily(dsd, family.rates[1]) == name;
+}
+
+struct Candidate {
+    unsigned int latencyMs = 0;        // --target-latency, 0 = default fill
+    unsigned int cycleUs = 0;          // --cycle-time, 0 = calculated
+    int mode = -1;                     // --transfer-mode, -1 = auto
+    int threadMode = 1;
+};
+
+struct Run {
+    bool ok = false;
+    CalibrationReport report;
+    double score = std::numeric_limits<double>::infinity();
+};
+
+struct FamilyResult {
+    Family family;
+    bool ok = false;
+    Candidate best;                    // Latency not included
+    Run baseRun;                       // Calculated cycle time, resolved mode
+    Run bestRun;
+    unsigned int latencyMs = 0;        // Recommended, 0 = none was clean
+    Run latencyRun;
+};
+
+std::string describe(const Candidate& c) {
+    std::ostringstream out;
+    out << "latency " << (c.latencyMs ? std::to_string(c.latencyMs) + "ms" : std::string("default"))
+        << ", cycle " << (c.cycleUs ? std::to_string(c.cycleUs) + "us" : std::string("calculated"))
+        << ", " << (c.mode >= 0 ? CycleTuning::modeName(c.mode) : "auto mode")
+        << ", thread mode " << c.threadMode;
+    return out.str();
+}
+
+class Calibrator {
+public:
+    Calibrator(const CalibrateOptions& options, const std::string& workDir)
+        : m_options(options), m_workDir(workDir), m_container(containerFor(options.dsdFormat)) {}
+
+    FamilyResult calibrate(const Family& family);
+
+private:
+    Run run(const Family& family, const Candidate& candidate);
+    bool tryCandidate(const Family& family, const Candidate& candidate, FamilyResult& result);
+
+    const CalibrateOptions& m_options;
+    std::string m_workDir;
+    SqStream::DsdContainer m_container;
+    int m_runs = 0;
+};
+
+// One setting at a time, the rest at the best found so far
+FamilyResult Calibrator::calibrate(const Family& family) {
+    FamilyResult result;
+    result.family = family;
+
+    Candidate base;
+    base.threadMode = m_options.threadModes.front();
+    result.baseRun = run(family, base);
+    if (!result.baseRun.ok) return result;
+    result.ok = true;
+
+    // Auto mode resolves per format; from here on it is explicit
+    const std::string key = CycleTuning::rateKey(family.dsd, family.rates[0]);
+    const CycleTuning::Settings calculated = result.baseRun.report.cycles[key];
+    result.best = base;
+    result.best.mode = calculated.mode;
+    result.bestRun = result.baseRun;
+
+    for (int mode : {static_cast<int>(DirettaTransferMode::VAR_MAX), static_cast<int>(DirettaTransferMode::VAR_AUTO),
+                     static_cast<int>(DirettaTransferMode::FIX_AUTO)}) {
+        if (mode == result.best.mode) continue;
+        Candidate c = result.best;
+        c.mode = mode;
+        tryCandidate(family, c, result);
+    }
+    for (double factor : CYCLE_FACTORS) {
+        Candidate c = result.best;
+        c.cycleUs = static_cast<unsigned int>(std::lround(calculated.cycleUs * factor));
+        tryCandidate(family, c, result);
+    }
+    for (size_t i = 1; i < m_options.threadModes.size(); i++) {
+        Candidate c = result.best;
+        c.threadMode = m_options.threadModes[i];
+        tryCandidate(family, c, result);
+    }
+
+    // Lowest latency without underruns, then one step back as margin
+    std::vector<Run> clean;
+    for (unsigned int ms : LATENCY_STEPS_MS) {
+        Candidate c = result.best;
+        c.latencyMs = ms;
+        Run r = run(family, c);
+        if (!r.ok || r.report.callbacks.underruns > 0) break;
+        clean.push_back(r);
+    }
+    if (!clean.empty()) {
+        size_t pick = clean.size() >= 2 ? clean.size() - 2 : 0;
+        result.latencyMs = LATENCY_STEPS_MS[pick];
+        result.latencyRun = clean[pick];
+    }
+    return result;
+}
+
+bool Calibrator::tryCandidate(const Family& family, const Candidate& candidate, FamilyResult& result) {
+    Run r = run(family, candidate);
+    if (r.score >= result.bestRun.score) return false;
+    result.best = candidate;
+    result.bestRun = r;
+    return true;
+}
+
+Run Calibrator::run(const Family& family, const Candidate& candidate) {
+    std::ostringstream spec;
+    for (int i = 0; i < 2; i++) {
+        if (i > 0) spec << ",";
+        spec << (family.dsd ? "dsd:" : "pcm:") << family.rates[i] << ":" << m_options.seconds;
+    }
+
+    std::vector<std::string> args = m_options.baseArgs;
+    args.push_back("--calibrate-signal");
+    args.push_back(spec.str());
+    args.push_back("--calibrate-report");
+    args.push_back(m_workDir);
+    args.push_back("--thread-mode");
+    args.push_back(std::to_string(candidate.threadMode));
+    if (candidate.latencyMs > 0) {
+        args.push_back("--target-latency");
+        args.push_back(std::to_string(candidate.latencyMs));
+    }
+    if (candidate.cycleUs > 0) {
+        args.push_back("--cycle-time");
+        args.push_back(std::to_string(candidate.cycleUs));
+    }
+    if (candidate.mode >= 0) {
+        args.push_back("--transfer-mode");
+        args.push_back(CycleTuning::modeName(candidate.mode));
+    }
+
+    int number = ++m_runs;
+    std::string logPath = m_workDir + "/run-" + std::to_string(number) + ".log";
+    std::string reportPath = m_workDir + "/" + CalibrationReport::FILE_NAME;
+    unlink(reportPath.c_str());
+
+    std::cout << "[Calibrate] " << family.name << " run " << number << ": " << describe(candidate) << std::flush;
+
+    // argv built before fork()
+    std::vector<char*> argv;
+    for (auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    Run result;
+    pid_t pid = fork();
+    if (pid == -1) {
+        std::cout << " - fork failed: " << std::strerror(errno) << std::endl;
+        return result;
+    }
+    if (pid == 0) {
+        int fd = open(logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0) {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        execv("/proc/self/exe", argv.data());
+        _exit(127);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::seconds(2 * m_options.seconds + RUN_OVERHEAD_S);
+    int status = 0;
+    bool timedOut = false;
+    while (waitpid(pid, &status, WNOHANG) == 0) {
+        if (!timedOut && std::chrono::steady_clock::now() > deadline) {
+            timedOut = true;
+            kill(pid, SIGTERM);
+            deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        } else if (timedOut && std::chrono::steady_clock::now() > deadline) {
+            kill(pid, SIGKILL);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    bool exitedOk = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if (timedOut || !exitedOk || !result.report.load(m_workDir) ||
+        result.report.transitions < 2 || result.report.callbacks.seconds <= 0.0) {
+        std::cout << " - failed" << (timedOut ? " (timed out)" : "") << ", see " << logPath << std::endl;
+        return result;
+    }
+
+    result.ok = true;
+    result.score = CycleTuning::score(result.report.callbacks);
+    const CycleTuning::Result& cb = result.report.callbacks;
+    std::cout << std::fixed << std::setprecision(1)
+              << " - jitter " << cb.jitterUs << "us, " << cb.lateCallbacks << " late, "
+              << cb.underruns << " underruns, transition " << result.report.transitionMs
+              << "ms (score " << result.score << ")" << std::endl;
+    return result;
+}
+
+// Seed the per-target results --adaptive-buffer and --adaptive-cycle start from
+void storeResults(const std::string& stateDir, const std::string& target, const std::vector<FamilyResult>& results) {
+    BufferLearning buffers;
+    CycleTuning cycles;
+    buffers.open(stateDir, target);
+    cycles.open(stateDir, target, 0, 0, {});
+    for (const FamilyResult& r : results) {
+        if (!r.ok) continue;
+        if (r.latencyMs > 0) buffers.remember(r.family.name, r.latencyMs, 0.0, 0.0);
+        for (uint32_t rate : r.family.rates) {
+            std::string key = CycleTuning::rateKey(r.family.dsd, rate);
+            auto used = r.bestRun.report.cycles.find(key);
+            auto base = r.baseRun.report.cycles.find(key);
+            if (used == r.bestRun.report.cycles.end() || base == r.baseRun.report.cycles.end()) continue;
+            cycles.settle(key, used->second, base->second.cycleUs, r.bestRun.score);
+        }
+    }
+    std::string error;
+    if (!buffers.save(error) || !cycles.save(error)) {
+        std::cerr << "[Calibrate] Could not store results: " << error << std::endl;
+    }
+}
+
+bool writeRecommended(const CalibrateOptions& options, const std::string& workDir, const std::string& target,
+                      const std::vector<FamilyResult>& results, std::string& path) {
+    // Thread mode is per process: the one most families did best with
+    std::map<int, int> votes;
+    unsigned int minMs = 0, maxMs = 0;
+    for (const FamilyResult& r : results) {
+        if (!r.ok) continue;
+        votes[r.best.threadMode]++;
+        if (r.latencyMs == 0) continue;
+        minMs = minMs == 0 ? r.latencyMs : std::min(minMs, r.latencyMs);
+        maxMs = std::max(maxMs, r.latencyMs);
+    }
+    int threadMode = options.threadModes.front();
+    for (const auto& v : votes) {
+        if (v.second > votes[threadMode]) threadMode = v.first;
+    }
+
+    path = options.stateDir + "/recommended.conf";
+    if (mkdir(options.stateDir.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M", std::localtime(&now));
+    out << "# squeeze2diretta --calibrate for " << target << ", " << date << "\n"
+        << "# " << options.seconds << "s per rate, two rates per run; run logs in " << workDir << "\n"
+        << "#\n"
+        << "# family     latency  cycle (44.1k/48k)  mode     thread  jitter    late  underruns  transition\n";
+    for (const FamilyResult& r : results) {
+        out << "# " << std::left << std::setw(11) << r.family.name;
+        if (!r.ok) {
+            out << "failed, see the run logs\n";
+            continue;
+        }
+        const Run& shown = r.latencyMs > 0 ? r.latencyRun : r.bestRun;
+        std::string cycle;
+        for (uint32_t rate : r.family.rates) {
+            auto it = r.bestRun.report.cycles.find(CycleTuning::rateKey(r.family.dsd, rate));
+            if (!cycle.empty()) cycle += "/";
+            cycle += it != r.bestRun.report.cycles.end() ? std::to_string(it->second.cycleUs) : std::string("?");
+        }
+        std::ostringstream jitter;
+        jitter << std::fixed << std::setprecision(1) << r.bestRun.report.callbacks.jitterUs << "us";
+        std::ostringstream transition;
+        transition << std::fixed << std::setprecision(0) << shown.report.transitionMs << "ms";
+        out << std::setw(9) << (r.latencyMs ? std::to_string(r.latencyMs) + "ms" : std::string("default"))
+            << std::setw(19) << (cycle + "us")
+            << std::setw(9) << CycleTuning::modeName(r.best.mode)
+            << std::setw(8) << r.best.threadMode
+            << std::setw(10) << jitter.str()
+            << std::setw(6) << r.bestRun.report.callbacks.lateCallbacks
+            << std::setw(11) << shown.report.callbacks.underruns
+            << transition.str() << std::right << "\n";
+    }
+    out << "#\n"
+        << "# Latency is the ring fill held during playback and the prefill; one step\n"
+        << "# above the lowest that played clean. It and the cycle time and transfer\n"
+        << "# mode per rate are stored in buffer.state and cycle.state, where\n"
+        << "# --adaptive-buffer and --adaptive-cycle start from.\n";
+    if (maxMs > 0) {
+        out << "#\n"
+            << "# Fixed settings instead (the highest latency of all families):\n"
+            << "#   EXTRA_OPTS=\"--target-latency " << maxMs << " --thread-mode " << threadMode << "\"\n"
+            << "EXTRA_OPTS=\"--adaptive-buffer " << minMs << "-" << std::max(maxMs, DirettaBuffer::ADAPTIVE_MAX_MS)
+            << " --adaptive-cycle --thread-mode " << threadMode << "\"\n";
+    } else {
+        out << "EXTRA_OPTS=\"--adaptive-cycle --thread-mode " << threadMode << "\"\n";
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+//=============================================================================
+// Run report
+//=============================================================================
+
+bool CalibrationReport::save(const std::string& dir, std::string& error) const {
+    StateFile state(dir, FILE_NAME);
+    std::ostringstream value;
+    value << std::fixed << std::setprecision(3);
+    auto number = [&value](double v) {
+        value.str("");
+        value << v;
+        return value.str();
+    };
+    state.set("target", target);
+    state.set("seconds", number(callbacks.seconds));
+    state.set("jitter_us", number(callbacks.jitterUs));
+    state.set("late", std::to_string(callbacks.lateCallbacks));
+    state.set("underruns", std::to_string(callbacks.underruns));
+    state.set("transition_ms", number(transitionMs));
+    state.set("transitions", std::to_string(transitions));
+    // cycle.<rate key>=<us>:<DirettaTransferMode>
+    for (const auto& it : cycles) {
+        state.set("cycle." + it.first, std::to_string(it.second.cycleUs) + ":" + std::to_string(it.second.mode));
+    }
+    return state.save(error);
+}
+
+bool CalibrationReport::load(const std::string& dir) {
+    StateFile state(dir, FILE_NAME);
+    if (!state.load()) return false;
+    target = state.get("target");
+    callbacks.seconds = std::atof(state.get("seconds", "0").c_str());
+    callbacks.jitterUs = std::atof(state.get("jitter_us", "0").c_str());
+    callbacks.lateCallbacks = std::strtoull(state.get("late", "0").c_str(), nullptr, 10);
+    callbacks.underruns = static_cast<uint32_t>(std::strtoul(state.get("underruns", "0").c_str(), nullptr, 10));
+    transitionMs = std::atof(state.get("transition_ms", "0").c_str());
+    transitions = std::atoi(state.get("transitions", "0").c_str());
+    cycles.clear();
+    for (const auto& it : state.values()) {
+        if (it.first.compare(0, 6, "cycle.") != 0) continue;
+        size_t colon = it.second.find(':');
+        if (colon == std::string::npos) continue;
+        CycleTuning::Settings s;
+        s.cycleUs = static_cast<unsigned int>(std::atoi(it.second.substr(0, colon).c_str()));
+        s.mode = std::atoi(it.second.substr(colon + 1).c_str());
+        cycles[it.first.substr(6)] = s;
+    }
+    return true;
+}
+
+//=============================================================================
+// Entry points
+//=============================================================================
+
+int runCalibration(const CalibrateOptions& options) {
+    const SqStream::DsdContainer container = containerFor(options.dsdFormat);
+
+    std::vector<Family> families;
+    if (options.families.empty()) {
+        for (const char* name : FAMILIES) {
+            Family family;
+            familyFromName(name, family);
+            if (SqStream::headerRate(family.dsd, family.rates[1], container) <= options.maxSampleRate) {
+                families.push_back(family);
+            }
+        }
+    } else {
+        for (const std::string& name : options.families) {
+            Family family;
+            if (!familyFromName(name, family)) {
+                std::cerr << "Unknown rate family: " << name << " (pcm48k ... pcm1536k, dsd64 ... dsd1024)" << std::endl;
+                return 1;
+            }
+            if (SqStream::headerRate(family.dsd, family.rates[1], container) > options.maxSampleRate) {
+                std::cerr << name << " is above the maximum sample rate (-r "
+                          << options.maxSampleRate << ")" << std::endl;
+                return 1;
+            }
+            families.push_back(family);
+        }
+    }
+    if (families.empty() || options.threadModes.empty()) {
+        std::cerr << "Nothing to calibrate" << std::endl;
+        return 1;
+    }
+
+    char workDir[] = "/tmp/squeeze2diretta-calibrate-XXXXXX";
+    if (!mkdtemp(workDir)) {
+        std::cerr << "Cannot create a work directory: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    size_t runsPerFamily = 1 + 2 + std::size(CYCLE_FACTORS) + (options.threadModes.size() - 1) +
+                           std::size(LATENCY_STEPS_MS);
+    double minutes = families.size() * runsPerFamily * (2.0 * options.seconds + 10.0) / 60.0;
+    std::cout << "[Calibrate] " << families.size() << " rate families, up to " << runsPerFamily
+              << " runs each (about " << static_cast<int>(std::ceil(minutes)) << " minutes)" << std::endl;
+    std::cout << "[Calibrate] Run logs in " << workDir << std::endl;
+
+    Calibrator calibrator(options, workDir);
+    std::vector<FamilyResult> results;
+    std::string target;
+    for (const Family& family : families) {
+        results.push_back(calibrator.calibrate(family));
+        const FamilyResult& r = results.back();
+        if (!r.ok) {
+            std::cout << "[Calibrate] " << family.name << ": no run completed" << std::endl;
+            continue;
+        }
+        if (target.empty()) target = r.baseRun.report.target;
+        Candidate kept = r.best;
+        kept.latencyMs = r.latencyMs;
+        std::cout << "[Calibrate] " << family.name << ": " << describe(kept)
+                  << (r.latencyMs ? "" : " (no latency step played clean)") << std::endl;
+    }
+    if (target.empty()) {
+        std::cerr << "[Calibrate] No run completed, see the logs in " << workDir << std::endl;
+        return 1;
+    }
+
+    storeResults(options.stateDir, target, results);
+    std::string path;
+    if (!writeRecommended(options, workDir, target, results, path)) {
+        std::cerr << "[Calibrate] Could not write " << path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "[Calibrate] Recommended settings written to " << path << std::endl;
+    return 0;
+}
+
+int runTestSignal(const std::string& spec, const std::string& dsdFormat) {
+    using namespace SqStream;
+    const DsdContainer container = containerFor(dsdFormat);
+
+    std::vector<Segment> segments;
+    std::istringstream list(spec);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        Segment s;
+        char kind[4] = {0};
+        unsigned long rate = 0;
+        if (std::sscanf(item.c_str(), "%3[a-z]:%lu:%lf", kind, &rate, &s.seconds) != 3 || rate == 0 ||
+            (std::strcmp(kind, "pcm") != 0 && std::strcmp(kind, "dsd") != 0)) {
+            std::cerr << "Invalid test signal: " << item << std::endl;
+            return 1;
+        }
+        s.dsd = std::strcmp(kind, "dsd") == 0;
+        s.rate = static_cast<uint32_t>(rate);
+        segments.push_back(s);
+    }
+
+    const size_t frameBytes = CHANNELS * 4;
+    const char* writeEnv = std::getenv("SQ_STDOUT_WRITE_BYTES");
+    const size_t configuredWrite = writeEnv ? std::strtoul(writeEnv, nullptr, 10) / frameBytes * frameBytes : 0;
+
+    // As fast as the pipe takes it, like squeezelite with a full buffer:
+    // the wrapper's ring paces the stream
+    std::vector<struct iovec> iov;
+    for (const Segment& segment : segments) {
+        SqFormatHeader hdr = testHeader(segment.dsd, segment.rate, container);
+        std::vector<uint8_t> loop = segment.dsd ? renderDsd(segment.rate, container) : renderPcm(segment.rate);
+
+        const double bytesPerSecond = double(hdr.sample_rate) * frameBytes;
+        size_t writeBytes = configuredWrite;
+        if (writeBytes == 0) {
+            writeBytes = static_cast<size_t>(bytesPerSecond * WRITE_MS / 1000.0) / frameBytes * frameBytes;
+        }
+        const uint64_t totalBytes = static_cast<uint64_t>(segment.seconds * bytesPerSecond) / frameBytes * frameBytes;
+
+        uint64_t written = 0;
+        size_t offset = 0;
+        bool headerPending = true;
+        while (written < totalBytes) {
+            size_t len = static_cast<size_t>(std::min<uint64_t>(writeBytes, totalBytes - written));
+            iov.clear();
+            if (headerPending) {
+                iov.push_back({&hdr, sizeof(hdr)});
+                headerPending = false;
+            }
+            while (len > 0) {
+                size_t part = std::min(len, loop.size() - offset);
+                iov.push_back({loop.data() + offset, part});
+                offset = (offset + part) % loop.size();
+                written += part;
+                len -= part;
+            }
+            if (!writeAll(STDOUT_FILENO, iov.data(), static_cast<int>(iov.size()))) return 0;
+        }
+    }
+    return 0;
+}
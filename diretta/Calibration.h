@@ -0,0 +1,79 @@
+/**
+ * @file Calibration.h
+ * @brief Calibration mode (--calibrate): lowest stable settings per rate family
+ *
+ * Plays generated test signals through the real Diretta target, without
+ * LMS or squeezelite: every run is this binary started again with the
+ * normal command line plus the settings under test, and a generator (this
+ * binary too, runTestSignal()) in squeezelite's place. Each run plays a
+ * family's 44.1k-based rate, then its 48k-based rate, so it covers a
+ * format change as well.
+ *
+ * Per rate family, one setting at a time, keeping the best so far (by
+ * CycleTuning::score()):
+ *
+ *   transfer mode   VarMax, VarAuto, FixAuto
+ *   cycle time      calculated, 20% shorter, 25% longer
+ *   thread mode     the configured one, or CalibrateOptions::threadModes
+ *   latency         --target-latency (ring fill and prefill) stepped down
+ *                   until a run underruns; one step above the lowest clean
+ *                   run is kept as margin
+ *
+ * Each run reports SDK callback jitter, late callbacks, underruns and the
+ * transition time (format header to prefill complete). The results seed
+ * buffer.state and cycle.state (so --adaptive-buffer and --adaptive-cycle
+ * start from them) and go into recommended.conf under the state directory.
+ */
+
+#ifndef SQUEEZE2DIRETTA_CALIBRATION_H
+#define SQUEEZE2DIRETTA_CALIBRATION_H
+
+#include "CycleTuning.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct CalibrateOptions {
+    std::vector<std::string> baseArgs;      // Command line for the runs (without what is swept)
+    std::string stateDir;                   // Results and recommended.conf
+    std::vector<std::string> families;      // Empty = every family up to maxSampleRate
+    std::vector<int> threadModes;           // THRED_MODE values to try
+    unsigned int seconds = 10;              // Per rate, two rates per run
+    uint32_t maxSampleRate = 768000;        // Squeezelite -r upper bound
+    std::string dsdFormat;                  // -D container: "dop", ":u32le", ":u32be"
+};
+
+/**
+ * @brief What one run measured, written by the run, read by the calibration
+ */
+struct CalibrationReport {
+    std::string target;                     // Diretta target name
+    CycleTuning::Result callbacks;          // Whole run
+    double transitionMs = 0.0;              // Slowest format header -> prefill complete
+    int transitions = 0;                    // Formats opened
+    std::map<std::string, CycleTuning::Settings> cycles;   // Per CycleTuning::rateKey()
+
+    static constexpr const char* FILE_NAME = "run.state";
+
+    bool save(const std::string& dir, std::string& error) const;
+    bool load(const std::string& dir);
+};
+
+/**
+ * @brief Run the calibration
+ * @return Process exit code
+ */
+int runCalibration(const CalibrateOptions& options);
+
+/**
+ * @brief Stream a test signal on stdout as the patched squeezelite would
+ *        (SQFH header, then S32_LE frames), as fast as the pipe takes it
+ * @param spec "<pcm|dsd>:<rate>:<seconds>[,...]", DSD rates in bits/s
+ * @param dsdFormat -D container: "dop", ":u32le" or ":u32be"
+ * @return Process exit code
+ */
+int runTestSignal(const std::string& spec, const std::string& dsdFormat);
+
+#endif // SQUEEZE2DIRETTA_CALIBRATION_H
@@ -0,0 +1,170 @@
+/**
+ * @file ConvertPool.cpp
+ * @brief Small pinned thread pool that converts one chunk in parallel slices
+ */
+
+#include "ConvertPool.h"
+#include "CpuInfo.h"
+
+#include <algorithm>
+#include <climits>
+#include <string>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Chunks arrive every few milliseconds: spin this long for the next event
+// before sleeping in the kernel (a futex wake costs tens of microseconds)
+constexpr int SPIN_ITERATIONS = 2000;
+
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Wait until word != value: spin first, then sleep. parked is raised before
+// the futex call so that the waker knows a FUTEX_WAKE is needed; the kernel
+// rechecks word, so a change after parked was read as 0 is not missed.
+void waitWhileEquals(std::atomic<uint32_t>& word, uint32_t value, std::atomic<uint32_t>& parked) {
+    for (int i = 0; i < SPIN_ITERATIONS; i++) {
+        if (word.load(std::memory_order_acquire) != value) return;
+        cpuRelax();
+    }
+    while (word.load(std::memory_order_acquire) == value) {
+        parked.store(1, std::memory_order_seq_cst);
+        futexWait(word, value);
+        parked.store(0, std::memory_order_relaxed);
+    }
+}
+
+// Counterpart of waitWhileEquals(), after word was changed (seq_cst)
+void wakeIfParked(std::atomic<uint32_t>& word, std::atomic<uint32_t>& parked) {
+    if (parked.load(std::memory_order_seq_cst)) futexWake(word);
+}
+
+} // namespace
+
+ConvertPool::~ConvertPool() {
+    stop();
+}
+
+bool ConvertPool::start(int workers, const ThreadPolicy& policy) {
+    stop();
+    if (workers < 1 || workers > MAX_WORKERS) return false;
+
+    // Half the L2 per slice: its input and output both stay cached
+    size_t l2 = cpuCaches().l2;
+    m_maxSliceBytes = l2 ? std::max(MIN_SLICE_BYTES, l2 / 2) : DEFAULT_MAX_SLICE_BYTES;
+
+    m_stop.store(false, std::memory_order_relaxed);
+    for (int i = 0; i < workers; i++) {
+        ThreadPolicy placement = policy;
+        if (!policy.cpus.empty()) {
+            placement.cpus = {policy.cpus[static_cast<size_t>(i) % policy.cpus.size()]};
+        }
+        m_workers[i].jobSeq.store(0, std::memory_order_relaxed);
+        m_workers[i].parked.store(0, std::memory_order_relaxed);
+        m_workers[i].thread = std::thread(&ConvertPool::workerLoop, this, i, placement);
+    }
+    m_count = workers;
+    return true;
+}
+
+void ConvertPool::stop() {
+    if (m_count == 0) return;
+    m_stop.store(true, std::memory_order_release);
+    for (int i = 0; i < m_count; i++) {
+        m_workers[i].jobSeq.fetch_add(1, std::memory_order_release);
+        futexWake(m_workers[i].jobSeq);
+    }
+    for (int i = 0; i < m_count; i++) {
+        if (m_workers[i].thread.joinable()) m_workers[i].thread.join();
+    }
+    m_count = 0;
+}
+
+void ConvertPool::dispatch(SliceFn fn, void* context, size_t units, size_t unitBytes, size_t unitAlign) {
+    if (units == 0) return;
+    if (unitAlign == 0) unitAlign = 1;
+    if (unitBytes == 0) unitBytes = 1;
+
+    // About two slices per thread, each MIN_SLICE_BYTES..m_maxSliceBytes
+    size_t sliceBytes = units * unitBytes / (2 * (static_cast<size_t>(m_count) + 1));
+    sliceBytes = std::min(std::max(sliceBytes, MIN_SLICE_BYTES), m_maxSliceBytes);
+    size_t sliceUnits = std::max<size_t>(1, sliceBytes / unitBytes);
+    sliceUnits = (sliceUnits + unitAlign - 1) / unitAlign * unitAlign;
+    if (m_count == 0 || units * unitBytes < 2 * MIN_SLICE_BYTES || sliceUnits >= units) {
+        m_inlineRuns.fetch_add(1, std::memory_order_relaxed);
+        fn(context, 0, units);
+        return;
+    }
+    size_t slices = (units + sliceUnits - 1) / sliceUnits;
+    int helpers = static_cast<int>(std::min(static_cast<size_t>(m_count), slices - 1));
+
+    m_fn = fn;
+    m_context = context;
+    m_units = units;
+    m_sliceUnits = sliceUnits;
+    m_next.store(0, std::memory_order_relaxed);
+    m_pending.store(static_cast<uint32_t>(helpers), std::memory_order_relaxed);
+    for (int i = 0; i < helpers; i++) {
+        Worker& worker = m_workers[i];
+        worker.jobSeq.fetch_add(1, std::memory_order_seq_cst);
+        wakeIfParked(worker.jobSeq, worker.parked);
+    }
+
+    runSlices();
+
+    for (;;) {
+        uint32_t pending = m_pending.load(std::memory_order_acquire);
+        if (pending == 0) break;
+        waitWhileEquals(m_pending, pending, m_callerParked);
+    }
+    m_parallelRuns.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ConvertPool::runSlices() {
+    for (;;) {
+        size_t begin = m_next.fetch_add(m_sliceUnits, std::memory_order_relaxed);
+        if (begin >= m_units) return;
+        m_fn(m_context, begin, std::min(m_units, begin + m_sliceUnits));
+    }
+}
+
+void ConvertPool::workerLoop(int index, ThreadPolicy policy) {
+    std::string name = "s2d-conv" + std::to_string(index);
+    placeCurrentThread(name.c_str(), policy);
+
+    // jobSeq was 0 when the thread was created; a job may already be waiting
+    Worker& worker = m_workers[index];
+    uint32_t seen = 0;
+    for (;;) {
+        waitWhileEquals(worker.jobSeq, seen, worker.parked);
+        seen = worker.jobSeq.load(std::memory_order_acquire);
+        if (m_stop.load(std::memory_order_acquire)) break;
+
+        runSlices();
+
+        if (m_pending.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+            wakeIfParked(m_pending, m_callerParked);
+        }
+    }
+}
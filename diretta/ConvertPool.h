@@ -0,0 +1,109 @@
+/**
+ * @file ConvertPool.h
+ * @brief Small pinned thread pool that converts one chunk in parallel slices
+ *
+ * At DSD512/DSD1024 and 768 kHz the producer thread spends most of its time
+ * in format conversion (de-interleave, bit reverse, byte swap, 24-bit pack).
+ * run() cuts a chunk into slices of at most half the L2 (a slice's input and
+ * output stay cached), about two per thread, and the caller and the workers
+ * it wakes claim them from an atomic cursor until none are left, so a thread
+ * that starts late (preempted, still waking) leaves its share to the others.
+ * run() returns once every slice is done. Slices write disjoint parts of the
+ * output, so the caller still commits the whole chunk at once and stream
+ * order is unchanged.
+ *
+ * A thread announces that it is about to sleep on its futex word ("parked");
+ * the other side only makes the FUTEX_WAKE syscall for a parked thread, so
+ * back-to-back chunks, where workers are still spinning, cost no syscalls.
+ *
+ * Only one thread may call run() at a time (the ingest thread). Chunks too
+ * small to be worth a hand-off are converted inline.
+ */
+
+#ifndef SQUEEZE2DIRETTA_CONVERTPOOL_H
+#define SQUEEZE2DIRETTA_CONVERTPOOL_H
+
+#include "ThreadPolicy.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+class ConvertPool {
+public:
+    static constexpr int MAX_WORKERS = 7;
+    // Smallest slice worth waking a worker for (a few microseconds of work)
+    static constexpr size_t MIN_SLICE_BYTES = 8192;
+    // Largest slice if the L2 size is unknown
+    static constexpr size_t DEFAULT_MAX_SLICE_BYTES = 128 * 1024;
+
+    ConvertPool() = default;
+    ~ConvertPool();
+
+    ConvertPool(const ConvertPool&) = delete;
+    ConvertPool& operator=(const ConvertPool&) = delete;
+
+    /**
+     * @brief Start the worker threads (the caller is one more converter)
+     * @param workers Extra threads, 1..MAX_WORKERS
+     * @param policy  Placement; with a CPU list, worker i is pinned to the
+     *                i-th CPU of it (round-robin)
+     */
+    bool start(int workers, const ThreadPolicy& policy);
+    void stop();
+
+    int workers() const { return m_count; }
+    bool active() const { return m_count > 0; }
+
+    /**
+     * @brief Run fn(begin, end) over [0, units) in parallel slices
+     * @param unitBytes Input bytes per unit, to decide how many slices pay off
+     * @param unitAlign Slice boundaries are multiples of this many units
+     *                  (keeps SIMD blocks whole)
+     */
+    template <typename Fn>
+    void run(Fn& fn, size_t units, size_t unitBytes, size_t unitAlign = 1) {
+        dispatch(&thunk<Fn>, &fn, units, unitBytes, unitAlign);
+    }
+
+    uint64_t parallelRuns() const { return m_parallelRuns.load(std::memory_order_relaxed); }
+    uint64_t inlineRuns() const { return m_inlineRuns.load(std::memory_order_relaxed); }
+
+private:
+    using SliceFn = void (*)(void* context, size_t begin, size_t end);
+
+    template <typename Fn>
+    static void thunk(void* context, size_t begin, size_t end) {
+        (*static_cast<Fn*>(context))(begin, end);
+    }
+
+    void dispatch(SliceFn fn, void* context, size_t units, size_t unitBytes, size_t unitAlign);
+    void workerLoop(int index, ThreadPolicy policy);
+    void runSlices();
+
+    struct alignas(64) Worker {
+        std::thread thread;
+        std::atomic<uint32_t> jobSeq{0};    // futex word, bumped per chunk handed over
+        std::atomic<uint32_t> parked{0};    // 1 while sleeping (or about to) on jobSeq
+    };
+
+    Worker m_workers[MAX_WORKERS];
+    int m_count = 0;
+    size_t m_maxSliceBytes = DEFAULT_MAX_SLICE_BYTES;
+
+    // Current chunk, written before the jobSeq bumps that publish it
+    SliceFn m_fn = nullptr;
+    void* m_context = nullptr;
+    size_t m_units = 0;
+    size_t m_sliceUnits = 0;
+    alignas(64) std::atomic<size_t> m_next{0};         // cursor: first unit not yet claimed
+    alignas(64) std::atomic<uint32_t> m_pending{0};    // futex word, workers still on the chunk
+    std::atomic<uint32_t> m_callerParked{0};           // 1 while run() sleeps on m_pending
+    std::atomic<bool> m_stop{false};
+
+    std::atomic<uint64_t> m_parallelRuns{0};
+    std::atomic<uint64_t> m_inlineRuns{0};
+};
+
+#endif // SQUEEZE2DIRETTA_CONVERTPOOL_H
@@ -0,0 +1,98 @@
+/**
+ * @file CpuInfo.cpp
+ * @brief Cache sizes of the machine, for sizing decisions on the audio path
+ */
+
+#include "CpuInfo.h"
+
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+bool readLine(const std::string& path, std::string& out) {
+    std::ifstream f(path);
+    return static_cast<bool>(std::getline(f, out));
+}
+
+// "48K", "2048K", "1M"
+size_t parseCacheSize(const std::string& text) {
+    size_t value = 0;
+    size_t i = 0;
+    while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+        value = value * 10 + static_cast<size_t>(text[i] - '0');
+        i++;
+    }
+    if (i < text.size()) {
+        if (text[i] == 'K') value *= 1024;
+        else if (text[i] == 'M') value *= 1024 * 1024;
+    }
+    return value;
+}
+
+CpuCaches detectCaches() {
+    CpuCaches caches;
+    const std::string root = "/sys/devices/system/cpu/cpu0/cache/index";
+
+    for (int index = 0; index < 8; index++) {
+        std::string dir = root + std::to_string(index) + "/";
+        std::string level, type, size;
+        if (!readLine(dir + "level", level) || !readLine(dir + "type", type) ||
+            !readLine(dir + "size", size)) {
+            break;
+        }
+        if (type == "Instruction") continue;
+
+        int lvl = std::stoi(level);
+        size_t bytes = parseCacheSize(size);
+        if (lvl == 1) caches.l1d = bytes;
+        if (lvl == 2) caches.l2 = bytes;
+        if (lvl >= caches.llcLevel && bytes > 0) {
+            caches.llc = bytes;
+            caches.llcLevel = lvl;
+        }
+    }
+
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    // No sysfs cache description (containers, some ARM kernels): ask glibc
+    if (caches.llc == 0) {
+        long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (l2 > 0) caches.l2 = static_cast<size_t>(l2);
+        if (l3 > 0) {
+            caches.llc = static_cast<size_t>(l3);
+            caches.llcLevel = 3;
+        } else if (l2 > 0) {
+            caches.llc = static_cast<size_t>(l2);
+            caches.llcLevel = 2;
+        }
+    }
+#endif
+    return caches;
+}
+
+} // namespace
+
+std::string cpuModelName() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    std::string implementer, part;
+    while (std::getline(in, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+        std::string value = colon + 2 <= line.size() ? line.substr(colon + 2) : "";
+        if (key == "model name") return value;
+        if (key == "CPU implementer" && implementer.empty()) implementer = value;
+        if (key == "CPU part" && part.empty()) part = value;
+    }
+    if (!implementer.empty()) return "arm " + implementer + "/" + part;
+    return "unknown";
+}
+
+const CpuCaches& cpuCaches() {
+    static const CpuCaches caches = detectCaches();
+    return caches;
+}
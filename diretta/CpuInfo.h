@@ -0,0 +1,33 @@
+/**
+ * @file CpuInfo.h
+ * @brief Cache sizes of the machine, for sizing decisions on the audio path
+ *
+ * Read once from sysfs (cpu0's cache hierarchy), which works on x86 and on
+ * ARM boards whose device tree describes the caches. Sizes are 0 if unknown.
+ */
+
+#ifndef SQUEEZE2DIRETTA_CPUINFO_H
+#define SQUEEZE2DIRETTA_CPUINFO_H
+
+#include <cstddef>
+#include <string>
+
+struct CpuCaches {
+    size_t l1d = 0;
+    size_t l2 = 0;
+    size_t llc = 0;        // Largest data/unified level (L2 on most SBCs, L3 on x86)
+    int llcLevel = 0;
+};
+
+/**
+ * @brief Cache sizes of cpu0 (cached after the first call)
+ */
+const CpuCaches& cpuCaches();
+
+/**
+ * @brief CPU model from /proc/cpuinfo ("model name" on x86, implementer and
+ *        part on ARM), used to invalidate per-machine calibration results
+ */
+std::string cpuModelName();
+
+#endif // SQUEEZE2DIRETTA_CPUINFO_H
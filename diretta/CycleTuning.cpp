@@ -0,0 +1,247 @@
+/**
+ * @file CycleTuning.cpp
+ * @brief Cycle time and transfer mode tried per Diretta target and rate
+ */
+
+#include "CycleTuning.h"
+#include "StateFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+constexpr const char* STATE_FILE = "cycle.state";
+
+// DirettaTransferMode order
+const char* const MODE_NAMES[] = {"FixAuto", "VarAuto", "VarMax"};
+constexpr int MODE_COUNT = 3;
+
+// Score weights: an underrun per minute outweighs any jitter difference,
+// a late callback per minute counts as 10us of jitter
+constexpr double UNDERRUN_WEIGHT = 1000.0;
+constexpr double LATE_WEIGHT = 10.0;
+
+// Zones share one file: read-merge-write one at a time
+std::mutex g_saveMutex;
+
+int modeFromName(const std::string& name) {
+    for (int i = 0; i < MODE_COUNT; i++) {
+        if (name == MODE_NAMES[i]) return i;
+    }
+    return -1;
+}
+
+} // namespace
+
+void CycleTuning::open(const std::string& stateDir, const std::string& targetName,
+                       unsigned int minUs, unsigned int maxUs, const std::vector<int>& modes) {
+    m_stateDir = stateDir;
+    m_minUs = minUs;
+    m_maxUs = maxUs;
+    m_modes = modes;
+    m_prefix.clear();
+    for (char c : targetName) {
+        m_prefix += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    if (m_prefix.empty()) m_prefix = "target";
+    m_entries.clear();
+    m_dirty = false;
+
+    if (m_stateDir.empty()) return;
+    StateFile state(m_stateDir, STATE_FILE);
+    if (!state.load()) return;
+
+    // <target>.<rate>.cycle_us marks an entry
+    const std::string suffix = ".cycle_us";
+    for (const auto& it : state.values()) {
+        const std::string& name = it.first;
+        if (name.size() <= m_prefix.size() + 1 + suffix.size() ||
+            name.compare(0, m_prefix.size() + 1, m_prefix + ".") != 0 ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        std::string rate = name.substr(m_prefix.size() + 1, name.size() - m_prefix.size() - 1 - suffix.size());
+        int mode = modeFromName(state.get(key(rate, "mode")));
+        unsigned int cycleUs = static_cast<unsigned int>(std::atoi(it.second.c_str()));
+        if (mode < 0 || cycleUs == 0) continue;
+
+        Entry& entry = m_entries[rate];
+        entry.best.cycleUs = cycleUs;
+        entry.best.mode = mode;
+        entry.bestScore = std::atof(state.get(key(rate, "score"), "0").c_str());
+        entry.settled = state.get(key(rate, "settled")) == "1";
+        entry.baseUs = static_cast<unsigned int>(std::atoi(state.get(key(rate, "base_us"), "0").c_str()));
+        if (entry.baseUs == 0) entry.baseUs = cycleUs;
+        entry.trials = std::atoi(state.get(key(rate, "trials"), "0").c_str());
+        entry.tried.push_back(entry.best);
+        // "<us>:<mode>,..."
+        std::istringstream tried(state.get(key(rate, "tried")));
+        std::string item;
+        while (std::getline(tried, item, ',')) {
+            size_t colon = item.find(':');
+            if (colon == std::string::npos) continue;
+            Settings s;
+            s.cycleUs = static_cast<unsigned int>(std::atoi(item.substr(0, colon).c_str()));
+            s.mode = modeFromName(item.substr(colon + 1));
+            if (s.cycleUs == 0 || s.mode < 0) continue;
+            if (std::find(entry.tried.begin(), entry.tried.end(), s) == entry.tried.end()) {
+                entry.tried.push_back(s);
+            }
+        }
+        if (!entry.settled) planNeighbours(entry);
+    }
+}
+
+std::string CycleTuning::rateKey(bool dsd, uint32_t sampleRate) {
+    return (dsd ? "dsd" : "pcm") + std::to_string(sampleRate);
+}
+
+CycleTuning::Settings CycleTuning::next(const std::string& key, const Settings& base) const {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return base;
+    const Entry& entry = it->second;
+    if (entry.settled || entry.queue.empty()) return entry.best;
+    return entry.queue.front();
+}
+
+bool CycleTuning::report(const std::string& key, const Settings& used, const Settings& base, const Result& result) {
+    if (result.seconds < MIN_SESSION_S) return false;
+    double sessionScore = score(result);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        Entry& entry = m_entries[key];
+        entry.best = used;
+        entry.baseUs = base.cycleUs;
+        entry.bestScore = sessionScore;
+        entry.tried.push_back(used);
+        planNeighbours(entry);
+        m_dirty = true;
+        return true;
+    }
+
+    Entry& entry = it->second;
+    entry.baseUs = base.cycleUs;
+    if (used == entry.best) {
+        // Conditions drift: follow the best settings' score
+        entry.bestScore = 0.5 * (entry.bestScore + sessionScore);
+        m_dirty = true;
+        return true;
+    }
+
+    if (!entry.queue.empty() && used == entry.queue.front()) entry.queue.pop_front();
+    if (std::find(entry.tried.begin(), entry.tried.end(), used) == entry.tried.end()) {
+        entry.tried.push_back(used);
+    }
+    entry.trials++;
+    if (sessionScore < entry.bestScore) {
+        entry.best = used;
+        entry.bestScore = sessionScore;
+        entry.queue.clear();
+        planNeighbours(entry);
+    }
+    if (entry.queue.empty() || entry.trials >= MAX_TRIALS) {
+        entry.settled = true;
+        entry.queue.clear();
+    }
+    m_dirty = true;
+    return true;
+}
+
+void CycleTuning::settle(const std::string& key, const Settings& best, unsigned int baseUs, double bestScore) {
+    Entry& entry = m_entries[key];
+    entry.best = best;
+    entry.baseUs = baseUs;
+    entry.bestScore = bestScore;
+    entry.settled = true;
+    entry.queue.clear();
+    if (std::find(entry.tried.begin(), entry.tried.end(), best) == entry.tried.end()) {
+        entry.tried.push_back(best);
+    }
+    m_dirty = true;
+}
+
+std::string CycleTuning::describe(const std::string& key) const {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return "no result yet";
+    const Entry& entry = it->second;
+    std::ostringstream out;
+    out << "best " << entry.best.cycleUs << "us " << modeName(entry.best.mode)
+        << " (score " << std::fixed << std::setprecision(1) << entry.bestScore << ")";
+    if (entry.settled) {
+        out << ", settled";
+    } else {
+        out << ", trial " << entry.trials << "/" << MAX_TRIALS << ", " << entry.queue.size() << " to try";
+    }
+    return out.str();
+}
+
+bool CycleTuning::save(std::string& error) {
+    if (!m_dirty || m_stateDir.empty()) return true;
+
+    std::lock_guard<std::mutex> lock(g_saveMutex);
+    StateFile state(m_stateDir, STATE_FILE);
+    state.load();
+    for (const auto& it : m_entries) {
+        std::ostringstream score;
+        score << std::fixed << std::setprecision(1) << it.second.bestScore;
+        std::string tried;
+        for (const Settings& s : it.second.tried) {
+            if (!tried.empty()) tried += ",";
+            tried += std::to_string(s.cycleUs) + ":" + modeName(s.mode);
+        }
+        state.set(key(it.first, "cycle_us"), std::to_string(it.second.best.cycleUs));
+        state.set(key(it.first, "mode"), modeName(it.second.best.mode));
+        state.set(key(it.first, "score"), score.str());
+        state.set(key(it.first, "base_us"), std::to_string(it.second.baseUs));
+        state.set(key(it.first, "trials"), std::to_string(it.second.trials));
+        state.set(key(it.first, "tried"), tried);
+        state.set(key(it.first, "settled"), it.second.settled ? "1" : "0");
+    }
+    if (!state.save(error)) return false;
+    m_dirty = false;
+    return true;
+}
+
+const char* CycleTuning::modeName(int mode) {
+    return mode >= 0 && mode < MODE_COUNT ? MODE_NAMES[mode] : "?";
+}
+
+double CycleTuning::score(const Result& result) {
+    double minutes = result.seconds / 60.0;
+    return result.jitterUs + LATE_WEIGHT * result.lateCallbacks / minutes + UNDERRUN_WEIGHT * result.underruns / minutes;
+}
+
+void CycleTuning::planNeighbours(Entry& entry) const {
+    unsigned int lo = m_minUs > 0 ? m_minUs : entry.baseUs / 2;
+    unsigned int hi = m_maxUs > 0 ? m_maxUs : entry.baseUs * 2;
+
+    std::vector<Settings> candidates;
+    for (double factor : {1.0 - STEP, 1.0 + STEP}) {
+        Settings s = entry.best;
+        s.cycleUs = static_cast<unsigned int>(std::lround(entry.best.cycleUs * factor));
+        s.cycleUs = std::max(lo, std::min(s.cycleUs, hi));
+        candidates.push_back(s);
+    }
+    for (int mode : m_modes) {
+        Settings s = entry.best;
+        s.mode = mode;
+        candidates.push_back(s);
+    }
+    for (const Settings& s : candidates) {
+        if (s == entry.best) continue;
+        if (std::find(entry.tried.begin(), entry.tried.end(), s) != entry.tried.end()) continue;
+        if (std::find(entry.queue.begin(), entry.queue.end(), s) != entry.queue.end()) continue;
+        entry.queue.push_back(s);
+    }
+}
+
+std::string CycleTuning::key(const std::string& rate, const char* field) const {
+    return m_prefix + "." + rate + "." + field;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file CycleTuning.h
+ * @brief Cycle time and transfer mode tried per Diretta target and rate
+ *
+ * In adaptive mode (DirettaConfig::adaptiveCycle) every playback session,
+ * from one open() to the next or to close(), runs with one cycle time and
+ * transfer mode and is scored from SDK callback regularity, late callbacks
+ * and underruns. The next session at that rate tries a neighbour of the
+ * best settings so far (cycle time 10% shorter or longer, another transfer
+ * mode) until none does better or MAX_TRIALS sessions were spent, then
+ * keeps the best. Settings only change where the connection is set up
+ * anyway: a format change, or reopening after an idle release.
+ *
+ * Results are kept in cycle.state under the state directory, one entry per
+ * target and rate.
+ */
+
+#ifndef SQUEEZE2DIRETTA_CYCLETUNING_H
+#define SQUEEZE2DIRETTA_CYCLETUNING_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+class CycleTuning {
+public:
+    static constexpr double STEP = 0.1;             // Cycle time nudge per trial
+    static constexpr double MIN_SESSION_S = 20.0;   // Shorter sessions are not scored
+    static constexpr int MAX_TRIALS = 8;            // Per rate, then settle
+
+    struct Settings {
+        unsigned int cycleUs = 0;
+        int mode = 0;                // DirettaTransferMode, never AUTO
+        bool operator==(const Settings& other) const {
+            return cycleUs == other.cycleUs && mode == other.mode;
+        }
+    };
+
+    struct Result {
+        double seconds = 0.0;        // Time covered by SDK callbacks
+        double jitterUs = 0.0;       // RMS deviation of the callback interval
+        uint64_t lateCallbacks = 0;  // Intervals beyond twice the cycle time
+        uint32_t underruns = 0;      // Underruns playback recovered from
+    };
+
+    /**
+     * @brief Load the results for this target (by name)
+     * @param stateDir State directory; empty = tune for this run only
+     * @param minUs, maxUs Cycle time bounds; 0 = half / twice the base
+     * @param modes Transfer modes to try (DirettaTransferMode values)
+     */
+    void open(const std::string& stateDir, const std::string& targetName,
+              unsigned int minUs, unsigned int maxUs, const std::vector<int>& modes);
+
+    static std::string rateKey(bool dsd, uint32_t sampleRate);
+
+    /**
+     * @brief Settings for the next session at this rate
+     * @param base Calculated (or configured) cycle time and resolved mode,
+     *             used until the rate has a result
+     */
+    Settings next(const std::string& key, const Settings& base) const;
+
+    /**
+     * @brief Score a finished session and pick what to try next
+     * @return false if the session was too short to count
+     */
+    bool report(const std::string& key, const Settings& used, const Settings& base, const Result& result);
+
+    /**
+     * @brief Take settings measured elsewhere (--calibrate) as the settled
+     *        best for this rate
+     */
+    void settle(const std::string& key, const Settings& best, unsigned int baseUs, double bestScore);
+
+    /**
+     * @brief One line on where the rate stands, for statistics
+     */
+    std::string describe(const std::string& key) const;
+
+    /**
+     * @brief Merge this target's entries into the state file (entries of
+     *        other targets are kept). No-op if unchanged.
+     * @param error Set to the reason on failure
+     */
+    bool save(std::string& error);
+
+    static const char* modeName(int mode);
+
+    /**
+     * @brief Lower is better: callback jitter, plus late callbacks and
+     *        underruns per minute, weighted
+     */
+    static double score(const Result& result);
+
+private:
+    struct Entry {
+        Settings best;
+        unsigned int baseUs = 0;       // Calculated cycle time, for the default bounds
+        double bestScore = 0.0;
+        bool settled = false;
+        int trials = 0;
+        std::deque<Settings> queue;    // Neighbours of best still to try
+        std::vector<Settings> tried;
+    };
+
+    void planNeighbours(Entry& entry) const;
+    std::string key(const std::string& rate, const char* field) const;
+
+    std::string m_stateDir;
+    std::string m_prefix;              // Sanitized target name
+    unsigned int m_minUs = 0;
+    unsigned int m_maxUs = 0;
+    std::vector<int> m_modes;
+    std::map<std::string, Entry> m_entries;
+    bool m_dirty = false;
+};
+
+#endif // SQUEEZE2DIRETTA_CYCLETUNING_H
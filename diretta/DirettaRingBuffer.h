@@ -18,6 +18,7 @@
 #include <cstdlib>
 #include <new>
 #include <type_traits>
+#include <utility>
 
 // Architecture detection for SIMD support
 // Require both x86 platform AND AVX2 compiler flag (-mavx2 or -march=x86-64-v3+)
@@ -36,6 +37,56 @@
 #endif
 
 #include "memcpyfast_audio.h"
+#include "ConvertPool.h"
+
+//=============================================================================
+// Content scan
+//=============================================================================
+
+/**
+ * @brief OR of every 32-bit little-endian word in data (trailing bytes too)
+ *
+ * 0 means digital silence. Byte 0 / byte 3 of the result tell whether any
+ * S24_P32 sample has a non-zero LSB / MSB byte (see S24PackMode). For paths
+ * that do not convert; the converting ones return the same value from their
+ * own pass.
+ */
+inline uint32_t or_reduce_audio(const uint8_t* data, size_t len) {
+    size_t i = 0;
+    uint32_t acc = 0;
+#if DIRETTA_HAS_AVX2
+    __m256i v0 = _mm256_setzero_si256();
+    __m256i v1 = _mm256_setzero_si256();
+    for (; i + 64 <= len; i += 64) {
+        v0 = _mm256_or_si256(v0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        v1 = _mm256_or_si256(v1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)));
+    }
+    v0 = _mm256_or_si256(v0, v1);
+    __m128i v = _mm_or_si128(_mm256_castsi256_si128(v0), _mm256_extracti128_si256(v0, 1));
+    v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+    v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+    acc = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+    _mm256_zeroupper();
+#elif DIRETTA_HAS_NEON
+    uint32x4_t v0 = vdupq_n_u32(0);
+    uint32x4_t v1 = vdupq_n_u32(0);
+    for (; i + 32 <= len; i += 32) {
+        v0 = vorrq_u32(v0, vreinterpretq_u32_u8(vld1q_u8(data + i)));
+        v1 = vorrq_u32(v1, vreinterpretq_u32_u8(vld1q_u8(data + i + 16)));
+    }
+    v0 = vorrq_u32(v0, v1);
+    acc = vgetq_lane_u32(v0, 0) | vgetq_lane_u32(v0, 1) | vgetq_lane_u32(v0, 2) | vgetq_lane_u32(v0, 3);
+#endif
+    for (; i + 4 <= len; i += 4) {
+        uint32_t word;
+        std::memcpy(&word, data + i, 4);
+        acc |= word;
+    }
+    for (; i < len; i++) {
+        acc |= static_cast<uint32_t>(data[i]) << (8 * (i & 3));
+    }
+    return acc;
+}
 
 template <typename T, size_t Alignment>
 class AlignedAllocator {
@@ -145,13 +196,67 @@ public:
     void resize(size_t newSize, uint8_t silenceByte) {
         size_ = roundUpPow2(newSize);
         mask_ = size_ - 1;
-        buffer_.resize(size_);
+        if (size_ > capacity_) {
+            // No attached storage, or it is too small for this format: grow
+            // the owned buffer (allocates - only expected before attachStorage())
+            ownedBuffer_.resize(size_);
+            buffer_ = ownedBuffer_.data();
+            capacity_ = ownedBuffer_.size();
+        }
         silenceByte_.store(silenceByte, std::memory_order_release);
         clear();  // Resets all S24 state - hint will be set by caller via setS24PackModeHint()
         fillWithSilence();
     }
 
+    /**
+     * @brief Use external storage (e.g. carved from an AudioArena)
+     *
+     * Every later resize() up to the largest power of two that fits reuses
+     * this storage, so format changes never allocate. Must not be called while
+     * the ring is in use; the current contents are discarded.
+     */
+    void attachStorage(uint8_t* storage, size_t bytes) {
+        size_t capacity = 1;
+        while (capacity * 2 <= bytes) capacity <<= 1;
+
+        buffer_ = storage;
+        capacity_ = capacity;
+        ownedBuffer_.clear();
+        ownedBuffer_.shrink_to_fit();
+        resize(std::min(std::max<size_t>(size_, 1), capacity_), silenceByte());
+    }
+
+    /**
+     * @brief Write with streaming (non-temporal) stores beyond a fill level
+     *
+     * Once the data already queued ahead of the reader exceeds the last-level
+     * cache, a new write will have left the cache by the time it is read, so
+     * it bypasses the cache instead of evicting the consumer's hot data. The
+     * consumer then prefetches its next buffer. SIZE_MAX disables streaming
+     * stores (default), 0 uses them for every write of STREAM_MIN_BYTES+.
+     */
+    void setStreamingStoreThreshold(size_t fillBytes) {
+        streamThreshold_ = fillBytes;
+    }
+
+    size_t streamingStoreThreshold() const { return streamThreshold_; }
+
+    /**
+     * @brief Convert large pushes in parallel slices (nullptr = on the caller)
+     *
+     * Set before streaming; the pool must outlive the ring's use of it.
+     */
+    void setConvertPool(ConvertPool* pool) { convertPool_ = pool; }
+    ConvertPool* convertPool() const { return convertPool_; }
+
+    /**
+     * @brief Bytes written with streaming stores / all bytes written
+     */
+    uint64_t streamedBytes() const { return streamedBytes_.load(std::memory_order_relaxed); }
+    uint64_t writtenBytes() const { return writtenBytes_.load(std::memory_order_relaxed); }
+
     size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
     uint8_t silenceByte() const { return silenceByte_.load(std::memory_order_acquire); }
 
     size_t getAvailable() const {
@@ -163,18 +268,27 @@ public:
         return (wp - rp) & mask_;
     }
 
+    /**
+     * @brief Space the producer may write: bounded by the slowest reader
+     *        (the primary one or an active tap)
+     */
     size_t getFreeSpace() const {
         if (size_ == 0) {
             return 0;
         }
         size_t wp = writePos_.load(std::memory_order_acquire);
-        size_t rp = readPos_.load(std::memory_order_acquire);
+        size_t rp = producerReadPos(wp);
         return (rp - wp - 1) & mask_;
     }
 
     void clear() {
         writePos_.store(0, std::memory_order_release);
         readPos_.store(0, std::memory_order_release);
+        for (int i = 0; i < tapCount_; i++) {
+            taps_[i].active.store(false, std::memory_order_relaxed);
+            taps_[i].pos.store(0, std::memory_order_relaxed);
+        }
+        activeTaps_.store(0, std::memory_order_release);
         // Reset all S24 state to allow fresh detection for new tracks
         // New track will set hint via setS24PackModeHint() if available
         m_s24PackMode = S24PackMode::Unknown;
@@ -184,7 +298,7 @@ public:
     }
 
     void fillWithSilence() {
-        std::memset(buffer_.data(), silenceByte_.load(std::memory_order_relaxed), size_);
+        std::memset(buffer_, silenceByte_.load(std::memory_order_relaxed), size_);
     }
 
     const uint8_t* getStaging24BitPack() const { return m_staging24BitPack; }
@@ -225,7 +339,7 @@ public:
         }
 
         size_t wp = writePos_.load(std::memory_order_acquire);
-        size_t rp = readPos_.load(std::memory_order_acquire);
+        size_t rp = producerReadPos(wp);
 
         // Calculate free space
         size_t free = (rp > wp) ? (rp - wp - 1) : (size_ - wp + rp - 1);
@@ -249,7 +363,7 @@ public:
         }
 
         if (contiguous >= needed) {
-            region = buffer_.data() + wp;
+            region = buffer_ + wp;
             available = contiguous;
             return true;
         }
@@ -297,21 +411,28 @@ public:
 
     /**
      * @brief Push PCM data directly (no conversion)
+     * @param contentOr If set, OR-ed with every input word consumed (see
+     *                  or_reduce_audio), scanned block by block as it is copied
      *
      * Optimized path: uses direct write when contiguous space available,
      * avoiding the check-then-copy overhead of the wraparound case.
      */
-    size_t push(const uint8_t* data, size_t len) {
+    size_t push(const uint8_t* data, size_t len, uint32_t* contentOr = nullptr) {
         if (size_ == 0) return 0;
         size_t free = getFreeSpace();
         if (len > free) len = free;
         if (len == 0) return 0;
 
+        bool stream = useStreamingStores(size_ - 1 - free, len);
+        if (contentOr) {
+            return pushScanned(data, len, stream, contentOr);
+        }
+
         // Fast path: try direct write (no wraparound)
         uint8_t* region;
         size_t available;
         if (getDirectWriteRegion(len, region, available)) {
-            memcpy_audio(region, data, len);
+            copyIn(region, data, len, stream);
             commitDirectWrite(len);
             return len;
         }
@@ -320,9 +441,9 @@ public:
         size_t wp = writePos_.load(std::memory_order_acquire);
         size_t firstChunk = std::min(len, size_ - wp);
 
-        memcpy_audio(buffer_.data() + wp, data, firstChunk);
+        copyIn(buffer_ + wp, data, firstChunk, stream);
         if (firstChunk < len) {
-            memcpy_audio(buffer_.data(), data + firstChunk, len - firstChunk);
+            copyIn(buffer_, data + firstChunk, len - firstChunk, stream);
         }
 
         writePos_.store((wp + len) & mask_, std::memory_order_release);
@@ -331,14 +452,17 @@ public:
 
     /**
      * @brief Push with 24-bit packing (4 bytes in -> 3 bytes out, S24_P32 format)
+     * @param contentOr If set, OR-ed with every input word consumed
+     *                  (see or_reduce_audio), from the packing pass itself
      * @return Input bytes consumed
      *
      * Uses hybrid S24 detection:
-     * 1. Sample-based detection takes priority (checks actual byte values)
+     * 1. Sample-based detection takes priority (first S24_DETECT_SAMPLES
+     *    samples of the chunk)
      * 2. Hint from FFmpeg metadata used as fallback for silence
      * 3. Timeout defaults to LSB after ~1 second of silence
      */
-    size_t push24BitPacked(const uint8_t* data, size_t inputSize) {
+    size_t push24BitPacked(const uint8_t* data, size_t inputSize, uint32_t* contentOr = nullptr) {
         if (size_ == 0) return 0;
         size_t numSamples = inputSize / 4;
         if (numSamples == 0) return 0;
@@ -355,45 +479,46 @@ public:
 
         // Hybrid S24 detection - sample detection can override hints
         // Always run detection when Unknown/Deferred, or when hint was applied but not confirmed
-        if (m_s24PackMode == S24PackMode::Unknown || m_s24PackMode == S24PackMode::Deferred ||
-            (m_s24PackMode == m_s24Hint && !m_s24DetectionConfirmed)) {
-            S24PackMode detected = detectS24PackMode(data, numSamples);
-            if (detected != S24PackMode::Deferred) {
-                // Sample detection found definitive result - use it
-                m_s24PackMode = detected;
-                m_s24DetectionConfirmed = true;
-                m_deferredSampleCount = 0;
-            } else {
-                // Still silence - accumulate count for timeout
-                m_deferredSampleCount += numSamples;
-                // Timeout: if still silent after threshold, use hint or default to LSB
-                if (m_deferredSampleCount > DEFERRED_TIMEOUT_SAMPLES) {
-                    m_s24PackMode = (m_s24Hint != S24PackMode::Unknown) ? m_s24Hint : S24PackMode::LsbAligned;
-                    m_s24DetectionConfirmed = true;
-                }
-            }
+        bool detecting = m_s24PackMode == S24PackMode::Unknown || m_s24PackMode == S24PackMode::Deferred ||
+                         (m_s24PackMode == m_s24Hint && !m_s24DetectionConfirmed);
+        if (detecting) {
+            updateS24Detection(probeS24Lanes(data, numSamples), numSamples);
         }
-
-        // Use effective mode for conversion (Deferred/Unknown use hint or LSB as fallback)
-        S24PackMode effectiveMode = m_s24PackMode;
-        if (effectiveMode == S24PackMode::Deferred || effectiveMode == S24PackMode::Unknown) {
-            effectiveMode = (m_s24Hint != S24PackMode::Unknown) ? m_s24Hint : S24PackMode::LsbAligned;
+        bool msbAligned = effectiveS24PackMode() == S24PackMode::MsbAligned;
+
+        uint32_t lanes = 0;
+        size_t written;
+        if (convertPool_ && convertPool_->active()) {
+            std::atomic<uint32_t> sliceLanes{0};
+            written = pushConverted(m_staging24BitPack, numSamples, 4, 3, 16,
+                [&](uint8_t* out, size_t begin, size_t end) {
+                    uint32_t local = 0;
+                    if (msbAligned) {
+                        convert24BitPackedShifted_AVX2(out, data + begin * 4, end - begin, &local);
+                    } else {
+                        convert24BitPacked_AVX2(out, data + begin * 4, end - begin, &local);
+                    }
+                    sliceLanes.fetch_or(local, std::memory_order_relaxed);
+                });
+            lanes = sliceLanes.load(std::memory_order_relaxed);
+        } else {
+            size_t stagedBytes = msbAligned
+                ? convert24BitPackedShifted_AVX2(m_staging24BitPack, data, numSamples, &lanes)
+                : convert24BitPacked_AVX2(m_staging24BitPack, data, numSamples, &lanes);
+            written = writeToRing(m_staging24BitPack, stagedBytes);
         }
-
-        size_t stagedBytes = (effectiveMode == S24PackMode::MsbAligned)
-            ? convert24BitPackedShifted_AVX2(m_staging24BitPack, data, numSamples)
-            : convert24BitPacked_AVX2(m_staging24BitPack, data, numSamples);
-        size_t written = writeToRing(m_staging24BitPack, stagedBytes);
         size_t samplesWritten = written / 3;
 
+        if (contentOr) *contentOr |= lanes;
         return samplesWritten * 4;
     }
 
     /**
      * @brief Push with 16-to-32 bit upsampling
+     * @param contentOr If set, OR-ed with every input sample, from the conversion pass
      * @return Input bytes consumed
      */
-    size_t push16To32(const uint8_t* data, size_t inputSize) {
+    size_t push16To32(const uint8_t* data, size_t inputSize, uint32_t* contentOr = nullptr) {
         if (size_ == 0) return 0;
         size_t numSamples = inputSize / 2;
         if (numSamples == 0) return 0;
@@ -408,7 +533,7 @@ public:
 
         prefetch_audio_buffer(data, numSamples * 2);
 
-        size_t stagedBytes = convert16To32_AVX2(m_staging16To32, data, numSamples);
+        size_t stagedBytes = convert16To32_AVX2(m_staging16To32, data, numSamples, contentOr);
         size_t written = writeToRing(m_staging16To32, stagedBytes);
         size_t samplesWritten = written / 4;
 
@@ -417,12 +542,13 @@ public:
 
     /**
      * @brief Push with 16-to-24 bit upsampling
+     * @param contentOr If set, OR-ed with every input sample, from the conversion pass
      * @return Input bytes consumed
      *
      * Converts 16-bit samples to packed 24-bit format.
      * Used when sink only supports 24-bit (not 32-bit).
      */
-    size_t push16To24(const uint8_t* data, size_t inputSize) {
+    size_t push16To24(const uint8_t* data, size_t inputSize, uint32_t* contentOr = nullptr) {
         if (size_ == 0) return 0;
         size_t numSamples = inputSize / 2;
         if (numSamples == 0) return 0;
@@ -437,7 +563,7 @@ public:
 
         prefetch_audio_buffer(data, numSamples * 2);
 
-        size_t stagedBytes = convert16To24(m_staging16To32, data, numSamples);
+        size_t stagedBytes = convert16To24(m_staging16To32, data, numSamples, contentOr);
         size_t written = writeToRing(m_staging16To32, stagedBytes);
         size_t samplesWritten = written / 3;
 
@@ -445,19 +571,20 @@ public:
     }
 
     /**
-     * @brief Optimized DSD planar push using pre-selected conversion mode
+     * @brief DSD planar push, conversion and channel count fixed at compile time
      *
-     * Uses specialized conversion functions with no per-iteration branch checks.
-     * Mode should be determined at track open and cached in DirettaSync.
+     * One instantiation per (mode, channel count) is selected when the ring
+     * is configured (DirettaSync::configureRingDSD), so nothing is decided
+     * per call. Channels = 0 takes the count from numChannels.
      *
      * @param data Planar DSD data
      * @param inputSize Total input size in bytes
-     * @param numChannels Number of audio channels
-     * @param mode Pre-selected conversion mode (eliminates runtime checks)
+     * @param numChannels Number of audio channels (Channels = 0 only)
      * @return Input bytes consumed
      */
-    size_t pushDSDPlanarOptimized(const uint8_t* data, size_t inputSize,
-                                   int numChannels, DSDConversionMode mode) {
+    template <DSDConversionMode Mode, int Channels = 0>
+    size_t pushDSDPlanar(const uint8_t* data, size_t inputSize, int numChannels) {
+        if (Channels > 0) numChannels = Channels;
         if (size_ == 0) return 0;
         if (numChannels == 0) return 0;
 
@@ -471,29 +598,59 @@ public:
         size_t usableInput = completeGroups * 4 * static_cast<size_t>(numChannels);
         if (usableInput == 0) return 0;
 
+        // Channel planes stay inputSize / numChannels apart when only part
+        // of the block fits
+        size_t channelStride = inputSize / static_cast<size_t>(numChannels);
+
+        if (convertPool_ && convertPool_->active()) {
+            // Units are 4-byte groups per channel, sliced on 32-byte SIMD blocks
+            size_t groupBytes = 4 * static_cast<size_t>(numChannels);
+            return pushConverted(m_stagingDSD, completeGroups, groupBytes, groupBytes, 8,
+                [&](uint8_t* out, size_t begin, size_t end) {
+                    convertDSD<Mode, Channels>(out, data + begin * 4, (end - begin) * groupBytes,
+                                               numChannels, channelStride);
+                });
+        }
+
         prefetch_audio_buffer(data, usableInput);
+        size_t stagedBytes = convertDSD<Mode, Channels>(m_stagingDSD, data, usableInput,
+                                                         numChannels, channelStride);
+        return writeToRing(m_stagingDSD, stagedBytes);
+    }
 
-        size_t stagedBytes;
+    /**
+     * @brief DSD planar push with the conversion mode chosen at run time
+     */
+    size_t pushDSDPlanarOptimized(const uint8_t* data, size_t inputSize,
+                                   int numChannels, DSDConversionMode mode) {
         switch (mode) {
-            case DSDConversionMode::Passthrough:
-                stagedBytes = convertDSD_Passthrough(m_stagingDSD, data, usableInput, numChannels);
-                break;
             case DSDConversionMode::BitReverseOnly:
-                stagedBytes = convertDSD_BitReverse(m_stagingDSD, data, usableInput, numChannels);
-                break;
+                return pushDSDPlanar<DSDConversionMode::BitReverseOnly>(data, inputSize, numChannels);
             case DSDConversionMode::ByteSwapOnly:
-                stagedBytes = convertDSD_ByteSwap(m_stagingDSD, data, usableInput, numChannels);
-                break;
+                return pushDSDPlanar<DSDConversionMode::ByteSwapOnly>(data, inputSize, numChannels);
             case DSDConversionMode::BitReverseAndSwap:
-                stagedBytes = convertDSD_BitReverseSwap(m_stagingDSD, data, usableInput, numChannels);
-                break;
+                return pushDSDPlanar<DSDConversionMode::BitReverseAndSwap>(data, inputSize, numChannels);
+            case DSDConversionMode::Passthrough:
             default:
-                // Fallback to passthrough if unknown mode
-                stagedBytes = convertDSD_Passthrough(m_stagingDSD, data, usableInput, numChannels);
-                break;
+                return pushDSDPlanar<DSDConversionMode::Passthrough>(data, inputSize, numChannels);
         }
+    }
 
-        return writeToRing(m_stagingDSD, stagedBytes);
+    /**
+     * @brief Convert planar DSD with a compile-time mode (see convertDSD_*)
+     */
+    template <DSDConversionMode Mode, int Channels = 0>
+    size_t convertDSD(uint8_t* dst, const uint8_t* src, size_t totalInputBytes,
+                      int numChannels, size_t channelStride = 0) {
+        if constexpr (Mode == DSDConversionMode::BitReverseOnly) {
+            return convertDSD_BitReverse<Channels>(dst, src, totalInputBytes, numChannels, channelStride);
+        } else if constexpr (Mode == DSDConversionMode::ByteSwapOnly) {
+            return convertDSD_ByteSwap<Channels>(dst, src, totalInputBytes, numChannels, channelStride);
+        } else if constexpr (Mode == DSDConversionMode::BitReverseAndSwap) {
+            return convertDSD_BitReverseSwap<Channels>(dst, src, totalInputBytes, numChannels, channelStride);
+        } else {
+            return convertDSD_Passthrough<Channels>(dst, src, totalInputBytes, numChannels, channelStride);
+        }
     }
 
     //=========================================================================
@@ -505,10 +662,14 @@ public:
      * Convert S24_P32 to packed 24-bit using AVX2
      * Input: 4 bytes per sample (24-bit in 32-bit container)
      * Output: 3 bytes per sample (packed)
+     * wordOr: if set, OR-ed with every input word (silence and S24 alignment
+     *         detection come out of the same pass)
      * Returns: number of output bytes written
      */
-    size_t convert24BitPacked_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert24BitPacked_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                                    uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
+        __m256i orAcc = _mm256_setzero_si256();
 
         static const __m256i shuffle_mask = _mm256_setr_epi8(
             0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
@@ -522,6 +683,7 @@ public:
             }
 
             __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            orAcc = _mm256_or_si256(orAcc, in);
             __m256i shuffled = _mm256_shuffle_epi8(in, shuffle_mask);
 
             __m128i lo = _mm256_castsi256_si128(shuffled);
@@ -547,12 +709,27 @@ public:
             outputBytes += 3;
         }
 
+        if (wordOr) {
+            __m128i v = _mm_or_si128(_mm256_castsi256_si128(orAcc), _mm256_extracti128_si256(orAcc, 1));
+            v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+            v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+            uint32_t acc = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+            for (size_t j = numSamples & ~size_t{7}; j < numSamples; j++) {
+                uint32_t word;
+                std::memcpy(&word, src + j * 4, 4);
+                acc |= word;
+            }
+            *wordOr |= acc;
+        }
+
         _mm256_zeroupper();
         return outputBytes;
     }
 
-    size_t convert24BitPackedShifted_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert24BitPackedShifted_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                                           uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
+        __m256i orAcc = _mm256_setzero_si256();
 
         static const __m256i shuffle_mask = _mm256_setr_epi8(
             1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1,
@@ -566,6 +743,7 @@ public:
             }
 
             __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            orAcc = _mm256_or_si256(orAcc, in);
             __m256i shuffled = _mm256_shuffle_epi8(in, shuffle_mask);
 
             __m128i lo = _mm256_castsi256_si128(shuffled);
@@ -591,6 +769,19 @@ public:
             outputBytes += 3;
         }
 
+        if (wordOr) {
+            __m128i v = _mm_or_si128(_mm256_castsi256_si128(orAcc), _mm256_extracti128_si256(orAcc, 1));
+            v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+            v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+            uint32_t acc = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+            for (size_t j = numSamples & ~size_t{7}; j < numSamples; j++) {
+                uint32_t word;
+                std::memcpy(&word, src + j * 4, 4);
+                acc |= word;
+            }
+            *wordOr |= acc;
+        }
+
         _mm256_zeroupper();
         return outputBytes;
     }
@@ -599,15 +790,19 @@ public:
      * Convert 16-bit to 32-bit using AVX2
      * Input: 2 bytes per sample (16-bit)
      * Output: 4 bytes per sample (16-bit value in upper 16 bits)
+     * wordOr: if set, OR-ed with every input sample (0 stays 0 for silence)
      * Returns: number of output bytes written
      */
-    size_t convert16To32_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert16To32_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                              uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
+        __m256i orAcc = _mm256_setzero_si256();
 
         size_t i = 0;
         for (; i + 16 <= numSamples; i += 16) {
             __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2));
             __m256i zero = _mm256_setzero_si256();
+            orAcc = _mm256_or_si256(orAcc, in);
 
             __m256i lo = _mm256_unpacklo_epi16(zero, in);
             __m256i hi = _mm256_unpackhi_epi16(zero, in);
@@ -629,6 +824,17 @@ public:
             outputBytes += 4;
         }
 
+        if (wordOr) {
+            __m128i v = _mm_or_si128(_mm256_castsi256_si128(orAcc), _mm256_extracti128_si256(orAcc, 1));
+            v = _mm_or_si128(v, _mm_srli_si128(v, 8));
+            v = _mm_or_si128(v, _mm_srli_si128(v, 4));
+            uint32_t acc = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+            for (size_t j = numSamples & ~size_t{15}; j < numSamples; j++) {
+                acc |= static_cast<uint32_t>(src[j * 2]) | static_cast<uint32_t>(src[j * 2 + 1]) << 8;
+            }
+            *wordOr |= acc;
+        }
+
         _mm256_zeroupper();
         return outputBytes;
     }
@@ -642,140 +848,218 @@ public:
      * Note: AVX2 shuffle for 3-byte output is complex, scalar is efficient enough
      * for this relatively rare case (16-bit input to 24-bit-only sink)
      */
-    size_t convert16To24(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert16To24(uint8_t* dst, const uint8_t* src, size_t numSamples, uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
+        uint32_t acc = 0;
         for (size_t i = 0; i < numSamples; i++) {
             dst[outputBytes + 0] = 0x00;              // padding (LSB)
             dst[outputBytes + 1] = src[i * 2 + 0];    // 16-bit LSB
             dst[outputBytes + 2] = src[i * 2 + 1];    // 16-bit MSB
+            acc |= static_cast<uint32_t>(src[i * 2]) | static_cast<uint32_t>(src[i * 2 + 1]) << 8;
             outputBytes += 3;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
 #elif DIRETTA_HAS_NEON // ARM64 NEON implementations
 
-    size_t convert24BitPacked_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    // OR of the 16 bytes of v
+    static uint32_t orBytes_NEON(uint8x16_t v) {
+        uint64x2_t q = vreinterpretq_u64_u8(v);
+        uint64_t x = vgetq_lane_u64(q, 0) | vgetq_lane_u64(q, 1);
+        x |= x >> 32;
+        x |= x >> 16;
+        x |= x >> 8;
+        return static_cast<uint32_t>(x & 0xFF);
+    }
+
+    // OR of the 8 halfwords of v
+    static uint32_t orHalfwords_NEON(uint16x8_t v) {
+        uint64x2_t q = vreinterpretq_u64_u16(v);
+        uint64_t x = vgetq_lane_u64(q, 0) | vgetq_lane_u64(q, 1);
+        x |= x >> 32;
+        x |= x >> 16;
+        return static_cast<uint32_t>(x & 0xFFFF);
+    }
+
+    size_t convert24BitPacked_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                                    uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
         size_t i = 0;
+        // One accumulator per byte position (vld4 de-interleaves them)
+        uint8x16_t or0 = vdupq_n_u8(0), or1 = vdupq_n_u8(0), or2 = vdupq_n_u8(0), or3 = vdupq_n_u8(0);
         for (; i + 16 <= numSamples; i += 16) {
             uint8x16x4_t in = vld4q_u8(src + i * 4);
+            or0 = vorrq_u8(or0, in.val[0]);
+            or1 = vorrq_u8(or1, in.val[1]);
+            or2 = vorrq_u8(or2, in.val[2]);
+            or3 = vorrq_u8(or3, in.val[3]);
             uint8x16x3_t out = {{ in.val[0], in.val[1], in.val[2] }};
             vst3q_u8(dst + outputBytes, out);
             outputBytes += 48;
         }
+        uint32_t acc = orBytes_NEON(or0) | orBytes_NEON(or1) << 8 |
+                       orBytes_NEON(or2) << 16 | orBytes_NEON(or3) << 24;
         for (; i < numSamples; i++) {
             dst[outputBytes + 0] = src[i * 4 + 0];
             dst[outputBytes + 1] = src[i * 4 + 1];
             dst[outputBytes + 2] = src[i * 4 + 2];
+            acc |= static_cast<uint32_t>(src[i * 4 + 0]) | static_cast<uint32_t>(src[i * 4 + 1]) << 8 |
+                   static_cast<uint32_t>(src[i * 4 + 2]) << 16 | static_cast<uint32_t>(src[i * 4 + 3]) << 24;
             outputBytes += 3;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
-    size_t convert24BitPackedShifted_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert24BitPackedShifted_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                                           uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
         size_t i = 0;
+        // One accumulator per byte position (vld4 de-interleaves them)
+        uint8x16_t or0 = vdupq_n_u8(0), or1 = vdupq_n_u8(0), or2 = vdupq_n_u8(0), or3 = vdupq_n_u8(0);
         for (; i + 16 <= numSamples; i += 16) {
             uint8x16x4_t in = vld4q_u8(src + i * 4);
+            or0 = vorrq_u8(or0, in.val[0]);
+            or1 = vorrq_u8(or1, in.val[1]);
+            or2 = vorrq_u8(or2, in.val[2]);
+            or3 = vorrq_u8(or3, in.val[3]);
             uint8x16x3_t out = {{ in.val[1], in.val[2], in.val[3] }};
             vst3q_u8(dst + outputBytes, out);
             outputBytes += 48;
         }
+        uint32_t acc = orBytes_NEON(or0) | orBytes_NEON(or1) << 8 |
+                       orBytes_NEON(or2) << 16 | orBytes_NEON(or3) << 24;
         for (; i < numSamples; i++) {
             dst[outputBytes + 0] = src[i * 4 + 1];
             dst[outputBytes + 1] = src[i * 4 + 2];
             dst[outputBytes + 2] = src[i * 4 + 3];
+            acc |= static_cast<uint32_t>(src[i * 4 + 0]) | static_cast<uint32_t>(src[i * 4 + 1]) << 8 |
+                   static_cast<uint32_t>(src[i * 4 + 2]) << 16 | static_cast<uint32_t>(src[i * 4 + 3]) << 24;
             outputBytes += 3;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
-    size_t convert16To32_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert16To32_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                              uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
         size_t i = 0;
         uint16x8_t zero = vdupq_n_u16(0);
+        uint16x8_t orAcc = vdupq_n_u16(0);
         for (; i + 8 <= numSamples; i += 8) {
             uint16x8_t in = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i * 2));
+            orAcc = vorrq_u16(orAcc, in);
             uint16x8x2_t zipped = vzipq_u16(zero, in);
             vst1q_u8(dst + outputBytes, vreinterpretq_u8_u16(zipped.val[0]));
             outputBytes += 16;
             vst1q_u8(dst + outputBytes, vreinterpretq_u8_u16(zipped.val[1]));
             outputBytes += 16;
         }
+        uint32_t acc = orHalfwords_NEON(orAcc);
         for (; i < numSamples; i++) {
             dst[outputBytes + 0] = 0x00;
             dst[outputBytes + 1] = 0x00;
             dst[outputBytes + 2] = src[i * 2 + 0];
             dst[outputBytes + 3] = src[i * 2 + 1];
+            acc |= static_cast<uint32_t>(src[i * 2]) | static_cast<uint32_t>(src[i * 2 + 1]) << 8;
             outputBytes += 4;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
-    size_t convert16To24(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert16To24(uint8_t* dst, const uint8_t* src, size_t numSamples, uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
         size_t i = 0;
         uint8x16_t zero = vdupq_n_u8(0x00);
+        // One accumulator per byte position (vld2 de-interleaves them)
+        uint8x16_t orLo = vdupq_n_u8(0x00), orHi = vdupq_n_u8(0x00);
         for (; i + 16 <= numSamples; i += 16) {
             uint8x16x2_t in = vld2q_u8(src + i * 2);
+            orLo = vorrq_u8(orLo, in.val[0]);
+            orHi = vorrq_u8(orHi, in.val[1]);
             uint8x16x3_t out = {{ zero, in.val[0], in.val[1] }};
             vst3q_u8(dst + outputBytes, out);
             outputBytes += 48;
         }
+        uint32_t acc = orBytes_NEON(orLo) | orBytes_NEON(orHi) << 8;
         for (; i < numSamples; i++) {
             dst[outputBytes + 0] = 0x00;
             dst[outputBytes + 1] = src[i * 2 + 0];
             dst[outputBytes + 2] = src[i * 2 + 1];
+            acc |= static_cast<uint32_t>(src[i * 2]) | static_cast<uint32_t>(src[i * 2 + 1]) << 8;
             outputBytes += 3;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
 #else // Scalar implementations for other architectures (RISC-V, etc.)
 
-    size_t convert24BitPacked_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert24BitPacked_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                                    uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
+        uint32_t acc = 0;
         for (size_t i = 0; i < numSamples; i++) {
+            uint32_t word;
+            std::memcpy(&word, src + i * 4, 4);
+            acc |= word;
             dst[outputBytes + 0] = src[i * 4 + 0];
             dst[outputBytes + 1] = src[i * 4 + 1];
             dst[outputBytes + 2] = src[i * 4 + 2];
             outputBytes += 3;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
-    size_t convert24BitPackedShifted_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert24BitPackedShifted_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                                           uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
+        uint32_t acc = 0;
         for (size_t i = 0; i < numSamples; i++) {
+            uint32_t word;
+            std::memcpy(&word, src + i * 4, 4);
+            acc |= word;
             dst[outputBytes + 0] = src[i * 4 + 1];
             dst[outputBytes + 1] = src[i * 4 + 2];
             dst[outputBytes + 2] = src[i * 4 + 3];
             outputBytes += 3;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
-    size_t convert16To32_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert16To32_AVX2(uint8_t* dst, const uint8_t* src, size_t numSamples,
+                              uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
+        uint32_t acc = 0;
         for (size_t i = 0; i < numSamples; i++) {
             dst[outputBytes + 0] = 0x00;
             dst[outputBytes + 1] = 0x00;
             dst[outputBytes + 2] = src[i * 2 + 0];
             dst[outputBytes + 3] = src[i * 2 + 1];
+            acc |= static_cast<uint32_t>(src[i * 2]) | static_cast<uint32_t>(src[i * 2 + 1]) << 8;
             outputBytes += 4;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
-    size_t convert16To24(uint8_t* dst, const uint8_t* src, size_t numSamples) {
+    size_t convert16To24(uint8_t* dst, const uint8_t* src, size_t numSamples, uint32_t* wordOr = nullptr) {
         size_t outputBytes = 0;
+        uint32_t acc = 0;
         for (size_t i = 0; i < numSamples; i++) {
             dst[outputBytes + 0] = 0x00;
             dst[outputBytes + 1] = src[i * 2 + 0];
             dst[outputBytes + 2] = src[i * 2 + 1];
+            acc |= static_cast<uint32_t>(src[i * 2]) | static_cast<uint32_t>(src[i * 2 + 1]) << 8;
             outputBytes += 3;
         }
+        if (wordOr) *wordOr |= acc;
         return outputBytes;
     }
 
@@ -784,6 +1068,11 @@ public:
     //=========================================================================
     // Specialized DSD conversion functions - no per-iteration branch checks
     // Mode is determined at track open, eliminating runtime conditionals
+    //
+    // channelStride: distance between channel planes in src (0 = contiguous,
+    // totalInputBytes / numChannels), so a slice of a planar block can be
+    // converted on its own. Channels > 0 fixes the channel count at compile
+    // time (numChannels is then ignored).
     //=========================================================================
 
     /**
@@ -791,15 +1080,19 @@ public:
      * Used when source bit ordering matches target (DSF→LSB or DFF→MSB)
      * NO bit reversal, NO byte swap
      */
+    template <int Channels = 0>
     size_t convertDSD_Passthrough(uint8_t* dst, const uint8_t* src,
-                                   size_t totalInputBytes, int numChannels) {
+                                   size_t totalInputBytes, int numChannels,
+                                   size_t channelStride = 0) {
+        if (Channels > 0) numChannels = Channels;    // Folds the stereo branches below
         size_t bytesPerChannel = totalInputBytes / static_cast<size_t>(numChannels);
+        size_t stride = channelStride ? channelStride : bytesPerChannel;
         size_t outputBytes = 0;
 
 #if DIRETTA_HAS_AVX2
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 32 <= bytesPerChannel; i += 32) {
@@ -839,7 +1132,7 @@ public:
 #elif DIRETTA_HAS_NEON
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 16 <= bytesPerChannel; i += 16) {
@@ -874,7 +1167,7 @@ public:
         // Scalar fallback for non-SIMD or non-stereo
         for (size_t i = 0; i < bytesPerChannel; i += 4) {
             for (int ch = 0; ch < numChannels; ch++) {
-                size_t chOffset = static_cast<size_t>(ch) * bytesPerChannel;
+                size_t chOffset = static_cast<size_t>(ch) * stride;
                 dst[outputBytes++] = src[chOffset + i + 0];
                 dst[outputBytes++] = src[chOffset + i + 1];
                 dst[outputBytes++] = src[chOffset + i + 2];
@@ -888,15 +1181,19 @@ public:
      * DSD BitReverse: Apply bit reversal only (no byte swap)
      * Used for DSF→MSB or DFF→LSB target conversions
      */
+    template <int Channels = 0>
     size_t convertDSD_BitReverse(uint8_t* dst, const uint8_t* src,
-                                  size_t totalInputBytes, int numChannels) {
+                                  size_t totalInputBytes, int numChannels,
+                                   size_t channelStride = 0) {
+        if (Channels > 0) numChannels = Channels;    // Folds the stereo branches below
         size_t bytesPerChannel = totalInputBytes / static_cast<size_t>(numChannels);
+        size_t stride = channelStride ? channelStride : bytesPerChannel;
         size_t outputBytes = 0;
 
 #if DIRETTA_HAS_AVX2
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 32 <= bytesPerChannel; i += 32) {
@@ -939,7 +1236,7 @@ public:
 #elif DIRETTA_HAS_NEON
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 16 <= bytesPerChannel; i += 16) {
@@ -978,7 +1275,7 @@ public:
         // Scalar fallback with bit reversal (using class-scope LUT)
         for (size_t i = 0; i < bytesPerChannel; i += 4) {
             for (int ch = 0; ch < numChannels; ch++) {
-                size_t chOffset = static_cast<size_t>(ch) * bytesPerChannel;
+                size_t chOffset = static_cast<size_t>(ch) * stride;
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 0]];
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 1]];
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 2]];
@@ -992,15 +1289,19 @@ public:
      * DSD ByteSwap: Apply byte swap only (no bit reversal)
      * Used for endianness conversion
      */
+    template <int Channels = 0>
     size_t convertDSD_ByteSwap(uint8_t* dst, const uint8_t* src,
-                                size_t totalInputBytes, int numChannels) {
+                                size_t totalInputBytes, int numChannels,
+                                   size_t channelStride = 0) {
+        if (Channels > 0) numChannels = Channels;    // Folds the stereo branches below
         size_t bytesPerChannel = totalInputBytes / static_cast<size_t>(numChannels);
+        size_t stride = channelStride ? channelStride : bytesPerChannel;
         size_t outputBytes = 0;
 
 #if DIRETTA_HAS_AVX2
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             static const __m256i byteswap_mask = _mm256_setr_epi8(
                 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
@@ -1048,7 +1349,7 @@ public:
 #elif DIRETTA_HAS_NEON
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 16 <= bytesPerChannel; i += 16) {
@@ -1087,7 +1388,7 @@ public:
         // Scalar fallback with byte swap
         for (size_t i = 0; i < bytesPerChannel; i += 4) {
             for (int ch = 0; ch < numChannels; ch++) {
-                size_t chOffset = static_cast<size_t>(ch) * bytesPerChannel;
+                size_t chOffset = static_cast<size_t>(ch) * stride;
                 dst[outputBytes++] = src[chOffset + i + 3];
                 dst[outputBytes++] = src[chOffset + i + 2];
                 dst[outputBytes++] = src[chOffset + i + 1];
@@ -1101,15 +1402,19 @@ public:
      * DSD BitReverse + ByteSwap: Apply both operations
      * Used when both bit reversal and endianness conversion are needed
      */
+    template <int Channels = 0>
     size_t convertDSD_BitReverseSwap(uint8_t* dst, const uint8_t* src,
-                                      size_t totalInputBytes, int numChannels) {
+                                      size_t totalInputBytes, int numChannels,
+                                   size_t channelStride = 0) {
+        if (Channels > 0) numChannels = Channels;    // Folds the stereo branches below
         size_t bytesPerChannel = totalInputBytes / static_cast<size_t>(numChannels);
+        size_t stride = channelStride ? channelStride : bytesPerChannel;
         size_t outputBytes = 0;
 
 #if DIRETTA_HAS_AVX2
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             static const __m256i byteswap_mask = _mm256_setr_epi8(
                 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
@@ -1159,7 +1464,7 @@ public:
 #elif DIRETTA_HAS_NEON
         if (numChannels == 2) {
             const uint8_t* srcL = src;
-            const uint8_t* srcR = src + bytesPerChannel;
+            const uint8_t* srcR = src + stride;
 
             size_t i = 0;
             for (; i + 16 <= bytesPerChannel; i += 16) {
@@ -1202,7 +1507,7 @@ public:
         // Scalar fallback with bit reversal + byte swap (using class-scope LUT)
         for (size_t i = 0; i < bytesPerChannel; i += 4) {
             for (int ch = 0; ch < numChannels; ch++) {
-                size_t chOffset = static_cast<size_t>(ch) * bytesPerChannel;
+                size_t chOffset = static_cast<size_t>(ch) * stride;
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 3]];
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 2]];
                 dst[outputBytes++] = kBitReverseLUT[src[chOffset + i + 1]];
@@ -1216,41 +1521,226 @@ public:
     // Pop method (read from buffer)
     //=========================================================================
 
+    using PopCopyFn = void (*)(uint8_t* dst, const uint8_t* src);
+
+    /**
+     * @brief Specialise pop() for the consumer's per-cycle buffer size
+     *
+     * getNewStream() pops the same bytesPerBuffer every cycle (44.1k family:
+     * one frame more every few cycles, the alternate size). A copy compiled
+     * for exactly that size has no size dispatch, alignment branches or
+     * prefetch heuristics, so its timing barely varies. Other sizes and
+     * wrapped pops use memcpy_audio_fixed. 0 restores the generic path.
+     *
+     * The sizes are plain fields read by pop() without synchronisation: only
+     * call this while no thread is in pop() or a tap read (DirettaSync holds
+     * its ReconfigureGuard, as for resize()).
+     * @return true if an exact-size copy exists for bytes
+     */
+    bool setConsumerBufferSize(size_t bytes, size_t alternateBytes = 0) {
+        popBytes_ = bytes;
+        popCopy_ = exactCopyFor(bytes);
+        popAltBytes_ = alternateBytes;
+        popAltCopy_ = exactCopyFor(alternateBytes);
+        return popCopy_ != nullptr;
+    }
+
+    /**
+     * Per-cycle (1 ms) buffer sizes of stereo formats with an exact-size pop
+     * copy, 44.1k family with its one-frame-longer variant: 16-bit 44.1k/48k,
+     * 24-bit 44.1k-96k, 32-bit 44.1k-768k, DSD64-DSD1024 (DirettaSync.cpp
+     * checks at compile time that these cover its buffer sizes)
+     */
+    static constexpr size_t EXACT_POP_SIZES[] = {
+        176, 180, 192,                                  // 16-bit
+        264, 270, 288, 528, 534, 576,                   // 24-bit
+        352, 360, 384, 704, 712, 768, 1408, 1416, 1536, // 32-bit, DSD64 (704), DSD128 (1416)
+        2816, 2824, 3072, 5640, 5648, 6144,             // 32-bit, DSD256 (2824), DSD512 (5648)
+        11288, 12288                                    // DSD1024
+    };
+
+    static constexpr bool hasExactPop(size_t bytes) {
+        for (size_t size : EXACT_POP_SIZES) {
+            if (size == bytes) return true;
+        }
+        return false;
+    }
+
     /**
      * @brief Pop data from buffer
      */
     size_t pop(uint8_t* dest, size_t len) {
+        return popFrom(readPos_, dest, len);
+    }
+
+    //=========================================================================
+    // Taps: additional readers of the same stream (fan-out)
+    //=========================================================================
+
+    static constexpr int MAX_TAPS = 7;
+
+    /**
+     * @brief Allocate a tap: one more consumer with its own read position
+     *
+     * An active tap reads the same bytes as the primary reader (pop()),
+     * without a copy into a ring of its own, and the producer never
+     * overtakes the slowest active reader. Taps start inactive and are
+     * deactivated by clear()/resize(). Call before playback starts.
+     * @return Tap id, or -1 if MAX_TAPS are in use
+     */
+    int addTap() {
+        if (tapCount_ >= MAX_TAPS) return -1;
+        return tapCount_++;
+    }
+
+    /**
+     * @brief Activate a tap at the primary reader's position (or move an
+     *        active one there), so both read the same byte next
+     */
+    void joinTap(int id) {
+        taps_[id].pos.store(readPos_.load(std::memory_order_acquire), std::memory_order_release);
+        if (!taps_[id].active.exchange(true, std::memory_order_acq_rel)) {
+            activeTaps_.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
+    /**
+     * @brief Deactivate a tap: it no longer holds the producer back
+     */
+    void leaveTap(int id) {
+        if (taps_[id].active.exchange(false, std::memory_order_acq_rel)) {
+            activeTaps_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    bool tapActive(int id) const { return taps_[id].active.load(std::memory_order_acquire); }
+
+    size_t tapAvailable(int id) const {
+        if (size_ == 0) return 0;
+        size_t wp = writePos_.load(std::memory_order_acquire);
+        size_t tp = taps_[id].pos.load(std::memory_order_acquire);
+        return (wp - tp) & mask_;
+    }
+
+    size_t tapPop(int id, uint8_t* dest, size_t len) {
+        return popFrom(taps_[id].pos, dest, len);
+    }
+
+    /**
+     * @brief Bytes the tap is behind the primary reader (negative: ahead)
+     */
+    long tapLag(int id) const {
         if (size_ == 0) return 0;
-        size_t avail = getAvailable();
+        size_t rp = readPos_.load(std::memory_order_acquire);
+        size_t tp = taps_[id].pos.load(std::memory_order_acquire);
+        size_t behind = (rp - tp) & mask_;
+        return behind <= size_ / 2 ? static_cast<long>(behind)
+                                   : -static_cast<long>(size_ - behind);
+    }
+
+    uint8_t* data() { return buffer_; }
+    const uint8_t* data() const { return buffer_; }
+
+private:
+    size_t popFrom(std::atomic<size_t>& cursor, uint8_t* dest, size_t len) {
+        if (size_ == 0) return 0;
+        size_t rp = cursor.load(std::memory_order_acquire);
+        size_t avail = (writePos_.load(std::memory_order_acquire) - rp) & mask_;
         if (len > avail) len = avail;
         if (len == 0) return 0;
 
-        size_t rp = readPos_.load(std::memory_order_acquire);
         size_t firstChunk = std::min(len, size_ - rp);
 
-        memcpy_audio(dest, buffer_.data() + rp, firstChunk);
-        if (firstChunk < len) {
-            memcpy_audio(dest + firstChunk, buffer_.data(), len - firstChunk);
+        if (popBytes_ != 0) {
+            // Consumer path: fixed-shape copies only
+            if (firstChunk == len && len == popBytes_ && popCopy_) {
+                popCopy_(dest, buffer_ + rp);
+            } else if (firstChunk == len && len == popAltBytes_ && popAltCopy_) {
+                popAltCopy_(dest, buffer_ + rp);
+            } else {
+                memcpy_audio_fixed(dest, buffer_ + rp, firstChunk);
+                if (firstChunk < len) {
+                    memcpy_audio_fixed(dest + firstChunk, buffer_, len - firstChunk);
+                }
+            }
+        } else {
+            memcpy_audio(dest, buffer_ + rp, firstChunk);
+            if (firstChunk < len) {
+                memcpy_audio(dest + firstChunk, buffer_, len - firstChunk);
+            }
         }
 
-        readPos_.store((rp + len) & mask_, std::memory_order_release);
+        size_t newReadPos = (rp + len) & mask_;
+        cursor.store(newReadPos, std::memory_order_release);
+
+        // Streamed writes live in DRAM: start fetching the next buffer now,
+        // one period before it is needed
+        if (streamThreshold_ != SIZE_MAX) {
+            prefetch_audio_range(buffer_ + newReadPos, std::min(len, size_ - newReadPos));
+        }
         return len;
     }
 
-    uint8_t* data() { return buffer_.data(); }
-    const uint8_t* data() const { return buffer_.data(); }
+    /**
+     * Position the producer must not overtake: the primary reader's, or the
+     * active tap furthest behind the writer
+     */
+    size_t producerReadPos(size_t wp) const {
+        size_t rp = readPos_.load(std::memory_order_acquire);
+        if (activeTaps_.load(std::memory_order_acquire) == 0) return rp;
+
+        size_t behind = (wp - rp) & mask_;
+        for (int i = 0; i < tapCount_; i++) {
+            if (!taps_[i].active.load(std::memory_order_acquire)) continue;
+            size_t tp = taps_[i].pos.load(std::memory_order_acquire);
+            size_t tapBehind = (wp - tp) & mask_;
+            if (tapBehind > behind) {
+                behind = tapBehind;
+                rp = tp;
+            }
+        }
+        return rp;
+    }
+
+    /**
+     * @brief Convert through the pool and commit in one step
+     *
+     * Slices go straight into the ring when the output fits before the wrap
+     * point, otherwise into staging (copied in by writeToRing). The caller
+     * has already limited units to the free space.
+     *
+     * @param convert convert(out, beginUnit, endUnit) writes the output of
+     *                those units at out
+     * @return Bytes written to the ring
+     */
+    template <typename Convert>
+    size_t pushConverted(uint8_t* staging, size_t units, size_t unitIn, size_t unitOut,
+                         size_t unitAlign, Convert&& convert) {
+        size_t outBytes = units * unitOut;
+        uint8_t* region;
+        size_t available;
+        bool direct = getDirectWriteRegion(outBytes, region, available);
+        uint8_t* dst = direct ? region : staging;
+
+        auto slice = [&](size_t begin, size_t end) { convert(dst + begin * unitOut, begin, end); };
+        convertPool_->run(slice, units, unitIn, unitAlign);
+
+        if (!direct) return writeToRing(staging, outBytes);
+        countWrite(outBytes, false);
+        commitDirectWrite(outBytes);
+        return outBytes;
+    }
 
-private:
     /**
      * Write staged data to ring buffer with efficient wraparound handling
      * Uses memcpy_audio_fixed for consistent timing
      */
     size_t writeToRing(const uint8_t* staged, size_t len) {
-        size_t size = buffer_.size();
+        size_t size = size_;
         if (size == 0 || len == 0) return 0;
 
         size_t writePos = writePos_.load(std::memory_order_relaxed);
-        size_t readPos = readPos_.load(std::memory_order_acquire);
+        size_t readPos = producerReadPos(writePos);
 
         size_t available = (readPos > writePos)
             ? (readPos - writePos - 1)
@@ -1261,17 +1751,27 @@ private:
         }
         if (len == 0) return 0;
 
-        uint8_t* ring = buffer_.data();
+        uint8_t* ring = buffer_;
         size_t firstChunk = std::min(len, size - writePos);
+        bool stream = useStreamingStores(size - 1 - available, len);
 
         if (firstChunk > 0) {
-            memcpy_audio_fixed(ring + writePos, staged, firstChunk);
+            if (stream) {
+                memcpy_audio_stream(ring + writePos, staged, firstChunk);
+            } else {
+                memcpy_audio_fixed(ring + writePos, staged, firstChunk);
+            }
         }
 
         size_t secondChunk = len - firstChunk;
         if (secondChunk > 0) {
-            memcpy_audio_fixed(ring, staged + firstChunk, secondChunk);
+            if (stream) {
+                memcpy_audio_stream(ring, staged + firstChunk, secondChunk);
+            } else {
+                memcpy_audio_fixed(ring, staged + firstChunk, secondChunk);
+            }
         }
+        countWrite(len, stream);
 
         size_t newWritePos = (writePos + len) & mask_;
         writePos_.store(newWritePos, std::memory_order_release);
@@ -1279,6 +1779,97 @@ private:
         return len;
     }
 
+    /**
+     * Copy of exactly N bytes: constant trip count, overlapping last vector
+     * for the tail, no branches on size or alignment
+     */
+    template <size_t N>
+    static void copyExact(uint8_t* dst, const uint8_t* src) {
+#if DIRETTA_HAS_AVX2
+        static_assert(N >= 32, "exact copies are for whole audio buffers");
+        #pragma GCC unroll 8
+        for (size_t i = 0; i < N / 32; i++) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 32),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 32)));
+        }
+        if constexpr (N % 32 != 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + N - 32),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + N - 32)));
+        }
+        _mm256_zeroupper();
+#elif DIRETTA_HAS_NEON
+        static_assert(N >= 16, "exact copies are for whole audio buffers");
+        #pragma GCC unroll 8
+        for (size_t i = 0; i < N / 16; i++) {
+            vst1q_u8(dst + i * 16, vld1q_u8(src + i * 16));
+        }
+        if constexpr (N % 16 != 0) {
+            vst1q_u8(dst + N - 16, vld1q_u8(src + N - 16));
+        }
+#else
+        std::memcpy(dst, src, N);    // Constant size: expanded inline by the compiler
+#endif
+    }
+
+    template <size_t... I>
+    static PopCopyFn exactCopyIn(size_t bytes, std::index_sequence<I...>) {
+        PopCopyFn fn = nullptr;
+        (void)((bytes == EXACT_POP_SIZES[I] && (fn = &copyExact<EXACT_POP_SIZES[I]>, true)) || ...);
+        return fn;
+    }
+
+    static PopCopyFn exactCopyFor(size_t bytes) {
+        constexpr size_t count = sizeof(EXACT_POP_SIZES) / sizeof(EXACT_POP_SIZES[0]);
+        return exactCopyIn(bytes, std::make_index_sequence<count>{});
+    }
+
+    /**
+     * Streaming stores when the bytes queued ahead of the reader (fill) plus
+     * this write exceed the threshold; small writes are not worth the fence
+     */
+    bool useStreamingStores(size_t fill, size_t len) const {
+        return len >= STREAM_MIN_BYTES && fill + len > streamThreshold_;
+    }
+
+    // push() with the content scan folded into the copy: each block is
+    // OR-reduced just before it is copied, so the copy reads it from L1
+    // instead of the input being walked again after the push. Blocks start
+    // on input word boundaries, so the result equals or_reduce_audio(data, len).
+    size_t pushScanned(const uint8_t* data, size_t len, bool stream, uint32_t* contentOr) {
+        size_t wp = writePos_.load(std::memory_order_acquire);
+        uint32_t acc = 0;
+        for (size_t done = 0; done < len; done += SCAN_BLOCK_BYTES) {
+            size_t n = std::min(SCAN_BLOCK_BYTES, len - done);
+            acc |= or_reduce_audio(data + done, n);
+            size_t pos = (wp + done) & mask_;
+            size_t first = std::min(n, size_ - pos);
+            copyIn(buffer_ + pos, data + done, first, stream);
+            if (first < n) {
+                copyIn(buffer_, data + done + first, n - first, stream);
+            }
+        }
+        *contentOr |= acc;
+        writePos_.store((wp + len) & mask_, std::memory_order_release);
+        return len;
+    }
+
+    void copyIn(uint8_t* dst, const uint8_t* src, size_t len, bool stream) {
+        if (stream) {
+            memcpy_audio_stream(dst, src, len);
+        } else {
+            memcpy_audio(dst, src, len);
+        }
+        countWrite(len, stream);
+    }
+
+    // Producer-only counters (read by stats)
+    void countWrite(size_t len, bool stream) {
+        writtenBytes_.store(writtenBytes_.load(std::memory_order_relaxed) + len, std::memory_order_relaxed);
+        if (stream) {
+            streamedBytes_.store(streamedBytes_.load(std::memory_order_relaxed) + len, std::memory_order_relaxed);
+        }
+    }
+
 #if DIRETTA_HAS_AVX2
     static __m256i simd_bit_reverse(__m256i x) {
         static const __m256i nibble_reverse = _mm256_setr_epi8(
@@ -1340,13 +1931,34 @@ private:
     alignas(64) uint8_t m_stagingDSD[STAGING_SIZE];
 
     static constexpr size_t kRingAlignment = 64;
+    static constexpr size_t STREAM_MIN_BYTES = 1024;
+    static constexpr size_t SCAN_BLOCK_BYTES = 8192;   // pushScanned(): well inside L1
 
-    std::vector<uint8_t, AlignedAllocator<uint8_t, kRingAlignment>> buffer_;
+    std::vector<uint8_t, AlignedAllocator<uint8_t, kRingAlignment>> ownedBuffer_;
+    uint8_t* buffer_ = nullptr;     // ownedBuffer_ or attached storage
+    size_t capacity_ = 0;
     size_t size_ = 0;
     size_t mask_ = 0;
     alignas(64) std::atomic<size_t> writePos_{0};
     alignas(64) std::atomic<size_t> readPos_{0};
+
+    struct alignas(64) Tap {
+        std::atomic<size_t> pos{0};
+        std::atomic<bool> active{false};
+    };
+    Tap taps_[MAX_TAPS];
+    int tapCount_ = 0;                  // Allocated taps (never shrinks)
+    std::atomic<int> activeTaps_{0};    // 0: producer checks readPos_ only
+
     std::atomic<uint8_t> silenceByte_{0};
+    size_t streamThreshold_ = SIZE_MAX;
+    ConvertPool* convertPool_ = nullptr;
+    size_t popBytes_ = 0;               // Consumer buffer size, 0 = generic pop()
+    size_t popAltBytes_ = 0;
+    PopCopyFn popCopy_ = nullptr;
+    PopCopyFn popAltCopy_ = nullptr;
+    std::atomic<uint64_t> writtenBytes_{0};
+    std::atomic<uint64_t> streamedBytes_{0};
 
 public:
     // S24 pack mode detection - determines byte alignment of 24-bit samples in 32-bit containers
@@ -1375,24 +1987,26 @@ public:
 
 private:
     /**
-     * Detect S24 pack mode by examining sample data
+     * Detect S24 pack mode from the first S24_DETECT_SAMPLES samples of a
+     * chunk (probeS24Lanes ORs their LSB and MSB bytes)
      *
      * Checks both LSB (byte 0) and MSB (byte 3) positions:
      * - LSB-aligned: data in bytes 0-2, byte 3 is zero (standard S24_LE)
      * - MSB-aligned: data in bytes 1-3, byte 0 is zero (left-justified)
      * - Deferred: all samples are zero (silence) - cannot determine
      */
-    S24PackMode detectS24PackMode(const uint8_t* data, size_t numSamples) const {
-        size_t checkSamples = std::min<size_t>(numSamples, 64);
-        bool allZeroLSB = true;
-        bool allZeroMSB = true;
-
+    static uint32_t probeS24Lanes(const uint8_t* data, size_t numSamples) {
+        size_t checkSamples = std::min(numSamples, S24_DETECT_SAMPLES);
+        uint32_t lanes = 0;
         for (size_t i = 0; i < checkSamples; i++) {
-            uint8_t b0 = data[i * 4];       // LSB position
-            uint8_t b3 = data[i * 4 + 3];   // MSB position
-            if (b0 != 0x00) allZeroLSB = false;
-            if (b3 != 0x00) allZeroMSB = false;
+            lanes |= static_cast<uint32_t>(data[i * 4]) | static_cast<uint32_t>(data[i * 4 + 3]) << 24;
         }
+        return lanes;
+    }
+
+    static S24PackMode s24PackModeFromLanes(uint32_t lanes) {
+        bool allZeroLSB = (lanes & 0x000000FFu) == 0;    // LSB position
+        bool allZeroMSB = (lanes & 0xFF000000u) == 0;    // MSB position
 
         if (!allZeroLSB && allZeroMSB) {
             return S24PackMode::LsbAligned;  // Data in LSB, MSB is padding
@@ -1407,11 +2021,38 @@ private:
         return S24PackMode::Deferred;
     }
 
+    void updateS24Detection(uint32_t lanes, size_t numSamples) {
+        S24PackMode detected = s24PackModeFromLanes(lanes);
+        if (detected != S24PackMode::Deferred) {
+            // Sample detection found definitive result - use it
+            m_s24PackMode = detected;
+            m_s24DetectionConfirmed = true;
+            m_deferredSampleCount = 0;
+        } else {
+            // Still silence - accumulate count for timeout
+            m_deferredSampleCount += numSamples;
+            // Timeout: if still silent after threshold, use hint or default to LSB
+            if (m_deferredSampleCount > DEFERRED_TIMEOUT_SAMPLES) {
+                m_s24PackMode = (m_s24Hint != S24PackMode::Unknown) ? m_s24Hint : S24PackMode::LsbAligned;
+                m_s24DetectionConfirmed = true;
+            }
+        }
+    }
+
+    // Deferred/Unknown use hint or LSB as fallback
+    S24PackMode effectiveS24PackMode() const {
+        if (m_s24PackMode == S24PackMode::Deferred || m_s24PackMode == S24PackMode::Unknown) {
+            return (m_s24Hint != S24PackMode::Unknown) ? m_s24Hint : S24PackMode::LsbAligned;
+        }
+        return m_s24PackMode;
+    }
+
     S24PackMode m_s24PackMode = S24PackMode::Unknown;
     S24PackMode m_s24Hint = S24PackMode::Unknown;
     bool m_s24DetectionConfirmed = false;
     size_t m_deferredSampleCount = 0;
     static constexpr size_t DEFERRED_TIMEOUT_SAMPLES = 48000;  // ~1 second at 48kHz
+    static constexpr size_t S24_DETECT_SAMPLES = 64;
 };
 
 #endif // DIRETTA_RING_BUFFER_H
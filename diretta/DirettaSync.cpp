@@ -7,10 +7,19 @@
  */
 
 #include "DirettaSync.h"
+#include "MemoryLock.h"
+#include "RtAudit.h"
+#include "CpuInfo.h"
+#include <cassert>
 #include <stdexcept>
 #include <iomanip>
-#include <pthread.h>
+#include <future>
+#include <cerrno>
 #include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <linux/perf_event.h>
 
 namespace {
 
@@ -28,29 +37,68 @@ bool interruptibleWait(std::mutex& mutex, std::condition_variable& cv,
     return !interrupted;  // Return true if timeout (normal), false if interrupted
 }
 
-// F1: Worker thread priority elevation for reduced jitter
-// Sets SCHED_FIFO real-time priority (requires root on Linux)
-// Returns true on success, false on failure (logs warning but continues)
-bool setRealtimePriority(int priority = 50) {
-    struct sched_param param;
-    param.sched_priority = priority;
+int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
 
-    int ret = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
-    if (ret != 0) {
-        // Not fatal - may not have CAP_SYS_NICE or running as non-root
-        if (g_verbose) {
-            std::cerr << "[DirettaSync] Warning: Could not set SCHED_FIFO priority "
-                      << priority << " (error " << ret << ")" << std::endl;
-        }
-        return false;
+int64_t threadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// Sleep until an absolute CLOCK_MONOTONIC time (no drift from loop overhead)
+void sleepUntilNs(int64_t deadlineNs) {
+    struct timespec ts;
+    ts.tv_sec = deadlineNs / 1000000000LL;
+    ts.tv_nsec = deadlineNs % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+}
+
+// Bytes the SDK pops per 1 ms cycle (44.1k family: one frame more every
+// few cycles, the second size)
+constexpr size_t pcmBufferBytes(uint32_t rate, int channels, int bytesPerSample) {
+    return static_cast<size_t>(rate / 1000) * channels * bytesPerSample;
+}
+
+constexpr size_t dsdBufferBytes(uint32_t byteRate, int channels) {
+    size_t bytes = static_cast<size_t>(byteRate / 1000) * channels;
+    bytes = (bytes + (4 * channels - 1)) / (4 * channels) * (4 * channels);
+    return bytes < 64 ? 64 : bytes;
+}
+
+// The formats DirettaRingBuffer::EXACT_POP_SIZES claims to cover (stereo)
+constexpr bool pcmHasExactPop(uint32_t rate, int bytesPerSample) {
+    size_t bytes = pcmBufferBytes(rate, 2, bytesPerSample);
+    return DirettaRingBuffer::hasExactPop(bytes) &&
+           (rate % 1000 == 0 || DirettaRingBuffer::hasExactPop(bytes + 2 * bytesPerSample));
+}
+
+constexpr bool pcmFamilyHasExactPop(uint32_t baseRate, uint32_t maxRate, int bytesPerSample) {
+    for (uint32_t rate = baseRate; rate <= maxRate; rate *= 2) {
+        if (!pcmHasExactPop(rate, bytesPerSample)) return false;
     }
+    return true;
+}
 
-    if (g_verbose) {
-        std::cout << "[DirettaSync] Worker thread set to SCHED_FIFO priority " << priority << std::endl;
+constexpr bool dsdHasExactPop(uint32_t dsd64ByteRate) {
+    for (uint32_t byteRate = dsd64ByteRate; byteRate <= dsd64ByteRate * 16; byteRate *= 2) {
+        if (!DirettaRingBuffer::hasExactPop(dsdBufferBytes(byteRate, 2))) return false;
     }
     return true;
 }
 
+static_assert(pcmFamilyHasExactPop(44100, 48000, 2) && pcmFamilyHasExactPop(48000, 48000, 2),
+              "exact pop sizes: 16-bit 44.1k/48k");
+static_assert(pcmFamilyHasExactPop(44100, 88200, 3) && pcmFamilyHasExactPop(48000, 96000, 3),
+              "exact pop sizes: 24-bit 44.1k-96k");
+static_assert(pcmFamilyHasExactPop(44100, 705600, 4) && pcmFamilyHasExactPop(48000, 768000, 4),
+              "exact pop sizes: 32-bit 44.1k-768k");
+static_assert(dsdHasExactPop(2822400 / 8) && dsdHasExactPop(3072000 / 8),
+              "exact pop sizes: DSD64-DSD1024");
+
 class RingAccessGuard {
 public:
     RingAccessGuard(std::atomic<int>& users, const std::atomic<bool>& reconfiguring)
@@ -81,6 +129,101 @@ private:
     std::atomic<int>& users_;
     bool active_;
 };
+
+//=============================================================================
+// Push pipelines
+//=============================================================================
+// One function per (conversion, channel layout), chosen once per format by
+// pushPipelineFor() so that sendAudio() makes a single indirect call instead
+// of walking the format flags. Channels = 2 lets the compiler fold the stereo
+// paths of the kernels; Channels = 0 takes the count at run time. The ISA
+// (AVX2/NEON/scalar) is fixed at build time.
+// numSamples: PCM frames, or DSD bits per channel. contentOr (optional)
+// collects the OR of the consumed input words from the pass that moves them
+// (packing, upsampling, or the copy, scanned block by block). DSD leaves it
+// alone: the caller's de-interleave already produced it.
+
+using DSDMode = DirettaRingBuffer::DSDConversionMode;
+using PushFn = size_t (*)(DirettaRingBuffer& ring, const uint8_t* data, size_t numSamples,
+                          int numChannels, int bytesPerSample, size_t& inputBytes, uint32_t* contentOr);
+
+struct PushPipeline {
+    PushFn push;
+    const char* label;
+};
+
+template <DSDMode Mode, int Channels>
+size_t pushDsd(DirettaRingBuffer& ring, const uint8_t* data, size_t numSamples,
+               int numChannels, int, size_t& inputBytes, uint32_t* contentOr) {
+    size_t channels = Channels > 0 ? Channels : static_cast<size_t>(numChannels);
+    inputBytes = (numSamples * channels) / 8;
+    (void)contentOr;    // The de-interleave that made the planar block has it
+    return ring.pushDSDPlanar<Mode, Channels>(data, inputBytes, numChannels);
+}
+
+template <int Channels>
+size_t pushPack24(DirettaRingBuffer& ring, const uint8_t* data, size_t numSamples,
+                  int numChannels, int, size_t& inputBytes, uint32_t* contentOr) {
+    size_t channels = Channels > 0 ? Channels : static_cast<size_t>(numChannels);
+    inputBytes = numSamples * 4 * channels;    // S24_P32
+    return ring.push24BitPacked(data, inputBytes, contentOr);
+}
+
+template <int Channels>
+size_t pushUpsample16To32(DirettaRingBuffer& ring, const uint8_t* data, size_t numSamples,
+                          int numChannels, int, size_t& inputBytes, uint32_t* contentOr) {
+    size_t channels = Channels > 0 ? Channels : static_cast<size_t>(numChannels);
+    inputBytes = numSamples * 2 * channels;
+    return ring.push16To32(data, inputBytes, contentOr);
+}
+
+template <int Channels>
+size_t pushUpsample16To24(DirettaRingBuffer& ring, const uint8_t* data, size_t numSamples,
+                          int numChannels, int, size_t& inputBytes, uint32_t* contentOr) {
+    size_t channels = Channels > 0 ? Channels : static_cast<size_t>(numChannels);
+    inputBytes = numSamples * 2 * channels;
+    return ring.push16To24(data, inputBytes, contentOr);
+}
+
+template <int Channels>
+size_t pushDirect(DirettaRingBuffer& ring, const uint8_t* data, size_t numSamples,
+                  int numChannels, int bytesPerSample, size_t& inputBytes, uint32_t* contentOr) {
+    size_t channels = Channels > 0 ? Channels : static_cast<size_t>(numChannels);
+    inputBytes = numSamples * static_cast<size_t>(bytesPerSample) * channels;
+    return ring.push(data, inputBytes, contentOr);
+}
+
+template <int Channels>
+PushPipeline dsdPipeline(DSDMode mode) {
+    switch (mode) {
+        case DSDMode::BitReverseOnly:
+            return {pushDsd<DSDMode::BitReverseOnly, Channels>, "DSD"};
+        case DSDMode::ByteSwapOnly:
+            return {pushDsd<DSDMode::ByteSwapOnly, Channels>, "DSD"};
+        case DSDMode::BitReverseAndSwap:
+            return {pushDsd<DSDMode::BitReverseAndSwap, Channels>, "DSD"};
+        case DSDMode::Passthrough:
+        default:
+            return {pushDsd<DSDMode::Passthrough, Channels>, "DSD"};
+    }
+}
+
+template <int Channels>
+PushPipeline pcmPipeline(int direttaBps, int inputBps) {
+    if (direttaBps == 3 && inputBps == 4) return {pushPack24<Channels>, "PCM24"};
+    if (direttaBps == 4 && inputBps == 2) return {pushUpsample16To32<Channels>, "PCM16->32"};
+    if (direttaBps == 3 && inputBps == 2) return {pushUpsample16To24<Channels>, "PCM16->24"};
+    return {pushDirect<Channels>, "PCM"};
+}
+
+PushPipeline dsdPushPipeline(DSDMode mode, int channels) {
+    return channels == 2 ? dsdPipeline<2>(mode) : dsdPipeline<0>(mode);
+}
+
+PushPipeline pcmPushPipeline(int channels, int direttaBps, int inputBps) {
+    return channels == 2 ? pcmPipeline<2>(direttaBps, inputBps) : pcmPipeline<0>(direttaBps, inputBps);
+}
+
 } // namespace
 
 //=============================================================================
@@ -89,11 +232,18 @@ private:
 
 DirettaSync::DirettaSync() {
     m_ringBuffer.resize(44100 * 2 * 4, 0x00);
+    PushPipeline pipeline = pcmPushPipeline(2, 2, 2);
+    m_pushFn.store(pipeline.push, std::memory_order_relaxed);
+    m_pushLabel.store(pipeline.label, std::memory_order_relaxed);
+    m_spaceEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
     DIRETTA_LOG("Created");
 }
 
 DirettaSync::~DirettaSync() {
     disable();
+    if (m_spaceEventFd >= 0) {
+        ::close(m_spaceEventFd);
+    }
     DIRETTA_LOG("Destroyed");
 }
 
@@ -108,8 +258,14 @@ bool DirettaSync::enable(const DirettaConfig& config) {
     }
 
     m_config = config;
+    m_workerCycleUs.store(m_config.cycleTime, std::memory_order_relaxed);
     DIRETTA_LOG("Enabling...");
 
+    allocateArena();
+    allocateSilenceBlocks();
+    configureStreamingStores();
+    m_ringBuffer.setConvertPool(m_config.convertPool);
+
     if (!discoverTarget()) {
         DIRETTA_LOG("Failed to discover target");
         return false;
@@ -119,6 +275,20 @@ bool DirettaSync::enable(const DirettaConfig& config) {
         DIRETTA_LOG("MTU measurement failed, using fallback");
     }
 
+    if (m_config.adaptiveBuffer) {
+        m_bufferLearning.open(m_config.stateDir, m_targetName);
+    }
+    if (m_config.adaptiveCycle) {
+        // A fixed transfer mode stays fixed: only the cycle time is tried
+        std::vector<int> modes;
+        if (m_config.transferMode == DirettaTransferMode::AUTO) {
+            modes = {static_cast<int>(DirettaTransferMode::FIX_AUTO), static_cast<int>(DirettaTransferMode::VAR_AUTO),
+                     static_cast<int>(DirettaTransferMode::VAR_MAX)};
+        }
+        m_cycleTuning.open(m_config.stateDir, m_targetName, m_config.adaptiveCycleMinUs,
+                           m_config.adaptiveCycleMaxUs, modes);
+    }
+
     m_calculator = std::make_unique<DirettaCycleCalculator>(m_effectiveMTU);
 
     // Note: SDK connection is NOT opened here — it will be opened lazily
@@ -222,15 +392,18 @@ bool DirettaSync::discoverTarget() {
     if (results.size() == 1 || m_targetIndex == 0) {
         auto it = results.begin();
         m_targetAddress = it->first;
+        m_targetName = it->second.targetName;
         DIRETTA_LOG("Selected: " << it->second.targetName);
     } else if (m_targetIndex > 0 && m_targetIndex < static_cast<int>(results.size())) {
         auto it = results.begin();
         std::advance(it, m_targetIndex);
         m_targetAddress = it->first;
+        m_targetName = it->second.targetName;
         DIRETTA_LOG("Selected target #" << (m_targetIndex + 1));
     } else {
         auto it = results.begin();
         m_targetAddress = it->first;
+        m_targetName = it->second.targetName;
         DIRETTA_LOG("Selected first target: " << it->second.targetName);
     }
 
@@ -397,6 +570,17 @@ bool DirettaSync::open(const AudioFormat& format) {
         return false;
     }
 
+    // Every open() is a safe point for other cycle settings: score the
+    // session that ends here
+    endCycleSession();
+
+    // A follower rejoins the source's stream once online with the new format
+    leaveFanout();
+
+    // Unpark the worker: the connect sequence below needs it at full rate.
+    // It parks again if the open fails.
+    WorkerStreamingGuard streaming(*this);
+
     // Reopen SDK if it was released (e.g., after playlist end)
     if (!m_sdkOpen) {
         std::cout << "[DirettaSync] SDK was released, reopening..." << std::endl;
@@ -425,7 +609,13 @@ bool DirettaSync::open(const AudioFormat& format) {
                   << format.bitDepth << "bit/" << format.channels << "ch"
                   << (format.isDSD ? " DSD" : " PCM") << std::endl;
 
-        if (sameFormat) {
+        // Cycle settings only change with setSink: reconnect to try others
+        bool retune = sameFormat && cycleRetunePending();
+        if (retune) {
+            std::cout << "[DirettaSync] Same format - reconnecting for other cycle settings" << std::endl;
+        }
+
+        if (sameFormat && !retune) {
             std::cout << "[DirettaSync] Same format - quick resume (no setSink)" << std::endl;
 
             // Send silence before transition to flush Diretta pipeline
@@ -466,6 +656,9 @@ bool DirettaSync::open(const AudioFormat& format) {
                 }
             }
 
+            restartCycleSession();
+            allowFanoutJoin();
+            streaming.dismiss();
             std::cout << "[DirettaSync] ========== OPEN COMPLETE (quick) ==========" << std::endl;
             return true;
         } else {
@@ -491,13 +684,13 @@ bool DirettaSync::open(const AudioFormat& format) {
                 if (nowPCM) {
                     std::cout << "[DirettaSync] DSD->PCM transition - full close/reopen" << std::endl;
                 } else {
-                    int prevMultiplier = m_previousFormat.sampleRate / 2822400;
-                    int newMultiplier = format.sampleRate / 2822400;
+                    int prevMultiplier = DirettaBuffer::dsdMultiplier(m_previousFormat.sampleRate);
+                    int newMultiplier = DirettaBuffer::dsdMultiplier(format.sampleRate);
                     std::cout << "[DirettaSync] DSD" << (prevMultiplier * 64) << "->DSD"
                               << (newMultiplier * 64) << " rate change - full close/reopen" << std::endl;
                 }
 
-                int dsdMultiplier = m_previousFormat.sampleRate / 2822400;  // DSD64=1, DSD512=8
+                int dsdMultiplier = DirettaBuffer::dsdMultiplier(m_previousFormat.sampleRate);  // DSD64=1, DSD1024=16
                 std::cout << "[DirettaSync] Previous format was DSD" << (dsdMultiplier * 64) << std::endl;
 
                 // Clear any pending silence requests (playback is stopped, can't send anyway)
@@ -509,6 +702,7 @@ bool DirettaSync::open(const AudioFormat& format) {
 
                 // CRITICAL: Stop worker thread BEFORE closing SDK to prevent use-after-free
                 m_running = false;
+                wakeWorker();
                 {
                     std::lock_guard<std::mutex> lock(m_workerMutex);
                     if (m_workerThread.joinable()) {
@@ -529,7 +723,7 @@ bool DirettaSync::open(const AudioFormat& format) {
                 // G4: Scale delay with DSD rate - higher rates have deeper pipelines
                 // Also scale for high target PCM rates which need extra PLL settling time
                 // G1: Use interruptible wait for responsive shutdown
-                int baseDelay = 200 * std::max(1, dsdMultiplier);  // 200ms (DSD64) to 1600ms (DSD512)
+                int baseDelay = 200 * std::min(dsdMultiplier, DirettaBuffer::MAX_RESET_DELAY_MULTIPLIER);  // 200ms (DSD64) to 1600ms (DSD512+)
                 int pcmBonus = 0;
                 if (nowPCM && format.sampleRate >= 176400) {
                     // Only apply PCM bonus when transitioning TO PCM (not DSD→DSD rate change)
@@ -560,6 +754,7 @@ bool DirettaSync::open(const AudioFormat& format) {
 
                 // CRITICAL: Stop worker thread BEFORE closing SDK to prevent use-after-free
                 m_running = false;
+                wakeWorker();
                 {
                     std::lock_guard<std::mutex> lock(m_workerMutex);
                     if (m_workerThread.joinable()) {
@@ -611,7 +806,7 @@ bool DirettaSync::open(const AudioFormat& format) {
                 if (needsFullReset) {
                     // Same clock family high-rate PCM→DSD transition
                     // Full close/reopen required to reset target's PLL
-                    int dsdMultiplier = format.sampleRate / 2822400;  // Target DSD rate
+                    int dsdMultiplier = DirettaBuffer::dsdMultiplier(format.sampleRate);  // Target DSD rate
                     std::cout << "[DirettaSync] High-rate PCM->DSD" << (dsdMultiplier * 64)
                               << " (same " << oldFamily << "Hz family) - full close/reopen" << std::endl;
 
@@ -624,6 +819,7 @@ bool DirettaSync::open(const AudioFormat& format) {
 
                     // CRITICAL: Stop worker thread BEFORE closing SDK to prevent use-after-free
                     m_running = false;
+                    wakeWorker();
                     {
                         std::lock_guard<std::mutex> lock(m_workerMutex);
                         if (m_workerThread.joinable()) {
@@ -639,7 +835,7 @@ bool DirettaSync::open(const AudioFormat& format) {
                     m_paused = false;
 
                     // Delay for target to reset - scale with target DSD rate
-                    int resetDelayMs = 200 * std::max(1, dsdMultiplier);  // 200ms (DSD64) to 1600ms (DSD512)
+                    int resetDelayMs = 200 * std::min(dsdMultiplier, DirettaBuffer::MAX_RESET_DELAY_MULTIPLIER);  // 200ms (DSD64) to 1600ms (DSD512+)
                     std::cout << "[DirettaSync] Waiting " << resetDelayMs
                               << "ms for target to reset..." << std::endl;
                     interruptibleWait(m_transitionMutex, m_transitionCv, m_transitionWakeup, resetDelayMs);
@@ -661,6 +857,7 @@ bool DirettaSync::open(const AudioFormat& format) {
 
                     // CRITICAL: Stop worker thread BEFORE closing SDK to prevent use-after-free
                     m_running = false;
+                    wakeWorker();
                     {
                         std::lock_guard<std::mutex> lock(m_workerMutex);
                         if (m_workerThread.joinable()) {
@@ -746,8 +943,24 @@ bool DirettaSync::open(const AudioFormat& format) {
     }
 
     unsigned int cycleTimeUs = calculateCycleTime(effectiveSampleRate, effectiveChannels, bitsPerSample);
+    DirettaTransferMode transferMode = resolveTransferMode(m_config.transferMode);
+    if (m_config.adaptiveCycle) {
+        beginCycleSession(m_isDsdMode.load(std::memory_order_acquire), effectiveSampleRate, cycleTimeUs, transferMode);
+    } else if (m_config.measureCallbacks) {
+        // A callback gap of two cycles means the SDK went without data for one
+        m_callbackStats.lateNs.store(2LL * cycleTimeUs * 1000, std::memory_order_relaxed);
+    }
+    m_cycleSettings.cycleUs = cycleTimeUs;
+    m_cycleSettings.mode = static_cast<int>(transferMode);
+    if (m_config.transferMode == DirettaTransferMode::AUTO && !m_config.adaptiveCycle) {
+        DIRETTA_LOG("Using " << CycleTuning::modeName(m_cycleSettings.mode));
+    }
     ACQUA::Clock cycleTime = ACQUA::Clock::MicroSeconds(cycleTimeUs);
 
+    // SCHED_DEADLINE worker: period/runtime follow the cycle time
+    m_workerCycleUs.store(cycleTimeUs, std::memory_order_relaxed);
+    m_workerSchedGen.fetch_add(1, std::memory_order_release);
+
     // Initial delay - Target needs time to prepare for new format
     // Longer delay for first open/reconnect, shorter for reconfigure
     int initialDelayMs = needFullConnect ? 500 : 200;
@@ -776,7 +989,7 @@ bool DirettaSync::open(const AudioFormat& format) {
         inquirySupportFormat(m_targetAddress);
     }
 
-    applyTransferMode(m_config.transferMode, cycleTime);
+    applyTransferMode(transferMode, cycleTime);
 
     // Connect sequence - only needed after disconnect
     if (needFullConnect) {
@@ -831,6 +1044,10 @@ bool DirettaSync::open(const AudioFormat& format) {
     m_playing = true;
     m_paused = false;
 
+    placeSdkThreads();
+    allowFanoutJoin();
+    streaming.dismiss();
+
     std::cout << "[DirettaSync] ========== OPEN COMPLETE ==========" << std::endl;
     return true;
 }
@@ -838,6 +1055,14 @@ bool DirettaSync::open(const AudioFormat& format) {
 void DirettaSync::close() {
     std::cout << "[DirettaSync] Close()" << std::endl;
 
+    // A follower's tap must not hold the source's producer back once its
+    // worker stops reading: stop its pops (the shutdown silence still
+    // plays), then leave the tap for good
+    if (m_fanoutSource) {
+        m_stopRequested = true;
+    }
+    leaveFanout();
+
     if (!m_open) {
         DIRETTA_LOG("Not open");
         return;
@@ -870,6 +1095,9 @@ void DirettaSync::close() {
     m_playing = false;
     m_paused = false;
     m_rebuffering.store(false, std::memory_order_relaxed);
+    setWorkerStreaming(false);
+    rememberLatencyTarget();
+    endCycleSession();
 
     DIRETTA_LOG("Close() done");
 }
@@ -881,6 +1109,7 @@ void DirettaSync::release() {
     if (m_open) {
         close();
     }
+    leaveFanout();
 
     // Now fully close the SDK connection so target is released
     if (m_sdkOpen) {
@@ -888,6 +1117,7 @@ void DirettaSync::release() {
 
         // Shutdown worker thread
         m_running = false;
+        wakeWorker();
         {
             std::lock_guard<std::mutex> lock(m_workerMutex);
             if (m_workerThread.joinable()) {
@@ -918,6 +1148,7 @@ bool DirettaSync::reopenForFormatChange() {
     // CRITICAL: Stop worker thread BEFORE closing SDK to prevent use-after-free
     // The worker thread calls getNewStream() which accesses SDK structures
     m_running = false;
+    wakeWorker();
     {
         std::lock_guard<std::mutex> lock(m_workerMutex);
         if (m_workerThread.joinable()) {
@@ -1174,6 +1405,10 @@ size_t DirettaSync::calculateAlignedPrefill(size_t bytesPerSecond, size_t bytesP
     } else {
         targetMs = DirettaBuffer::PREFILL_MS_UNCOMPRESSED;
     }
+    // Never start above the fill the controller will hold
+    if (m_latency.targetBytes > 0) {
+        targetMs = std::min<size_t>(targetMs, static_cast<size_t>(std::ceil(m_latency.targetMs)));
+    }
 
     // Convert to bytes
     size_t targetBytes = (bytesPerSecond * targetMs) / 1000;
@@ -1210,28 +1445,41 @@ void DirettaSync::configureRingPCM(int rate, int channels, int direttaBps, int i
     m_isLowBitrate.store(direttaBps <= 2 && rate <= 48000, std::memory_order_release);
     m_dsdConversionMode.store(DirettaRingBuffer::DSDConversionMode::Passthrough, std::memory_order_release);
 
+    PushPipeline pipeline = pcmPushPipeline(channels, direttaBps, inputBps);
+    m_pushFn.store(pipeline.push, std::memory_order_release);
+    m_pushLabel.store(pipeline.label, std::memory_order_release);
+
     // Increment format generation to invalidate cached values in sendAudio
     m_formatGeneration.fetch_add(1, std::memory_order_release);
     // C1: Also increment consumer generation for getNewStream
     m_consumerStateGen.fetch_add(1, std::memory_order_release);
 
     size_t bytesPerSecond = static_cast<size_t>(rate) * channels * direttaBps;
-    size_t ringSize = DirettaBuffer::calculateBufferSize(bytesPerSecond, DirettaBuffer::PCM_BUFFER_SECONDS);
+    size_t ringSize = DirettaBuffer::ringBytesFor(bytesPerSecond, DirettaBuffer::PCM_BUFFER_SECONDS, latencyBoundMs());
 
-    m_ringBuffer.resize(ringSize, 0x00);
-    ringSize = m_ringBuffer.size();
+    if (m_fanoutSource) {
+        // Reads the source's ring through a tap: its own only keeps the silence byte
+        m_ringBuffer.resize(0, 0x00);
+    } else {
+        m_ringBuffer.resize(ringSize, 0x00);
+        ringSize = m_ringBuffer.size();
+    }
 
     int bytesPerFrame = channels * direttaBps;
-    int framesBase = rate / 1000;
     int framesRemainder = rate % 1000;
     m_bytesPerFrame.store(bytesPerFrame, std::memory_order_release);
     m_framesPerBufferRemainder.store(static_cast<uint32_t>(framesRemainder), std::memory_order_release);
     m_framesPerBufferAccumulator.store(0, std::memory_order_release);
 
-    size_t bytesPerBuffer = static_cast<size_t>(framesBase) * bytesPerFrame;
+    size_t bytesPerBuffer = pcmBufferBytes(rate, channels, direttaBps);
     m_bytesPerBuffer.store(static_cast<int>(bytesPerBuffer), std::memory_order_release);
+    reserveStreamBuffer(bytesPerBuffer + (framesRemainder != 0 ? bytesPerFrame : 0));
+    assert(ringQuiesced());
+    bool exactPop = m_ringBuffer.setConsumerBufferSize(
+        bytesPerBuffer, framesRemainder != 0 ? bytesPerBuffer + bytesPerFrame : 0);
 
     // Aligned prefill: calculate as whole-buffer count for clean transitions
+    resetLatencyControl(bytesPerSecond, bytesPerBuffer, false, static_cast<uint32_t>(rate));
     m_prefillTargetBuffers = calculateAlignedPrefill(bytesPerSecond, bytesPerBuffer, false, isCompressed);
 
     // For non-integer sample rates (44.1kHz family), calculate exact byte count
@@ -1259,7 +1507,8 @@ void DirettaSync::configureRingPCM(int rate, int channels, int direttaBps, int i
                 << direttaBps << "bps, buffer=" << ringSize
                 << ", prefill=" << m_prefillTargetBuffers << " buffers ("
                 << m_prefillTarget << " bytes, "
-                << (isCompressed ? "compressed" : "uncompressed") << ")");
+                << (isCompressed ? "compressed" : "uncompressed") << "), pop copy "
+                << (exactPop ? "exact" : "fixed-shape"));
 }
 
 void DirettaSync::configureRingDSD(uint32_t byteRate, int channels) {
@@ -1273,34 +1522,45 @@ void DirettaSync::configureRingDSD(uint32_t byteRate, int channels) {
     m_channels.store(channels, std::memory_order_release);
     m_isLowBitrate.store(false, std::memory_order_release);
 
+    // Conversion mode was chosen by configureSinkDSD()
+    PushPipeline pipeline = dsdPushPipeline(m_dsdConversionMode.load(std::memory_order_acquire), channels);
+    m_pushFn.store(pipeline.push, std::memory_order_release);
+    m_pushLabel.store(pipeline.label, std::memory_order_release);
+
     // Increment format generation to invalidate cached values in sendAudio
     m_formatGeneration.fetch_add(1, std::memory_order_release);
     // C1: Also increment consumer generation for getNewStream
     m_consumerStateGen.fetch_add(1, std::memory_order_release);
 
     uint32_t bytesPerSecond = byteRate * channels;
-    size_t ringSize = DirettaBuffer::calculateBufferSize(bytesPerSecond, DirettaBuffer::DSD_BUFFER_SECONDS);
+    size_t ringSize = DirettaBuffer::ringBytesFor(bytesPerSecond, DirettaBuffer::DSD_BUFFER_SECONDS, latencyBoundMs());
 
-    m_ringBuffer.resize(ringSize, 0x69);  // DSD silence
-    ringSize = m_ringBuffer.size();
+    if (m_fanoutSource) {
+        m_ringBuffer.resize(0, 0x69);      // Tap reader, see configureRingPCM()
+    } else {
+        m_ringBuffer.resize(ringSize, 0x69);  // DSD silence
+        ringSize = m_ringBuffer.size();
+    }
 
-    uint32_t inputBytesPerMs = (byteRate / 1000) * channels;
-    size_t bytesPerBuffer = inputBytesPerMs;
-    bytesPerBuffer = ((bytesPerBuffer + (4 * channels - 1)) / (4 * channels)) * (4 * channels);
-    if (bytesPerBuffer < 64) bytesPerBuffer = 64;
+    size_t bytesPerBuffer = dsdBufferBytes(byteRate, channels);
     m_bytesPerBuffer.store(static_cast<int>(bytesPerBuffer), std::memory_order_release);
+    reserveStreamBuffer(bytesPerBuffer);
+    assert(ringQuiesced());
+    bool exactPop = m_ringBuffer.setConsumerBufferSize(bytesPerBuffer);
     m_bytesPerFrame.store(0, std::memory_order_release);
     m_framesPerBufferRemainder.store(0, std::memory_order_release);
     m_framesPerBufferAccumulator.store(0, std::memory_order_release);
 
     // Aligned prefill: calculate as whole-buffer count for clean transitions
+    resetLatencyControl(bytesPerSecond, bytesPerBuffer, true, byteRate * 8);
     m_prefillTargetBuffers = calculateAlignedPrefill(bytesPerSecond, bytesPerBuffer, true, false);
     m_prefillTarget = m_prefillTargetBuffers * bytesPerBuffer;
     m_prefillComplete = false;
 
     DIRETTA_LOG("Ring DSD: byteRate=" << byteRate << " ch=" << channels
                 << " buffer=" << ringSize << " prefill=" << m_prefillTargetBuffers
-                << " buffers (" << m_prefillTarget << " bytes)");
+                << " buffers (" << m_prefillTarget << " bytes), pop copy "
+                << (exactPop ? "exact" : "fixed-shape"));
 }
 
 //=============================================================================
@@ -1316,6 +1576,7 @@ bool DirettaSync::startPlayback() {
         return true;
     }
 
+    setWorkerStreaming(true);
     play();
     m_playing = true;
     m_paused = false;
@@ -1344,6 +1605,7 @@ void DirettaSync::stopPlayback(bool immediate) {
     stop();
     m_playing = false;
     m_paused = false;
+    setWorkerStreaming(false);
 }
 
 void DirettaSync::pausePlayback() {
@@ -1359,6 +1621,7 @@ void DirettaSync::pausePlayback() {
 
     stop();
     m_paused = true;
+    setWorkerStreaming(false);
 }
 
 void DirettaSync::resumePlayback() {
@@ -1375,6 +1638,7 @@ void DirettaSync::resumePlayback() {
     m_ringBuffer.clear();
     m_prefillComplete = false;
 
+    setWorkerStreaming(true);
     play();
     m_paused = false;
     m_playing = true;
@@ -1391,7 +1655,9 @@ void DirettaSync::sendPreTransitionSilence() {
 // Audio Data (Push Interface)
 //=============================================================================
 
-size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples) {
+size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples, uint32_t* contentOr) {
+    reportStreamEvents();
+    RT_AUDIT_SCOPE("sendAudio");
     if (m_draining.load(std::memory_order_acquire)) return 0;
     if (m_stopRequested.load(std::memory_order_acquire)) return 0;
     if (!is_online()) return 0;
@@ -1403,74 +1669,27 @@ size_t DirettaSync::sendAudio(const uint8_t* data, size_t numSamples) {
     // Only reload format atomics when format has actually changed
     uint32_t gen = m_formatGeneration.load(std::memory_order_acquire);
     if (gen != m_cachedFormatGen) {
-        m_cachedDsdMode = m_isDsdMode.load(std::memory_order_acquire);
-        m_cachedPack24bit = m_need24BitPack.load(std::memory_order_acquire);
-        m_cachedUpsample16to32 = m_need16To32Upsample.load(std::memory_order_acquire);
-        m_cachedUpsample16to24 = m_need16To24Upsample.load(std::memory_order_acquire);
+        m_cachedPushFn = m_pushFn.load(std::memory_order_acquire);
+        m_cachedPushLabel = m_pushLabel.load(std::memory_order_acquire);
         m_cachedChannels = m_channels.load(std::memory_order_acquire);
         m_cachedBytesPerSample = m_bytesPerSample.load(std::memory_order_acquire);
-        m_cachedDsdConversionMode = m_dsdConversionMode.load(std::memory_order_acquire);
         m_cachedFormatGen = gen;
     }
 
-    // Use cached values (no atomic loads in hot path)
-    bool dsdMode = m_cachedDsdMode;
-    bool pack24bit = m_cachedPack24bit;
-    bool upsample16to32 = m_cachedUpsample16to32;
-    bool upsample16to24 = m_cachedUpsample16to24;
-    int numChannels = m_cachedChannels;
-    int bytesPerSample = m_cachedBytesPerSample;
-
-    size_t written = 0;
-    size_t totalBytes;
-    const char* formatLabel;
-
-    if (dsdMode) {
-        // DSD: numSamples encoding from AudioEngine
-        // numSamples = (totalBytes * 8) / channels
-        // Reverse: totalBytes = numSamples * channels / 8
-        totalBytes = (numSamples * numChannels) / 8;
-
-        // Use optimized path with cached conversion mode (no per-iteration branching)
-        written = m_ringBuffer.pushDSDPlanarOptimized(
-            data, totalBytes, numChannels, m_cachedDsdConversionMode);
-        formatLabel = "DSD";
-
-    } else if (pack24bit) {
-        // PCM 24-bit: numSamples is sample count
-        size_t bytesPerFrame = 4 * numChannels;  // S24_P32
-        totalBytes = numSamples * bytesPerFrame;
-
-        written = m_ringBuffer.push24BitPacked(data, totalBytes);
-        formatLabel = "PCM24";
-
-    } else if (upsample16to32) {
-        // PCM 16->32
-        size_t bytesPerFrame = 2 * numChannels;
-        totalBytes = numSamples * bytesPerFrame;
-
-        written = m_ringBuffer.push16To32(data, totalBytes);
-        formatLabel = "PCM16->32";
-
-    } else if (upsample16to24) {
-        // PCM 16->24 (sink only supports 24-bit, not 32-bit)
-        size_t bytesPerFrame = 2 * numChannels;
-        totalBytes = numSamples * bytesPerFrame;
-
-        written = m_ringBuffer.push16To24(data, totalBytes);
-        formatLabel = "PCM16->24";
-
-    } else {
-        // PCM direct copy
-        size_t bytesPerFrame = static_cast<size_t>(bytesPerSample) * numChannels;
-        totalBytes = numSamples * bytesPerFrame;
-
-        written = m_ringBuffer.push(data, totalBytes);
-        formatLabel = "PCM";
-    }
+    // Pipeline selected by configureRing*(): no per-call format branching
+    size_t totalBytes = 0;
+    size_t written = m_cachedPushFn(m_ringBuffer, data, numSamples,
+                                    m_cachedChannels, m_cachedBytesPerSample, totalBytes, contentOr);
+    const char* formatLabel = m_cachedPushLabel;
 
     // Check prefill completion
     if (written > 0) {
+        m_latency.pushedBytes += written;
+        m_latency.pushes++;
+        if (!m_latency.family.empty()) {
+            m_latency.lastPush = std::chrono::steady_clock::now();
+        }
+
         if (!m_prefillComplete.load(std::memory_order_acquire)) {
             if (m_ringBuffer.getAvailable() >= m_prefillTarget) {
                 m_prefillComplete = true;
@@ -1497,7 +1716,8 @@ float DirettaSync::getBufferLevel() const {
     if (!ringGuard.active()) return 0.0f;
     size_t size = m_ringBuffer.size();
     if (size == 0) return 0.0f;
-    return static_cast<float>(m_ringBuffer.getAvailable()) / static_cast<float>(size);
+    // Fill as the producer sees it: with fan-out, behind the slowest reader
+    return static_cast<float>(size - 1 - m_ringBuffer.getFreeSpace()) / static_cast<float>(size);
 }
 
 void DirettaSync::dumpStats() const {
@@ -1515,8 +1735,10 @@ void DirettaSync::dumpStats() const {
                   << fmt.bitDepth << "bit/" << fmt.channels << "ch "
                   << (fmt.isDSD ? "DSD" : "PCM") << std::endl;
     }
-    size_t ringSize = m_ringBuffer.size();
-    size_t avail = m_ringBuffer.getAvailable();
+    // A follower shows its read position in the source's ring
+    const DirettaRingBuffer& ring = m_fanoutSource ? m_fanoutSource->m_ringBuffer : m_ringBuffer;
+    size_t ringSize = ring.size();
+    size_t avail = m_fanoutSource ? ring.tapAvailable(m_fanoutTap) : ring.getAvailable();
     float fillPct = ringSize > 0 ? (100.0f * avail / ringSize) : 0.0f;
     std::cout << "  Buffer:      " << avail << "/" << ringSize
               << " bytes (" << std::fixed << std::setprecision(1) << fillPct << "%)" << std::endl;
@@ -1524,6 +1746,112 @@ void DirettaSync::dumpStats() const {
     std::cout << "  Streams:     " << m_streamCount.load(std::memory_order_relaxed) << std::endl;
     std::cout << "  Pushes:      " << m_pushCount.load(std::memory_order_relaxed) << std::endl;
     std::cout << "  Underruns:   " << m_underrunCount.load(std::memory_order_relaxed) << std::endl;
+    if (m_latency.targetBytes > 0 && m_latency.bytesPerSecond > 0.0) {
+        double msPerByte = 1000.0 / m_latency.bytesPerSecond;
+        std::cout << "  Latency:     target " << std::setprecision(1)
+                  << m_latency.targetBytes * msPerByte << "ms, fill " << m_latency.meanFill * msPerByte << "ms";
+        if (m_latency.maxFill >= m_latency.minFill) {
+            std::cout << " (" << m_latency.minFill * msPerByte << "-" << m_latency.maxFill * msPerByte << "ms)";
+        }
+        std::cout << ", admission at " << m_latency.level * 100.0f << "%, producer/consumer "
+                  << std::setprecision(3) << m_latency.fill.rateRatio << " (bias " << std::setprecision(1)
+                  << m_latency.fill.rateBias * msPerByte << "ms)" << std::endl;
+    }
+    if (!m_latency.family.empty()) {
+        std::cout << "  Adaptive:    " << m_latency.family << " target " << std::setprecision(1)
+                  << m_latency.targetMs << "ms (" << m_config.adaptiveMinMs << "-" << m_latency.maxMs
+                  << "ms), worst stall " << std::max(m_latency.peakStallMs, m_latency.stallMs)
+                  << "ms, pop jitter " << std::max(m_latency.peakJitterMs, m_latency.jitterMs) << "ms" << std::endl;
+    }
+
+    // Worker wake-up lateness (compare SCHED_DEADLINE vs SCHED_FIFO under load)
+    if (m_workerDeadlineActive.load(std::memory_order_relaxed)) {
+        std::cout << "  Worker:      SCHED_DEADLINE, period "
+                  << m_workerPeriodUs.load(std::memory_order_relaxed) << "us" << std::endl;
+    } else {
+        ThreadPolicy effective = m_config.workerPolicy;
+        if (effective.policy == SchedPolicy::Deadline) {
+            effective = ThreadPolicy::fifo(DirettaWorker::FIFO_FALLBACK_PRIORITY);  // Refused
+        }
+        std::cout << "  Worker:      " << describeThreadPolicy(effective) << ", poll period "
+                  << m_workerPeriodUs.load(std::memory_order_relaxed) << "us" << std::endl;
+    }
+    int64_t idleWallNs = m_workerIdleWallNs.load(std::memory_order_relaxed);
+    if (idleWallNs > 0) {
+        double idleCpuPct = 100.0 * m_workerIdleCpuNs.load(std::memory_order_relaxed) / idleWallNs;
+        std::cout << "  Idle:        " << std::setprecision(1) << idleWallNs / 1e9 << "s, "
+                  << m_workerParks.load(std::memory_order_relaxed) << " parks ("
+                  << m_workerParkWakes.load(std::memory_order_relaxed) << " woken), CPU "
+                  << std::setprecision(3) << idleCpuPct << "%" << std::endl;
+    }
+    uint64_t written = m_ringBuffer.writtenBytes();
+    if (written > 0) {
+        size_t threshold = m_ringBuffer.streamingStoreThreshold();
+        std::cout << "  Ring writes: " << std::setprecision(1)
+                  << (100.0 * m_ringBuffer.streamedBytes() / written) << "% streaming stores (";
+        if (threshold == SIZE_MAX) {
+            std::cout << "off)" << std::endl;
+        } else {
+            std::cout << "above " << threshold / 1024 << " KB fill)" << std::endl;
+        }
+    }
+    uint64_t cacheValues[PerfCounterGroup::MAX_COUNTERS] = {};
+    if (m_workerCacheReady.load(std::memory_order_acquire) && m_workerCache.read(cacheValues)) {
+        std::cout << "  Worker cache:";
+        if (m_workerL1dMiss >= 0) std::cout << " L1D misses " << cacheValues[m_workerL1dMiss] << ",";
+        if (m_workerLlcMiss >= 0) std::cout << " LLC misses " << cacheValues[m_workerLlcMiss];
+        if (m_workerLlcMiss >= 0 && m_workerLlcAccess >= 0 && cacheValues[m_workerLlcAccess] > 0) {
+            std::cout << "/" << cacheValues[m_workerLlcAccess] << " ("
+                      << (100.0 * cacheValues[m_workerLlcMiss] / cacheValues[m_workerLlcAccess]) << "%)";
+        }
+        std::cout << std::endl;
+    }
+    if (m_cycleSession.active) {
+        std::cout << "  Cycle:       " << m_cycleSession.settings.cycleUs << "us "
+                  << CycleTuning::modeName(m_cycleSession.settings.mode) << " at " << m_cycleSession.key
+                  << ", " << m_cycleTuning.describe(m_cycleSession.key) << std::endl;
+    }
+    uint64_t wakeups = m_wakeStats.count.load(std::memory_order_relaxed);
+    if (wakeups > 0) {
+        std::cout << "  Wake-ups:    " << wakeups << ", late avg "
+                  << std::setprecision(1) << (m_wakeStats.totalNs.load(std::memory_order_relaxed) / 1000.0 / wakeups)
+                  << "us, max " << m_wakeStats.maxNs.load(std::memory_order_relaxed) / 1000 << "us" << std::endl;
+        std::cout << "  Lateness:   ";
+        for (int i = 0; i < WakeupStats::BUCKETS; i++) {
+            if (i < WakeupStats::BUCKETS - 1) {
+                std::cout << " <" << WakeupStats::BUCKET_LIMIT_US[i] << "us:";
+            } else {
+                std::cout << " >=" << WakeupStats::BUCKET_LIMIT_US[i - 1] << "us:";
+            }
+            std::cout << m_wakeStats.histogram[i].load(std::memory_order_relaxed);
+        }
+        std::cout << std::endl;
+    }
+    if (m_fanoutSource) {
+        std::cout << "  Fan-out:     follower of target " << (m_fanoutSource->m_targetIndex + 1)
+                  << " (tap " << m_fanoutTap << ")" << std::endl;
+    }
+    if (!m_fanoutFollowers.empty()) {
+        std::cout << "  Fan-out:     source for " << m_fanoutFollowers.size() << " targets, "
+                  << m_fanoutAligned.load(std::memory_order_relaxed) << " aligned at start" << std::endl;
+        for (const DirettaSync* follower : m_fanoutFollowers) {
+            uint64_t samples = follower->m_fanoutLagSamples.load(std::memory_order_relaxed);
+            std::cout << "    target " << (follower->m_targetIndex + 1) << ": ";
+            if (!m_ringBuffer.tapActive(follower->m_fanoutTap)) {
+                std::cout << "not playing";
+            } else {
+                std::cout << "lag " << std::setprecision(2)
+                          << follower->m_fanoutLagUs.load(std::memory_order_relaxed) / 1000.0 << "ms";
+            }
+            if (samples > 0) {
+                std::cout << ", avg " << std::setprecision(2)
+                          << follower->m_fanoutLagSumUs.load(std::memory_order_relaxed) / 1000.0 / samples
+                          << "ms, max " << follower->m_fanoutLagMaxUs.load(std::memory_order_relaxed) / 1000.0 << "ms";
+            }
+            std::cout << ", late joins " << follower->m_fanoutLateJoins.load(std::memory_order_relaxed)
+                      << ", resyncs " << follower->m_fanoutResyncs.load(std::memory_order_relaxed) << std::endl;
+        }
+    }
     std::cout << "════════════════════════════════════════\n" << std::endl;
 }
 
@@ -1532,12 +1860,16 @@ void DirettaSync::dumpStats() const {
 //=============================================================================
 
 bool DirettaSync::getNewStream(diretta_stream& baseStream) {
+    RT_AUDIT_SCOPE("getNewStream");
     // SDK 148 WORKAROUND: Do NOT use DIRETTA::Stream class methods!
     // After Stop→Play (track change), SDK 148's Stream objects are corrupted.
     // Any method call (resize, get_16, etc.) causes segfault.
     // Solution: Use our own persistent buffer and directly set diretta_stream fields.
 
     m_workerActive = true;
+    if (m_config.adaptiveCycle || m_config.measureCallbacks) {
+        m_callbackStats.record(monotonicNs());
+    }
 
     // C1: Generation counter optimization for stable state
     // Single atomic load in common case (format rarely changes during playback)
@@ -1546,11 +1878,15 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
         // Cold path: reload stable state values
         m_cachedBytesPerBuffer = m_bytesPerBuffer.load(std::memory_order_acquire);
         m_cachedSilenceByte = m_ringBuffer.silenceByte();
+        m_cachedSilenceBlock = m_cachedSilenceByte == 0x69 ? m_silenceDsd
+                             : m_cachedSilenceByte == 0x00 ? m_silencePcm : nullptr;
         m_cachedConsumerIsDsd = m_isDsdMode.load(std::memory_order_acquire);
         m_cachedConsumerSampleRate = m_sampleRate.load(std::memory_order_acquire);
         // PCM buffer rounding drift fix values (stable per-track)
         m_cachedBytesPerFrame = m_bytesPerFrame.load(std::memory_order_acquire);
         m_cachedFramesPerBufferRemainder = m_framesPerBufferRemainder.load(std::memory_order_acquire);
+        m_cachedStreamBuffer = m_streamBuffer;
+        m_cachedStreamCapacity = m_streamCapacity;
         m_cachedConsumerGen = gen;
     }
 
@@ -1571,50 +1907,70 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
     }
 
     // SDK 148 WORKAROUND: Use our own buffer instead of Stream::resize()
-    // Resize our persistent buffer if needed
-    if (m_streamData.size() != static_cast<size_t>(currentBytesPerBuffer)) {
-        m_streamData.resize(currentBytesPerBuffer);
+    // configureRing*() sized it for the format (reserveStreamBuffer()); a
+    // larger request cannot happen, and is cut short rather than grown here
+    if (static_cast<size_t>(currentBytesPerBuffer) > m_cachedStreamCapacity) {
+        currentBytesPerBuffer = static_cast<int>(m_cachedStreamCapacity);
     }
 
     // Directly set the diretta_stream C structure fields
     // The SDK only reads Data.P (pointer) and Size fields
-    baseStream.Data.P = m_streamData.data();
+    baseStream.Data.P = m_cachedStreamBuffer;
     baseStream.Size = currentBytesPerBuffer;
 
-    uint8_t* dest = m_streamData.data();
+    uint8_t* dest = m_cachedStreamBuffer;
 
-    RingAccessGuard ringGuard(m_ringUsers, m_reconfiguring);
-    if (!ringGuard.active()) {
-        std::memset(dest, currentSilenceByte, currentBytesPerBuffer);
+    // Non-playing states: hand the SDK the pre-filled block, so waiting for
+    // prefill or stabilising does no stores (a buffer larger than the block,
+    // past the configured maximum format, is filled as before)
+    uint8_t* silenceBlock = m_cachedSilenceBlock;
+    auto emitSilence = [&]() {
+        if (silenceBlock && static_cast<size_t>(currentBytesPerBuffer) <= m_silenceCapacity) {
+            baseStream.Data.P = silenceBlock;
+        } else {
+            std::memset(dest, currentSilenceByte, currentBytesPerBuffer);
+        }
         m_workerActive = false;
         return true;
+    };
+
+    // A fan-out follower reads the source's ring, under the source's guard
+    DirettaSync& ringOwner = m_fanoutSource ? *m_fanoutSource : *this;
+    DirettaRingBuffer& ring = ringOwner.m_ringBuffer;
+    bool fanout = m_fanoutSource || !m_fanoutFollowers.empty();
+
+    RingAccessGuard ringGuard(ringOwner.m_ringUsers, ringOwner.m_reconfiguring);
+    if (!ringGuard.active()) {
+        return emitSilence();
     }
 
     bool currentIsDsd = m_cachedConsumerIsDsd;
-    size_t currentRingSize = m_ringBuffer.size();
+    size_t currentRingSize = ring.size();
 
     // Shutdown silence
     int silenceRemaining = m_silenceBuffersRemaining.load(std::memory_order_acquire);
     if (silenceRemaining > 0) {
-        std::memset(dest, currentSilenceByte, currentBytesPerBuffer);
         m_silenceBuffersRemaining.fetch_sub(1, std::memory_order_acq_rel);
-        m_workerActive = false;
-        return true;
+        return emitSilence();
     }
 
     // Stop requested
     if (m_stopRequested.load(std::memory_order_acquire)) {
-        std::memset(dest, currentSilenceByte, currentBytesPerBuffer);
-        m_workerActive = false;
-        return true;
+        return emitSilence();
     }
 
     // Prefill not complete
-    if (!m_prefillComplete.load(std::memory_order_acquire)) {
+    if (!ringOwner.m_prefillComplete.load(std::memory_order_acquire)) {
+        if (fanout) {
+            // The ring was cleared: consumers line up again for the next start
+            m_fanoutReady.store(false, std::memory_order_release);
+            m_fanoutStarted.store(false, std::memory_order_release);
+            m_fanoutWaiting = false;
+        }
         // Diagnostic: Log prefill progress periodically (only in verbose mode)
         if (g_verbose) {
             static int prefillLogCount = 0;
-            size_t avail = m_ringBuffer.getAvailable();
+            size_t avail = ring.getAvailable();
             if (prefillLogCount++ % 50 == 0) {  // Log every 50th call (~100ms at typical rates)
                 float pct = (m_prefillTarget > 0) ? (100.0f * avail / m_prefillTarget) : 0.0f;
                 std::cout << "[Prefill] Waiting: " << avail << "/" << m_prefillTarget
@@ -1622,9 +1978,7 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
                           << (currentIsDsd ? " [DSD]" : " [PCM]") << std::endl;
             }
         }
-        std::memset(dest, currentSilenceByte, currentBytesPerBuffer);
-        m_workerActive = false;
-        return true;
+        return emitSilence();
     }
 
     // Post-online stabilization
@@ -1637,11 +1991,11 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
 
         if (currentIsDsd) {
             // Target warmup time scales with DSD rate:
-            // DSD64: 50ms, DSD128: 100ms, DSD256: 200ms, DSD512: 400ms
+            // DSD64: 50ms, DSD128: 100ms, DSD256: 200ms, DSD512: 400ms, DSD1024: 800ms
             // C1: Use cached sample rate from generation counter
             int currentSampleRate = m_cachedConsumerSampleRate;
-            int dsdMultiplier = currentSampleRate / 2822400;  // DSD64 = 1
-            int targetWarmupMs = 50 * std::max(1, dsdMultiplier);  // 50ms baseline
+            int dsdMultiplier = DirettaBuffer::dsdMultiplier(currentSampleRate);  // DSD64 = 1
+            int targetWarmupMs = 50 * dsdMultiplier;  // 50ms baseline
 
             // Calculate cycle time based on MTU and data rate
             // cycleTime = (efficientMTU / bytesPerSecond) in microseconds
@@ -1664,13 +2018,16 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
             m_stabilizationCount.store(0, std::memory_order_relaxed);
             DIRETTA_LOG("Post-online stabilization complete (" << count << " buffers)");
         }
-        std::memset(dest, currentSilenceByte, currentBytesPerBuffer);
-        m_workerActive = false;
-        return true;
+        return emitSilence();
+    }
+
+    // Fan-out: every consumer of the ring starts on the same byte
+    if (fanout && !fanoutStartGate()) {
+        return emitSilence();
     }
 
     int count = m_streamCount.fetch_add(1, std::memory_order_relaxed) + 1;
-    size_t avail = m_ringBuffer.getAvailable();
+    size_t avail = m_fanoutSource ? ring.tapAvailable(m_fanoutTap) : ring.getAvailable();
 
     if (g_verbose && (count <= 5 || count % 5000 == 0)) {
         float fillPct = (currentRingSize > 0) ? (100.0f * avail / currentRingSize) : 0.0f;
@@ -1685,15 +2042,15 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
     // during a network stall — accumulates data for a clean resumption
     if (m_rebuffering.load(std::memory_order_acquire)) {
         size_t threshold = static_cast<size_t>(currentRingSize * DirettaBuffer::REBUFFER_THRESHOLD_PCT);
+        threshold = std::min(threshold, ringOwner.m_rebufferCap.load(std::memory_order_relaxed));
         if (avail >= threshold) {
             m_rebuffering.store(false, std::memory_order_release);
-            LOG_WARN("[DirettaSync] Rebuffering complete — resuming playback (avail="
-                     << avail << ", threshold=" << threshold << ")");
+            m_rebufferEndAvail.store(avail, std::memory_order_relaxed);
+            m_rebufferEndThreshold.store(threshold, std::memory_order_relaxed);
+            m_recoveredUnderruns.fetch_add(1, std::memory_order_release);    // Reported by the producer
             // Fall through to normal pop below
         } else {
-            std::memset(dest, currentSilenceByte, currentBytesPerBuffer);
-            m_workerActive = false;
-            return true;
+            return emitSilence();
         }
     }
 
@@ -1702,22 +2059,55 @@ bool DirettaSync::getNewStream(diretta_stream& baseStream) {
         m_underrunCount.fetch_add(1, std::memory_order_relaxed);
         if (!m_rebuffering.load(std::memory_order_relaxed)) {
             m_rebuffering.store(true, std::memory_order_release);
-            LOG_WARN("[DirettaSync] Buffer underrun — entering rebuffering mode (avail=" << avail << ")");
+            m_rebufferStartAvail.store(avail, std::memory_order_relaxed);
+            m_rebufferStarts.fetch_add(1, std::memory_order_release);        // Reported by the producer
         }
-        std::memset(dest, currentSilenceByte, currentBytesPerBuffer);
-        m_workerActive = false;
-        return true;
+        m_lastPopNs = 0;    // The gap until the next pop is the underrun, not jitter
+        return emitSilence();
     }
 
     // Pop from ring buffer
-    m_ringBuffer.pop(dest, currentBytesPerBuffer);
+    if (m_fanoutSource) {
+        ring.tapPop(m_fanoutTap, dest, currentBytesPerBuffer);
+        recordFanoutLag(currentBytesPerBuffer);
+    } else {
+        ring.pop(dest, currentBytesPerBuffer);
+
+        // Fill-level controller input (admissionLevel()); this thread is the
+        // only writer, so plain load/store rather than read-modify-write
+        m_fillSum.store(m_fillSum.load(std::memory_order_relaxed) + avail, std::memory_order_relaxed);
+        m_poppedBytes.store(m_poppedBytes.load(std::memory_order_relaxed) + currentBytesPerBuffer,
+                            std::memory_order_relaxed);
+        m_fillSamples.store(m_fillSamples.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        if (avail < m_fillMin.load(std::memory_order_relaxed)) m_fillMin.store(avail, std::memory_order_relaxed);
+        if (avail > m_fillMax.load(std::memory_order_relaxed)) m_fillMax.store(avail, std::memory_order_relaxed);
+
+        // Adaptive buffer: consumer interval jitter. Gaps beyond the upper
+        // bound are a stop or pause, not jitter.
+        if (m_config.adaptiveBuffer) {
+            int64_t now = monotonicNs();
+            int64_t interval = now - m_lastPopNs;
+            if (m_lastPopNs != 0 && interval < static_cast<int64_t>(m_config.adaptiveMaxMs) * 1000000 &&
+                interval > m_popIntervalMaxNs.load(std::memory_order_relaxed)) {
+                m_popIntervalMaxNs.store(interval, std::memory_order_relaxed);
+            }
+            m_lastPopNs = now;
+        }
+    }
 
     // G1: Signal producer that space is now available
     // Use try_lock to avoid blocking the time-critical consumer thread
     // If producer isn't waiting, this is a no-op (harmless notification)
-    if (m_flowMutex.try_lock()) {
-        m_flowMutex.unlock();
-        m_spaceAvailable.notify_one();
+    if (ringOwner.m_flowMutex.try_lock()) {
+        ringOwner.m_flowMutex.unlock();
+        ringOwner.m_spaceAvailable.notify_one();
+    }
+
+    // Epoll producer waiting (armSpaceEvent): the fence orders the pop above
+    // before the flag load, pairing with the one in armSpaceEvent()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ringOwner.m_spaceEventArmed.load(std::memory_order_relaxed)) {
+        ringOwner.signalSpaceEvent();
     }
 
     m_workerActive = false;
@@ -1741,19 +2131,169 @@ bool DirettaSync::startSyncWorker() {
     m_running = true;
     m_stopRequested = false;
 
-    m_workerThread = std::thread([this]() {
-        // F1: Elevate worker thread priority for reduced jitter
-        // SCHED_FIFO priority 50 (mid-range real-time) - requires root/CAP_SYS_NICE
-        setRealtimePriority(50);
+    // F1: The worker names and places itself (default SCHED_FIFO 50, see
+    // DirettaConfig::workerPolicy). Wait until it has registered so that
+    // placeSdkThreads() never mistakes it for an SDK thread.
+    std::promise<void> placed;
+    std::future<void> placedFuture = placed.get_future();
+
+    m_workerThread = std::thread([this, &placed]() {
+        // SCHED_DEADLINE needs the cycle time - workerLoop() applies it
+        ThreadPolicy initial = m_config.workerPolicy;
+        if (initial.policy == SchedPolicy::Deadline) {
+            initial.policy = SchedPolicy::Inherit;
+        }
+        bool report = !m_workerPlacementReported.exchange(true, std::memory_order_relaxed);
+        placeCurrentThread("s2d-worker", initial, report);
+        prefaultStack();
+        RT_AUDIT_THREAD("worker", m_targetIndex + 1);     // One slot per target (zones, fan-out)
+        openWorkerCacheCounters();
+        placed.set_value();
+
+        workerLoop();
+    });
+
+    placedFuture.wait();
+    return true;
+}
+
+void DirettaSync::workerLoop() {
+    uint32_t schedGen = m_workerSchedGen.load(std::memory_order_acquire) - 1;  // Force first apply
+    bool deadline = false;
+    int64_t periodNs = 0;
+    int64_t expectedWakeNs = 0;
+    bool idle = false;
+    int64_t idleCpuMark = 0;
+    int64_t idleWallMark = 0;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        uint32_t gen = m_workerSchedGen.load(std::memory_order_acquire);
+        if (gen != schedGen) {
+            schedGen = gen;
+            bool wasDeadline = deadline;
+            deadline = applyWorkerSchedule(m_workerCycleUs.load(std::memory_order_relaxed), periodNs);
+            if (deadline != wasDeadline) m_wakeStats.reset();
+            expectedWakeNs = 0;
+        }
 
-        while (m_running.load(std::memory_order_acquire)) {
+        // Not streaming: finish whatever the SDK still has queued, then park
+        // until open()/startPlayback() (or the idle timeout) wakes us
+        if (!m_workerStreaming.load(std::memory_order_acquire)) {
+            if (!idle) {
+                idle = true;
+                idleCpuMark = threadCpuNs();
+                idleWallMark = monotonicNs();
+            }
             if (!syncWorker()) {
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                parkWorker();
             }
+            int64_t cpu = threadCpuNs();
+            int64_t wall = monotonicNs();
+            m_workerIdleCpuNs.store(m_workerIdleCpuNs.load(std::memory_order_relaxed) + (cpu - idleCpuMark),
+                                    std::memory_order_relaxed);
+            m_workerIdleWallNs.store(m_workerIdleWallNs.load(std::memory_order_relaxed) + (wall - idleWallMark),
+                                     std::memory_order_relaxed);
+            idleCpuMark = cpu;
+            idleWallMark = wall;
+            expectedWakeNs = 0;
+            continue;
         }
-    });
+        idle = false;
 
-    return true;
+        if (deadline) {
+            // Drain what is due this period, then give the rest of the budget
+            // back: under SCHED_DEADLINE sched_yield() sleeps until the next period
+            for (int i = 0; i < DirettaWorker::MAX_SYNC_CALLS_PER_PERIOD && syncWorker(); i++) {}
+            sched_yield();
+
+            int64_t now = monotonicNs();
+            if (expectedWakeNs == 0 || now - expectedWakeNs > periodNs || now < expectedWakeNs - periodNs) {
+                expectedWakeNs = now;    // First period, or overran: resync to the new period
+            } else {
+                m_wakeStats.record(now - expectedWakeNs);
+            }
+            expectedWakeNs += periodNs;
+        } else if (!syncWorker()) {
+            // Absolute grid derived from the cycle time; a late wake-up does not
+            // push the following ones back. Resync only after a full period overrun.
+            int64_t now = monotonicNs();
+            if (expectedWakeNs == 0 || now - expectedWakeNs >= periodNs) {
+                expectedWakeNs = now;
+            }
+            expectedWakeNs += periodNs;
+            sleepUntilNs(expectedWakeNs);
+            m_wakeStats.record(monotonicNs() - expectedWakeNs);
+        }
+    }
+}
+
+bool DirettaSync::applyWorkerSchedule(unsigned int cycleTimeUs, int64_t& periodNs) {
+    const ThreadPolicy& configured = m_config.workerPolicy;
+    if (configured.policy != SchedPolicy::Deadline) {
+        unsigned int period = DirettaWorker::periodUs(cycleTimeUs);
+        periodNs = static_cast<int64_t>(period) * 1000;
+        m_workerPeriodUs.store(period, std::memory_order_relaxed);
+        m_workerDeadlineActive.store(false, std::memory_order_relaxed);
+        return false;
+    }
+
+    ThreadPolicy policy = configured;
+    policy.cpus.clear();    // Affinity was applied at thread start
+    if (configured.isDeadlineAuto()) {
+        unsigned int period = DirettaWorker::periodUs(cycleTimeUs);
+        policy.dlPeriodUs = period;
+        policy.dlRuntimeUs = period * DirettaWorker::RUNTIME_PCT / 100;
+        policy.dlDeadlineUs = period * DirettaWorker::DEADLINE_PCT / 100;
+    }
+
+    std::string error;
+    if (applyThreadPolicy(0, policy, &error)) {
+        periodNs = static_cast<int64_t>(policy.dlPeriodUs) * 1000;
+        m_workerPeriodUs.store(policy.dlPeriodUs, std::memory_order_relaxed);
+        m_workerDeadlineActive.store(true, std::memory_order_relaxed);
+        DIRETTA_LOG("Worker " << describeThreadPolicy(policy) << " (cycle " << cycleTimeUs << "us)");
+        return true;
+    }
+
+    // Refused (no CAP_SYS_NICE, admission control, restricted affinity):
+    // keep the classic SCHED_FIFO worker
+    ThreadPolicy fallback = ThreadPolicy::fifo(DirettaWorker::FIFO_FALLBACK_PRIORITY);
+    applyThreadPolicy(0, fallback);
+    unsigned int fallbackPeriod = DirettaWorker::periodUs(cycleTimeUs);
+    periodNs = static_cast<int64_t>(fallbackPeriod) * 1000;
+    m_workerPeriodUs.store(fallbackPeriod, std::memory_order_relaxed);
+    if (!m_deadlineWarned) {
+        m_deadlineWarned = true;
+        LOG_WARN("[DirettaSync] SCHED_DEADLINE refused (" << error << ") — worker falls back to "
+                 << describeThreadPolicy(fallback));
+    }
+    m_workerDeadlineActive.store(false, std::memory_order_relaxed);
+    return false;
+}
+
+void DirettaSync::setWorkerStreaming(bool streaming) {
+    m_workerStreaming.store(streaming, std::memory_order_release);
+    if (streaming) {
+        wakeWorker();
+    }
+}
+
+void DirettaSync::wakeWorker() {
+    // Taking the mutex orders the flag store before the worker's predicate check
+    { std::lock_guard<std::mutex> lock(m_workerParkMutex); }
+    m_workerParkCv.notify_all();
+}
+
+void DirettaSync::parkWorker() {
+    m_workerParks.store(m_workerParks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lock(m_workerParkMutex);
+    bool woken = m_workerParkCv.wait_for(lock, std::chrono::milliseconds(DirettaWorker::IDLE_PARK_MS), [this]() {
+        return m_workerStreaming.load(std::memory_order_acquire) || !m_running.load(std::memory_order_acquire);
+    });
+    if (woken) {
+        m_workerParkWakes.store(m_workerParkWakes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
 }
 
 //=============================================================================
@@ -1767,6 +2307,10 @@ void DirettaSync::beginReconfigure() {
     }
 }
 
+bool DirettaSync::ringQuiesced() const {
+    return m_reconfiguring.load(std::memory_order_acquire) && m_ringUsers.load(std::memory_order_acquire) == 0;
+}
+
 void DirettaSync::endReconfigure() {
     m_reconfiguring.store(false, std::memory_order_release);
 }
@@ -1774,6 +2318,7 @@ void DirettaSync::endReconfigure() {
 void DirettaSync::shutdownWorker() {
     m_stopRequested = true;
     m_running = false;
+    wakeWorker();
 
     int waitCount = 0;
     while (m_workerActive.load(std::memory_order_acquire) && waitCount < 100) {
@@ -1787,14 +2332,559 @@ void DirettaSync::shutdownWorker() {
     }
 }
 
+void DirettaSync::allocateArena() {
+    // Everything the audio path writes to, carved once from one pre-faulted
+    // mapping: format changes reuse it and never reach the heap
+    if (m_arena.valid()) {
+        return;     // Already carved by an earlier enable()
+    }
+
+    // A fan-out follower reads the source's ring: a placeholder for the
+    // silence byte, so the constructor's heap ring is still released
+    size_t ringBytes = m_fanoutSource
+        ? AudioArena::DEFAULT_ALIGNMENT
+        : DirettaBuffer::maxRingBytes(m_config.maxSampleRate, m_config.maxChannels, latencyBoundMs());
+    size_t streamBytes = DirettaBuffer::MAX_STREAM_BUFFER_BYTES;
+    size_t silenceBytes = 2 * ((streamBytes + SILENCE_BLOCK_ALIGNMENT - 1) & ~(SILENCE_BLOCK_ALIGNMENT - 1));
+    size_t arenaBytes = ringBytes + streamBytes + 2 * AudioArena::DEFAULT_ALIGNMENT +
+                        silenceBytes + SILENCE_BLOCK_ALIGNMENT;
+
+    if (!m_arena.allocate(arenaBytes, m_config.hugePages)) {
+        LOG_WARN("[DirettaSync] Could not map " << arenaBytes / 1024
+                 << " KB audio arena — buffers will be heap allocated per format");
+        return;
+    }
+    if (m_config.hugePages) {
+        // Sequential walks over a multi-MB ring touch thousands of 4K pages:
+        // one TLB entry per huge page instead
+        std::string backing = m_arena.backing();
+        if (backing == "4k") {
+            LOG_WARN("[DirettaSync] Huge pages unavailable (no vm.nr_hugepages pool, THP disabled)"
+                     << " — ring uses normal pages");
+        } else {
+            LOG_INFO("[DirettaSync] Ring backed by " << AudioArena::hugePageSize() / 1024 << " KB "
+                     << (backing == "hugetlb" ? "hugetlbfs pages" : "transparent huge pages"));
+        }
+    }
+
+    m_ringBuffer.attachStorage(m_arena.carve(ringBytes), ringBytes);
+    m_streamBuffer = m_arena.carve(streamBytes);
+    m_streamCapacity = streamBytes;
+
+    if (m_fanoutSource) {
+        DIRETTA_LOG("Audio arena: " << m_arena.capacity() / 1024 << " KB (" << m_arena.backing()
+                    << "), fan-out follower (no ring), stream buffer " << streamBytes << " bytes");
+        return;
+    }
+    DIRETTA_LOG("Audio arena: " << m_arena.capacity() / 1024 << " KB (" << m_arena.backing()
+                << "), ring " << ringBytes / 1024 << " KB for up to " << m_config.maxSampleRate
+                << "Hz, stream buffer " << streamBytes << " bytes");
+}
+
+void DirettaSync::allocateSilenceBlocks() {
+    if (m_silencePcm) {
+        return;     // Filled by an earlier enable()
+    }
+
+    size_t blockBytes = (DirettaBuffer::MAX_STREAM_BUFFER_BYTES + SILENCE_BLOCK_ALIGNMENT - 1) &
+                        ~(SILENCE_BLOCK_ALIGNMENT - 1);
+    uint8_t* storage = m_arena.carve(2 * blockBytes, SILENCE_BLOCK_ALIGNMENT);
+    if (!storage) {
+        m_silenceData.resize(2 * blockBytes);
+        storage = m_silenceData.data();
+    }
+    std::memset(storage, 0x00, blockBytes);                 // PCM silence
+    std::memset(storage + blockBytes, 0x69, blockBytes);    // DSD silence
+    m_silencePcm = storage;
+    m_silenceDsd = storage + blockBytes;
+    m_silenceCapacity = blockBytes;
+}
+
+void DirettaSync::configureStreamingStores() {
+    const CpuCaches& caches = cpuCaches();
+    size_t threshold = SIZE_MAX;
+
+    switch (m_config.ntStores) {
+        case NtStoreMode::On:
+            threshold = 0;
+            break;
+        case NtStoreMode::Off:
+            break;
+        case NtStoreMode::Auto:
+            if (caches.llc > 0) {
+                threshold = caches.llc;
+            } else {
+                DIRETTA_LOG("Last-level cache size unknown — streaming stores disabled");
+            }
+            break;
+    }
+    m_ringBuffer.setStreamingStoreThreshold(threshold);
+
+    if (threshold == SIZE_MAX) {
+        DIRETTA_LOG("Ring writes: cached stores");
+    } else {
+        DIRETTA_LOG("Ring writes: streaming stores above " << threshold / 1024 << " KB fill (L"
+                    << caches.llcLevel << " " << caches.llc / 1024 << " KB)");
+    }
+}
+
+//=============================================================================
+// Space event (epoll producers)
+//=============================================================================
+
+bool DirettaSync::armSpaceEvent(float level) {
+    size_t size = m_ringBuffer.size();
+    m_spaceEventUsed.store(static_cast<size_t>(size * level), std::memory_order_relaxed);
+    m_spaceEventArmed.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Drained meanwhile: take the flag back unless the consumer already has
+    // (then the eventfd is, or is about to be, readable)
+    if (getBufferLevel() <= level) {
+        return !m_spaceEventArmed.exchange(false, std::memory_order_relaxed);
+    }
+    m_latency.gatedWaits++;
+    m_latency.lastPush = std::chrono::steady_clock::time_point();    // Waiting here is not a stall
+    return true;
+}
+
+// Worker thread, only while a producer is waiting
+void DirettaSync::signalSpaceEvent() {
+    size_t used = m_ringBuffer.size() - 1 - m_ringBuffer.getFreeSpace();
+    if (used > m_spaceEventUsed.load(std::memory_order_relaxed)) return;
+    if (!m_spaceEventArmed.exchange(false, std::memory_order_relaxed)) return;
+
+    uint64_t one = 1;
+    ssize_t ignored = ::write(m_spaceEventFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+//=============================================================================
+// Fill-level controller (producer thread)
+//=============================================================================
+
+float DirettaSync::admissionLevel() {
+    if (m_latency.targetBytes == 0) return DirettaBuffer::PRODUCER_HIGH_WATER;
+    auto now = std::chrono::steady_clock::now();
+
+    // Adaptive buffer: producer stall, from the last push to the next
+    // attempt (pipe read and conversion). Longer than the upper bound is
+    // the source going idle.
+    if (!m_latency.family.empty() && m_latency.lastPush != std::chrono::steady_clock::time_point()) {
+        double stallMs = std::chrono::duration<double, std::milli>(now - m_latency.lastPush).count();
+        if (stallMs < m_config.adaptiveMaxMs) {
+            m_latency.stallMs = std::max(m_latency.stallMs, stallMs);
+        }
+    }
+
+    if (now - m_latency.windowStart >= std::chrono::milliseconds(DirettaBuffer::LATENCY_CONTROL_MS)) {
+        updateLatencyControl(now);
+    }
+    return m_latency.level;
+}
+
+// configureRing*(): new format, new ring size
+// Largest target the fill-level controller can be given, 0 = controller off
+unsigned int DirettaSync::latencyBoundMs() const {
+    if (m_config.targetLatencyMs == 0 && !m_config.adaptiveBuffer && m_config.latencyBudgetMs == 0) {
+        return 0;
+    }
+    unsigned int ms = std::max({m_config.targetLatencyMs, m_config.latencyBudgetMs, DirettaBuffer::ADAPTIVE_MIN_MS});
+    if (m_config.adaptiveBuffer) ms = std::max(ms, m_config.adaptiveMaxMs);
+    return ms;
+}
+
+void DirettaSync::resetLatencyControl(size_t bytesPerSecond, size_t bytesPerBuffer, bool dsd, uint32_t rate) {
+    rememberLatencyTarget();
+
+    m_latency = LatencyControl();
+    m_latency.bytesPerSecond = static_cast<double>(bytesPerSecond);
+    m_latency.bytesPerBuffer = bytesPerBuffer;
+    m_latency.windowStart = std::chrono::steady_clock::now();
+    m_latency.lastAdapt = m_latency.windowStart;
+    m_latency.underruns = m_underrunCount.load(std::memory_order_relaxed);
+    m_latency.lastFillSamples = m_fillSamples.load(std::memory_order_acquire);
+    m_latency.lastFillSum = m_fillSum.load(std::memory_order_relaxed);
+    m_latency.lastPopped = m_poppedBytes.load(std::memory_order_relaxed);
+    m_fillMin.store(SIZE_MAX, std::memory_order_relaxed);
+    m_fillMax.store(0, std::memory_order_relaxed);
+    m_popIntervalMaxNs.store(0, std::memory_order_relaxed);
+
+    size_t ringSize = m_ringBuffer.size();
+    unsigned int budgetMs = m_latencyBudgetMs.load(std::memory_order_relaxed);
+    if ((m_config.targetLatencyMs == 0 && !m_config.adaptiveBuffer && budgetMs == 0) || ringSize == 0 ||
+        m_fanoutSource) {   // A follower has no producer to pace
+        m_rebufferCap.store(SIZE_MAX, std::memory_order_relaxed);
+        return;
+    }
+
+    m_latency.maxGate = static_cast<size_t>(ringSize * DirettaBuffer::PRODUCER_HIGH_WATER);
+    double ms = m_config.targetLatencyMs;
+    if (budgetMs > 0 && (ms == 0 || ms > budgetMs)) {
+        ms = budgetMs;
+    }
+    if (m_config.adaptiveBuffer) {
+        // The ring's share of a latency budget caps learning as well
+        m_latency.maxMs = m_config.adaptiveMaxMs;
+        if (budgetMs > 0) m_latency.maxMs = std::min<double>(m_latency.maxMs, budgetMs);
+        m_latency.family = BufferLearning::rateFamily(dsd, rate);
+        unsigned int learned = m_bufferLearning.learnedMs(m_latency.family);
+        ms = learned > 0 ? learned : ms > 0 ? ms : m_latency.maxMs;
+        ms = std::min(std::max(ms, static_cast<double>(m_config.adaptiveMinMs)), m_latency.maxMs);
+        DIRETTA_LOG("Adaptive buffer (" << m_latency.family << "): starting at " << ms << "ms"
+                    << (learned > 0 ? " (learned)" : ""));
+    }
+    applyLatencyTarget(ms);
+    m_latency.level = static_cast<float>(m_latency.targetBytes) / static_cast<float>(ringSize);
+
+    DIRETTA_LOG("Latency target " << m_latency.targetMs << "ms: " << m_latency.targetBytes << " bytes, admission "
+                << m_latency.minGate << "-" << m_latency.maxGate << " bytes of " << ringSize);
+}
+
+void DirettaSync::updateLatencyControl(std::chrono::steady_clock::time_point now) {
+    LatencyControl& lc = m_latency;
+    uint64_t samples = m_fillSamples.load(std::memory_order_acquire);
+    uint64_t sum = m_fillSum.load(std::memory_order_relaxed);
+    uint64_t popped = m_poppedBytes.load(std::memory_order_relaxed);
+
+    // Nothing popped (prefill, rebuffering, stopped): keep the level
+    if (samples > lc.lastFillSamples) {
+        lc.meanFill = static_cast<double>(sum - lc.lastFillSum) / static_cast<double>(samples - lc.lastFillSamples);
+        lc.minFill = m_fillMin.exchange(SIZE_MAX, std::memory_order_relaxed);
+        lc.maxFill = m_fillMax.exchange(0, std::memory_order_relaxed);
+        FillControl::Period period;
+        period.targetBytes = static_cast<double>(lc.targetBytes);
+        period.meanFill = lc.meanFill;
+        period.consumedBytes = static_cast<double>(popped - lc.lastPopped);
+        period.pushedBytes = static_cast<double>(lc.pushedBytes);
+        period.pushes = lc.pushes;
+        period.gatedWaits = lc.gatedWaits;
+        period.minGate = static_cast<double>(lc.minGate);
+        period.maxGate = static_cast<double>(lc.maxGate);
+
+        // The fill swings between the gate and the gate plus one push; the
+        // trim takes out what that model misses (producer wake-up latency,
+        // uneven pushes), the rate bias leans against a producer that ran
+        // free this period
+        double gate = FillControl::step(lc.fill, period, DirettaBuffer::LATENCY_CONTROL_GAIN,
+                                        DirettaBuffer::LATENCY_RATE_BIAS_MAX);
+        double halfPush = FillControl::halfPush(period);
+        size_t ringSize = m_ringBuffer.size();
+        if (ringSize > 0) lc.level = static_cast<float>(gate / static_cast<double>(ringSize));
+
+        if (!lc.family.empty()) adaptLatencyTarget(now, halfPush);
+    }
+
+    lc.windowStart = now;
+    lc.lastFillSamples = samples;
+    lc.lastFillSum = sum;
+    lc.lastPopped = popped;
+    lc.pushedBytes = 0;
+    lc.pushes = 0;
+    lc.gatedWaits = 0;
+}
+
+void DirettaSync::adaptLatencyTarget(std::chrono::steady_clock::time_point now, double halfPushBytes) {
+    LatencyControl& lc = m_latency;
+    double msPerByte = 1000.0 / lc.bytesPerSecond;
+    uint32_t underruns = m_underrunCount.load(std::memory_order_relaxed);
+
+    // Not called for longer than the upper bound: the source went idle (end
+    // of stream, pause), and the underruns of draining the ring meanwhile
+    // say nothing about the target
+    if (now - lc.windowStart > std::chrono::milliseconds(m_config.adaptiveMaxMs + DirettaBuffer::LATENCY_CONTROL_MS)) {
+        lc.underruns = underruns;
+        lc.lastAdapt = now;
+        m_popIntervalMaxNs.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    // Consumer interval jitter: the longest pop interval beyond a nominal one
+    double nominalMs = lc.bytesPerBuffer * msPerByte;
+    double intervalMs = m_popIntervalMaxNs.exchange(0, std::memory_order_relaxed) / 1e6;
+    lc.jitterMs = std::max(lc.jitterMs, intervalMs - nominalMs);
+    lc.peakStallMs = std::max(lc.peakStallMs, lc.stallMs);
+    lc.peakJitterMs = std::max(lc.peakJitterMs, lc.jitterMs);
+
+    // What the fill must cover: the producer gone for its worst stall and
+    // the consumer taking a late pop, from the bottom of the push swing
+    double needMs = lc.stallMs + lc.jitterMs + halfPushBytes * msPerByte + nominalMs;
+    double floorMs = std::max<double>(m_config.adaptiveMinMs, needMs * DirettaBuffer::ADAPTIVE_SAFETY);
+    floorMs = std::min(floorMs, lc.maxMs);
+
+    if (underruns != lc.underruns) {
+        lc.underruns = underruns;
+        lc.lastAdapt = now;
+        lc.settled = true;
+        double ms = std::min(lc.maxMs, std::max(lc.targetMs * DirettaBuffer::ADAPTIVE_GROW, floorMs));
+        if (ms > lc.targetMs) {
+            LOG_INFO("[DirettaSync] Adaptive buffer (" << lc.family << "): underrun at "
+                     << std::fixed << std::setprecision(1) << lc.targetMs << "ms, growing to " << ms
+                     << "ms (stall " << lc.stallMs << "ms, jitter " << lc.jitterMs << "ms)");
+            applyLatencyTarget(ms);
+        }
+        return;
+    }
+
+    if (now - lc.lastAdapt < std::chrono::seconds(DirettaBuffer::ADAPTIVE_SHRINK_INTERVAL_S)) return;
+    lc.lastAdapt = now;
+    lc.settled = true;
+    if (lc.targetMs > floorMs) {
+        double ms = std::max(floorMs, lc.targetMs * DirettaBuffer::ADAPTIVE_SHRINK);
+        DIRETTA_LOG("Adaptive buffer (" << lc.family << "): clean for " << DirettaBuffer::ADAPTIVE_SHRINK_INTERVAL_S
+                    << "s, " << lc.targetMs << "ms -> " << ms << "ms (stall " << lc.stallMs
+                    << "ms, jitter " << lc.jitterMs << "ms)");
+        applyLatencyTarget(ms);
+    }
+    // The next step looks at the next interval only
+    lc.stallMs = 0.0;
+    lc.jitterMs = 0.0;
+}
+
+void DirettaSync::applyLatencyTarget(double ms) {
+    LatencyControl& lc = m_latency;
+    size_t target = std::min(static_cast<size_t>(lc.bytesPerSecond * ms / 1000.0), lc.maxGate);
+    lc.targetMs = ms;
+    lc.targetBytes = target;
+    lc.minGate = std::min(std::max(target / 2, 2 * lc.bytesPerBuffer), target);
+    lc.fill.trim = 0.0;
+
+    // Rebuffering waits for the fill to recover: it must get there with the
+    // producer still admitted
+    m_rebufferCap.store(lc.minGate, std::memory_order_relaxed);
+}
+
+// Format change and close(): keep where this rate family settled
+void DirettaSync::rememberLatencyTarget() {
+    const LatencyControl& lc = m_latency;
+    if (lc.family.empty() || !lc.settled) return;
+
+    m_bufferLearning.remember(lc.family, static_cast<unsigned int>(std::lround(lc.targetMs)),
+                              lc.peakStallMs, lc.peakJitterMs);
+    std::string error;
+    if (!m_bufferLearning.save(error)) {
+        LOG_WARN("[DirettaSync] Could not save learned buffer targets: " << error);
+    }
+}
+
+//=============================================================================
+// Fan-out
+//=============================================================================
+
+bool DirettaSync::addFanoutFollower(DirettaSync& follower) {
+    int tap = m_ringBuffer.addTap();
+    if (tap < 0) {
+        std::cerr << "[DirettaSync] Fan-out: at most " << DirettaRingBuffer::MAX_TAPS
+                  << " followers per source" << std::endl;
+        return false;
+    }
+    follower.m_fanoutSource = this;
+    follower.m_fanoutTap = tap;
+    m_fanoutFollowers.push_back(&follower);
+    return true;
+}
+
+bool DirettaSync::fanoutFormatMatches() const {
+    if (!m_fanoutSource) return true;
+    const DirettaSync& source = *m_fanoutSource;
+
+    bool dsd = m_isDsdMode.load(std::memory_order_acquire);
+    if (dsd != source.m_isDsdMode.load(std::memory_order_acquire) ||
+        m_channels.load(std::memory_order_acquire) != source.m_channels.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (dsd) {
+        // Same input, same conversion: the sinks want the same bit/byte order
+        return m_dsdConversionMode.load(std::memory_order_acquire) ==
+               source.m_dsdConversionMode.load(std::memory_order_acquire);
+    }
+    return m_bytesPerSample.load(std::memory_order_acquire) ==
+           source.m_bytesPerSample.load(std::memory_order_acquire);
+}
+
+// close(), release(), and open() until it completes: once the tap is left,
+// no join (start gate, resync) brings it back before allowFanoutJoin()
+void DirettaSync::leaveFanout() {
+    if (!m_fanoutSource) return;
+    std::lock_guard<std::mutex> lock(m_fanoutSource->m_fanoutMutex);
+    m_fanoutLeaving = true;
+    m_fanoutReady.store(false, std::memory_order_release);
+    m_fanoutSource->m_ringBuffer.leaveTap(m_fanoutTap);
+}
+
+// End of a successful open(): the follower may join the source's stream again
+void DirettaSync::allowFanoutJoin() {
+    if (!m_fanoutSource) return;
+    std::lock_guard<std::mutex> lock(m_fanoutSource->m_fanoutMutex);
+    m_fanoutLeaving = false;
+}
+
+// Worker thread, after prefill and post-online stabilization. The source
+// holds its reader until every follower is ready (or the timeout), then
+// joins the ready ones at its own read position before its first pop, so
+// all start on the same byte. A follower ready after that joins wherever
+// the source is. Every join and leaveFanout() are serialised by the source's
+// m_fanoutMutex (try_lock here: the worker never blocks on it), and a
+// follower that is leaving does not join.
+bool DirettaSync::fanoutStartGate() {
+    if (m_fanoutSource) {
+        DirettaSync& source = *m_fanoutSource;
+        if (source.m_ringBuffer.tapActive(m_fanoutTap)) return true;
+
+        std::unique_lock<std::mutex> lock(source.m_fanoutMutex, std::try_to_lock);
+        if (!lock.owns_lock() || m_fanoutLeaving) return false;
+        m_fanoutReady.store(true, std::memory_order_release);
+        if (!source.m_fanoutStarted.load(std::memory_order_acquire)) return false;
+
+        source.m_ringBuffer.joinTap(m_fanoutTap);
+        m_fanoutLateJoins.fetch_add(1, std::memory_order_relaxed);
+        DIRETTA_LOG_ASYNC("Fan-out: target " << (m_targetIndex + 1) << " joined late");
+        return true;
+    }
+
+    if (m_fanoutStarted.load(std::memory_order_relaxed)) return true;
+
+    auto now = std::chrono::steady_clock::now();
+    if (!m_fanoutWaiting) {
+        m_fanoutWaiting = true;
+        m_fanoutWaitStart = now;
+    }
+
+    std::unique_lock<std::mutex> lock(m_fanoutMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+
+    bool allReady = true;
+    for (DirettaSync* follower : m_fanoutFollowers) {
+        allReady = allReady && follower->m_fanoutReady.load(std::memory_order_acquire);
+    }
+    if (!allReady && now - m_fanoutWaitStart <
+            std::chrono::milliseconds(DirettaBuffer::FANOUT_START_TIMEOUT_MS)) {
+        return false;
+    }
+
+    uint32_t aligned = 0;
+    for (DirettaSync* follower : m_fanoutFollowers) {
+        if (follower->m_fanoutReady.load(std::memory_order_acquire) && !follower->m_fanoutLeaving) {
+            m_ringBuffer.joinTap(follower->m_fanoutTap);
+            aligned++;
+        }
+    }
+    m_fanoutAligned.store(aligned, std::memory_order_relaxed);
+    m_fanoutStarted.store(true, std::memory_order_release);
+    m_fanoutWaiting = false;
+    DIRETTA_LOG_ASYNC("Fan-out: start with " << aligned << "/" << m_fanoutFollowers.size()
+                      << " followers aligned");
+    return true;
+}
+
+// Follower worker, after each pop. One buffer is 1 ms of audio.
+void DirettaSync::recordFanoutLag(int bytesPerBuffer) {
+    DirettaRingBuffer& ring = m_fanoutSource->m_ringBuffer;
+    int64_t lagUs = bytesPerBuffer > 0
+        ? static_cast<int64_t>(ring.tapLag(m_fanoutTap)) * 1000 / bytesPerBuffer : 0;
+
+    m_fanoutLagUs.store(lagUs, std::memory_order_relaxed);
+    int64_t absUs = lagUs < 0 ? -lagUs : lagUs;
+    if (absUs > m_fanoutLagMaxUs.load(std::memory_order_relaxed)) {
+        m_fanoutLagMaxUs.store(absUs, std::memory_order_relaxed);
+    }
+    m_fanoutLagSumUs.store(m_fanoutLagSumUs.load(std::memory_order_relaxed) + lagUs,
+                           std::memory_order_relaxed);
+    m_fanoutLagSamples.store(m_fanoutLagSamples.load(std::memory_order_relaxed) + 1,
+                             std::memory_order_relaxed);
+
+    // Fell behind (underrun, rebuffering) or ran ahead (source stalled,
+    // faster clock): jump to the source position rather than drift apart.
+    // Ahead of it, the bytes in between are still in the ring. A join like
+    // any other: skipped while the mutex is busy (next pop retries) or the
+    // tap was left meanwhile.
+    if (absUs > static_cast<int64_t>(DirettaBuffer::FANOUT_RESYNC_MS) * 1000) {
+        std::unique_lock<std::mutex> lock(m_fanoutSource->m_fanoutMutex, std::try_to_lock);
+        if (!lock.owns_lock() || m_fanoutLeaving || !ring.tapActive(m_fanoutTap)) return;
+        ring.joinTap(m_fanoutTap);
+        m_fanoutResyncs.fetch_add(1, std::memory_order_relaxed);
+        DIRETTA_LOG_ASYNC("Fan-out: target " << (m_targetIndex + 1) << " " << absUs / 1000
+                          << "ms " << (lagUs > 0 ? "behind" : "ahead") << ", moved to the source position");
+    }
+}
+
+void DirettaSync::openWorkerCacheCounters() {
+    // Per-thread counters: every worker thread opens its own set
+    m_workerCacheReady.store(false, std::memory_order_release);
+    m_workerCache.close();
+
+    auto cacheEvent = [](uint64_t cache, uint64_t result) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+    };
+    m_workerL1dMiss = m_workerCache.add(PERF_TYPE_HW_CACHE,
+                                        cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    m_workerLlcMiss = m_workerCache.add(PERF_TYPE_HW_CACHE,
+                                        cacheEvent(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    m_workerLlcAccess = m_workerCache.add(PERF_TYPE_HW_CACHE,
+                                          cacheEvent(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_ACCESS));
+    if (m_workerCache.count() == 0) {
+        DIRETTA_LOG("Worker cache counters unavailable: " << m_workerCache.lastError());
+        return;
+    }
+    m_workerCache.enable();
+    m_workerCacheReady.store(true, std::memory_order_release);
+}
+
+void DirettaSync::placeSdkThreads() {
+    // Every thread we create registers itself via placeCurrentThread(), so
+    // any other thread in the process belongs to the SDK. New SDK threads
+    // appear after each (re)open; already placed ones are skipped.
+    int placed = placeForeignThreads("s2d-sdk", m_config.sdkPolicy, !m_sdkPlacementReported);
+    if (placed > 0) {
+        m_sdkPlacementReported = true;
+        DIRETTA_LOG("Placed " << placed << " SDK thread(s)");
+    }
+}
+
+// configureRing*(): the arena block covers every format up to the
+// configured maximum; beyond it the buffer grows on the heap here, off the
+// worker. Published with the consumer generation.
+void DirettaSync::reserveStreamBuffer(size_t bytes) {
+    if (bytes <= m_streamCapacity) return;
+    m_streamDataRetired.swap(m_streamData);
+    m_streamData.assign(bytes, 0);
+    m_streamBuffer = m_streamData.data();
+    m_streamCapacity = m_streamData.size();
+    m_consumerStateGen.fetch_add(1, std::memory_order_release);
+    DIRETTA_LOG("Stream buffer: " << bytes << " bytes on the heap (beyond the arena block)");
+}
+
+// Producer thread, before each sendAudio(): the worker only counts
+// rebuffering events, the messages are printed here (a follower's by its
+// source, whose producer feeds it)
+void DirettaSync::reportStreamEvents() {
+    uint32_t starts = m_rebufferStarts.load(std::memory_order_acquire);
+    if (starts != m_reportedRebufferStarts) {
+        m_reportedRebufferStarts = starts;
+        LOG_WARN("[DirettaSync] Buffer underrun — entering rebuffering mode (avail="
+                 << m_rebufferStartAvail.load(std::memory_order_relaxed) << ", target "
+                 << (m_targetIndex + 1) << ")");
+    }
+    uint32_t recoveries = m_recoveredUnderruns.load(std::memory_order_acquire);
+    if (recoveries != m_reportedRecoveries) {
+        m_reportedRecoveries = recoveries;
+        LOG_WARN("[DirettaSync] Rebuffering complete — resuming playback (avail="
+                 << m_rebufferEndAvail.load(std::memory_order_relaxed) << ", threshold="
+                 << m_rebufferEndThreshold.load(std::memory_order_relaxed) << ", target "
+                 << (m_targetIndex + 1) << ")");
+    }
+    for (DirettaSync* follower : m_fanoutFollowers) {
+        follower->reportStreamEvents();
+    }
+}
+
 void DirettaSync::requestShutdownSilence(int buffers) {
     // N7: Scale silence buffers with DSD rate for consistent flush timing
     // Higher DSD rates have deeper pipelines requiring more buffers
     int scaledBuffers = buffers;
     if (m_isDsdMode.load(std::memory_order_relaxed)) {
         int sampleRate = m_sampleRate.load(std::memory_order_relaxed);
-        int dsdMultiplier = sampleRate / 2822400;  // DSD64=1, DSD512=8
-        scaledBuffers = buffers * std::max(1, dsdMultiplier);
+        scaledBuffers = buffers * DirettaBuffer::dsdMultiplier(sampleRate);  // DSD64=1, DSD1024=16
     }
 
     m_silenceBuffersRemaining = scaledBuffers;
@@ -1821,19 +2911,17 @@ bool DirettaSync::waitForOnline(unsigned int timeoutMs) {
     return true;
 }
 
-void DirettaSync::applyTransferMode(DirettaTransferMode mode, ACQUA::Clock cycleTime) {
-    if (mode == DirettaTransferMode::AUTO) {
-        if (m_isLowBitrate.load(std::memory_order_acquire) ||
-            m_isDsdMode.load(std::memory_order_acquire)) {
-            DIRETTA_LOG("Using VarAuto");
-            configTransferVarAuto(cycleTime);
-        } else {
-            DIRETTA_LOG("Using VarMax");
-            configTransferVarMax(cycleTime);
-        }
-        return;
+DirettaTransferMode DirettaSync::resolveTransferMode(DirettaTransferMode mode) const {
+    if (mode != DirettaTransferMode::AUTO) return mode;
+    if (m_isLowBitrate.load(std::memory_order_acquire) ||
+        m_isDsdMode.load(std::memory_order_acquire)) {
+        return DirettaTransferMode::VAR_AUTO;
     }
+    return DirettaTransferMode::VAR_MAX;
+}
 
+void DirettaSync::applyTransferMode(DirettaTransferMode mode, ACQUA::Clock cycleTime) {
+    mode = resolveTransferMode(mode);
     switch (mode) {
         case DirettaTransferMode::FIX_AUTO:
             configTransferFixAuto(cycleTime);
@@ -1854,3 +2942,76 @@ unsigned int DirettaSync::calculateCycleTime(uint32_t sampleRate, int channels,
     }
     return m_calculator->calculate(sampleRate, channels, bitsPerSample);
 }
+
+//=============================================================================
+// Adaptive cycle time (open()/close(), control thread)
+//=============================================================================
+
+// The calculated settings come in; what this session tries goes out
+void DirettaSync::beginCycleSession(bool dsd, uint32_t rate, unsigned int& cycleTimeUs, DirettaTransferMode& mode) {
+    m_cycleSession.key = CycleTuning::rateKey(dsd, rate);
+    m_cycleSession.base.cycleUs = cycleTimeUs;
+    m_cycleSession.base.mode = static_cast<int>(mode);
+    m_cycleSession.settings = m_cycleTuning.next(m_cycleSession.key, m_cycleSession.base);
+    restartCycleSession();
+
+    cycleTimeUs = m_cycleSession.settings.cycleUs;
+    mode = static_cast<DirettaTransferMode>(m_cycleSession.settings.mode);
+    std::cout << "[DirettaSync] Adaptive cycle time (" << m_cycleSession.key << "): "
+              << cycleTimeUs << "us " << CycleTuning::modeName(m_cycleSession.settings.mode)
+              << (m_cycleSession.settings == m_cycleSession.base ? " (calculated)" : "")
+              << ", " << m_cycleTuning.describe(m_cycleSession.key) << std::endl;
+}
+
+void DirettaSync::restartCycleSession() {
+    if (m_cycleSession.key.empty()) return;
+    m_cycleSession.active = true;
+    m_cycleSession.underruns = m_recoveredUnderruns.load(std::memory_order_relaxed);
+    // A callback gap of two cycles means the SDK went without data for one
+    m_callbackStats.requestReset(2LL * m_cycleSession.settings.cycleUs * 1000);
+}
+
+CycleTuning::Result DirettaSync::callbackResult() const {
+    CycleTuning::Result result;
+    result.underruns = m_recoveredUnderruns.load(std::memory_order_relaxed);
+    uint64_t count = m_callbackStats.count.load(std::memory_order_acquire);
+    if (count == 0 || m_callbackStats.resetRequested.load(std::memory_order_acquire)) return result;
+    double sumUs = static_cast<double>(m_callbackStats.sumUs.load(std::memory_order_relaxed));
+    double sumSqUs = static_cast<double>(m_callbackStats.sumSqUs.load(std::memory_order_relaxed));
+    double meanUs = sumUs / count;
+
+    result.seconds = sumUs / 1e6;
+    result.jitterUs = std::sqrt(std::max(0.0, sumSqUs / count - meanUs * meanUs));
+    result.lateCallbacks = m_callbackStats.late.load(std::memory_order_relaxed);
+    return result;
+}
+
+void DirettaSync::endCycleSession() {
+    if (!m_cycleSession.active) return;
+    m_cycleSession.active = false;
+
+    CycleTuning::Result result = callbackResult();
+    if (result.seconds <= 0.0) return;
+    result.underruns -= m_cycleSession.underruns;
+
+    if (!m_cycleTuning.report(m_cycleSession.key, m_cycleSession.settings, m_cycleSession.base, result)) {
+        DIRETTA_LOG("Adaptive cycle time: " << std::fixed << std::setprecision(1) << result.seconds
+                    << "s session too short to score");
+        return;
+    }
+    LOG_INFO("[DirettaSync] Adaptive cycle time (" << m_cycleSession.key << "): "
+             << m_cycleSession.settings.cycleUs << "us " << CycleTuning::modeName(m_cycleSession.settings.mode)
+             << " played " << std::fixed << std::setprecision(1) << result.seconds << "s, callback jitter "
+             << result.jitterUs << "us, " << result.lateCallbacks << " late, " << result.underruns
+             << " underruns; " << m_cycleTuning.describe(m_cycleSession.key));
+
+    std::string error;
+    if (!m_cycleTuning.save(error)) {
+        LOG_WARN("[DirettaSync] Could not save cycle time results: " << error);
+    }
+}
+
+bool DirettaSync::cycleRetunePending() const {
+    if (!m_config.adaptiveCycle || m_cycleSession.key.empty()) return false;
+    return !(m_cycleTuning.next(m_cycleSession.key, m_cycleSession.base) == m_cycleSession.settings);
+}
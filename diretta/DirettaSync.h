@@ -10,6 +10,12 @@
 #define DIRETTA_SYNC_H
 
 #include "DirettaRingBuffer.h"
+#include "ThreadPolicy.h"
+#include "AudioArena.h"
+#include "PerfCounter.h"
+#include "BufferLearning.h"
+#include "CycleTuning.h"
+#include "FillControl.h"
 
 #include <Sync.hpp>
 #include <Find.hpp>
@@ -20,6 +26,7 @@
 #include <ACQUA/Clock.hpp>
 
 #include <memory>
+#include <vector>
 #include <string>
 #include <mutex>
 #include <atomic>
@@ -106,9 +113,12 @@ extern bool g_verbose;
 #include "LogLevel.h"
 
 #ifdef NOLOG
-// Production build: compile out all verbose logging for zero overhead
-#define DIRETTA_LOG(msg) do {} while(0)
-#define DIRETTA_LOG_ASYNC(msg) do {} while(0)
+// Production build: compile out all verbose logging for zero overhead. The
+// message stays in a dead branch so variables only logged are still "used".
+#define DIRETTA_LOG(msg) do { \
+    if (false) { std::cout << msg; } \
+} while(0)
+#define DIRETTA_LOG_ASYNC(msg) DIRETTA_LOG(msg)
 #else
 // Debug build: check g_logLevel at runtime
 #define DIRETTA_LOG(msg) do { \
@@ -189,10 +199,6 @@ namespace DirettaBuffer {
     constexpr float DSD_BUFFER_SECONDS = 0.8f;
     constexpr float PCM_BUFFER_SECONDS = 0.5f;  // Balance: low latency + resilience
 
-    constexpr size_t DSD_PREFILL_MS = 200;
-    constexpr size_t PCM_PREFILL_MS = 50;       // Restored from 30 for stability
-    constexpr size_t PCM_LOWRATE_PREFILL_MS = 100;
-
     // Aligned prefill targets (for whole-buffer alignment)
     // Compressed formats (FLAC, ALAC) have variable decode times - need more buffer
     // Uncompressed formats (WAV, AIFF) have predictable timing - less buffer needed
@@ -202,6 +208,31 @@ namespace DirettaBuffer {
 
     constexpr float REBUFFER_THRESHOLD_PCT = 0.20f;      // Resume playback after 20% buffer refill
 
+    // Producer admission: push only while the ring is at most this full,
+    // unless the fill-level controller (targetLatencyMs) sets the level
+    constexpr float PRODUCER_HIGH_WATER = 0.75f;
+    // Fill-level controller: trim period, and the share of the mean fill
+    // error folded into the admission level per period
+    constexpr unsigned int LATENCY_CONTROL_MS = 100;
+    constexpr double LATENCY_CONTROL_GAIN = 0.25;
+    // Largest rate-ratio bias of the admission level, as a share of the target
+    constexpr double LATENCY_RATE_BIAS_MAX = 0.25;
+    // Adaptive buffer (adaptiveBuffer): default bounds of the latency target,
+    // the margin kept over the worst stall + jitter seen, how long playback
+    // must stay clean before each shrink step, and the step factors
+    constexpr unsigned int ADAPTIVE_MIN_MS = 20;
+    constexpr unsigned int ADAPTIVE_MAX_MS = 300;
+    constexpr double ADAPTIVE_SAFETY = 2.0;
+    constexpr unsigned int ADAPTIVE_SHRINK_INTERVAL_S = 10;
+    constexpr double ADAPTIVE_SHRINK = 0.9;
+    constexpr double ADAPTIVE_GROW = 1.5;
+    // With the controller on, the ring holds at most its largest target: it
+    // is sized for this multiple of it (the producer stops at
+    // PRODUCER_HIGH_WATER) instead of PCM/DSD_BUFFER_SECONDS, but not below
+    // the floor (room for a few of the largest pushes)
+    constexpr double RING_LATENCY_HEADROOM = 2.0;
+    constexpr size_t MIN_CONTROLLED_RING_BYTES = 512 * 1024;
+
     constexpr unsigned int DAC_STABILIZATION_MS = 100;
     constexpr unsigned int ONLINE_WAIT_MS = 2000;
     constexpr unsigned int FORMAT_SWITCH_DELAY_MS = 800;
@@ -211,8 +242,22 @@ namespace DirettaBuffer {
     // 64KB = ~370ms floor at 44.1kHz/16-bit, negligible at higher rates
     constexpr size_t MIN_BUFFER_BYTES = 65536;  // Was 3072000
     constexpr size_t MAX_BUFFER_BYTES = 16777216;
+    // Largest per-callback stream buffer: 1ms (+1 frame for the 44.1k-family
+    // accumulator) at 768kHz, 8ch, 32-bit; DSD1024 stereo needs less
+    constexpr size_t MAX_STREAM_BUFFER_BYTES = (768 + 1) * 8 * 4;
+
+    // Highest native DSD rate (DSD1024 x 48kHz); squeezelite carries DSD at
+    // rate/32 in u32 containers, so it is also bounded by maxSampleRate * 32
+    // (DSD1024 needs -r 1411200 or 1536000)
+    constexpr uint32_t MAX_DSD_RATE = 49152000;
     constexpr size_t MIN_PREFILL_BYTES = 1024;
 
+    // Fan-out: how long the source holds its first buffer for followers
+    // still coming online, and the lag (either way) beyond which a follower
+    // moves to the source's position
+    constexpr unsigned int FANOUT_START_TIMEOUT_MS = 3000;
+    constexpr unsigned int FANOUT_RESYNC_MS = 20;
+
     inline size_t calculateBufferSize(size_t bytesPerSecond, float seconds) {
         size_t size = static_cast<size_t>(bytesPerSecond * seconds);
         size = std::max(size, MIN_BUFFER_BYTES);
@@ -220,11 +265,35 @@ namespace DirettaBuffer {
         return size;
     }
 
-    inline size_t calculatePrefill(size_t bytesPerSecond, bool isDsd, bool isLowBitrate) {
-        size_t prefillMs = isDsd ? DSD_PREFILL_MS :
-                           isLowBitrate ? PCM_LOWRATE_PREFILL_MS : PCM_PREFILL_MS;
-        size_t result = (bytesPerSecond * prefillMs) / 1000;
-        return std::max(result, MIN_PREFILL_BYTES);
+    /**
+     * Ring size for one format: the given seconds, or with the fill-level
+     * controller on (latencyBoundMs > 0, its largest target) what that
+     * needs, whichever is smaller
+     */
+    inline size_t ringBytesFor(size_t bytesPerSecond, float seconds, unsigned int latencyBoundMs) {
+        size_t size = calculateBufferSize(bytesPerSecond, seconds);
+        if (latencyBoundMs > 0) {
+            size_t bounded = static_cast<size_t>(bytesPerSecond * (latencyBoundMs / 1000.0) * RING_LATENCY_HEADROOM);
+            size = std::min(size, std::max(bounded, MIN_CONTROLLED_RING_BYTES));
+        }
+        return size;
+    }
+
+    /**
+     * Ring size (power of two) needed by the largest format that can arrive.
+     * PCM is counted at 4 bytes per sample whatever the source bit depth:
+     * DirettaSync widens 16-bit input to 32-bit for targets without 16-bit.
+     */
+    inline size_t maxRingBytes(uint32_t maxSampleRate, int channels, unsigned int latencyBoundMs = 0) {
+        size_t pcm = ringBytesFor(static_cast<size_t>(maxSampleRate) * channels * 4,
+                                  PCM_BUFFER_SECONDS, latencyBoundMs);
+        uint64_t dsdRate = std::min<uint64_t>(MAX_DSD_RATE, static_cast<uint64_t>(maxSampleRate) * 32);
+        size_t dsd = ringBytesFor(static_cast<size_t>(dsdRate / 8) * channels, DSD_BUFFER_SECONDS, latencyBoundMs);
+
+        size_t bytes = std::max(pcm, dsd);
+        size_t pow2 = 1;
+        while (pow2 < bytes) pow2 <<= 1;
+        return pow2;
     }
 
     // Calculate DSD samples per call based on rate
@@ -236,7 +305,7 @@ namespace DirettaBuffer {
 
         // Limits
         constexpr size_t MIN_DSD_SAMPLES = 8192;   // ~3ms at DSD64
-        constexpr size_t MAX_DSD_SAMPLES = 131072; // ~46ms at DSD64, ~3ms at DSD1024
+        constexpr size_t MAX_DSD_SAMPLES = 524288; // ~12ms up to DSD1024
 
         // Calculate samples for target duration
         // DSD sample rate is the 1-bit rate (e.g., 2822400 for DSD64)
@@ -251,6 +320,16 @@ namespace DirettaBuffer {
 
         return samplesPerCall;
     }
+
+    // DSD rate as a multiple of DSD64 in its clock family: 1 (DSD64) to 16 (DSD1024)
+    inline int dsdMultiplier(uint32_t dsdSampleRate) {
+        uint32_t dsd64 = (dsdSampleRate % 48000 == 0) ? 3072000 : 2822400;
+        return std::max(1, static_cast<int>(dsdSampleRate / dsd64));
+    }
+
+    // Target reset delays after a DSD format switch grow with the rate up to
+    // DSD512 (1.6 s); DSD1024 DACs are not slower to re-lock than that
+    constexpr int MAX_RESET_DELAY_MULTIPLIER = 8;
 }
 
 //=============================================================================
@@ -276,12 +355,129 @@ private:
     int m_efficientMTU;
 };
 
+//=============================================================================
+// Sync Worker Scheduling
+//=============================================================================
+
+namespace DirettaWorker {
+    constexpr int FIFO_FALLBACK_PRIORITY = 50;   // Used if SCHED_DEADLINE is refused
+
+    // Not streaming (before open, paused, closed): the worker parks on a
+    // condition variable, waking at this interval only to service the SDK
+    constexpr int IDLE_PARK_MS = 50;
+
+    // Streaming: several activations per Diretta cycle, so packet timing
+    // resolution stays well below the cycle time. SCHED_FIFO sleeps on an
+    // absolute grid with this period, SCHED_DEADLINE uses it as dl_period.
+    constexpr unsigned int ACTIVATIONS_PER_CYCLE = 8;
+    constexpr unsigned int MIN_PERIOD_US = 100;
+    constexpr unsigned int MAX_PERIOD_US = 1000;
+    constexpr unsigned int RUNTIME_PCT = 30;     // Budget per period
+    constexpr unsigned int DEADLINE_PCT = 50;    // Relative deadline
+    constexpr int MAX_SYNC_CALLS_PER_PERIOD = 8;
+
+    inline unsigned int periodUs(unsigned int cycleTimeUs) {
+        unsigned int period = cycleTimeUs / ACTIVATIONS_PER_CYCLE;
+        return std::max(MIN_PERIOD_US, std::min(period, MAX_PERIOD_US));
+    }
+}
+
+/**
+ * @brief Wake-up lateness of the sync worker (actual minus intended wake time)
+ *
+ * Written by the worker thread only (plain relaxed stores), read by dumpStats().
+ */
+struct WakeupStats {
+    static constexpr int BUCKETS = 6;
+    static constexpr uint32_t BUCKET_LIMIT_US[BUCKETS - 1] = {10, 50, 100, 500, 1000};
+
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> maxNs{0};
+    std::atomic<uint64_t> histogram[BUCKETS]{};
+
+    void record(int64_t latenessNs) {
+        uint64_t ns = latenessNs > 0 ? static_cast<uint64_t>(latenessNs) : 0;
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && ns >= BUCKET_LIMIT_US[bucket] * 1000ULL) bucket++;
+
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        totalNs.store(totalNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+        if (ns > maxNs.load(std::memory_order_relaxed)) maxNs.store(ns, std::memory_order_relaxed);
+        histogram[bucket].store(histogram[bucket].load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+    }
+
+    void reset() {
+        count.store(0, std::memory_order_relaxed);
+        totalNs.store(0, std::memory_order_relaxed);
+        maxNs.store(0, std::memory_order_relaxed);
+        for (auto& h : histogram) h.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Regularity of the SDK's getNewStream() callbacks (adaptive cycle time)
+ *
+ * Written by the worker thread only. The controlling thread asks for a reset
+ * (requestReset()), the worker performs it at its next record(), so counts
+ * and the previous timestamp always restart together.
+ */
+struct CallbackStats {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sumUs{0};
+    std::atomic<uint64_t> sumSqUs{0};
+    std::atomic<uint64_t> late{0};
+    std::atomic<int64_t> lateNs{0};        // Interval counted as late
+    std::atomic<bool> resetRequested{false};
+    int64_t lastNs = 0;                    // Worker thread only
+
+    // Gaps this long are a stop or pause, not a callback interval
+    static constexpr int64_t IDLE_NS = 100000000;
+
+    void record(int64_t nowNs) {
+        if (resetRequested.exchange(false, std::memory_order_acquire)) {
+            count.store(0, std::memory_order_relaxed);
+            sumUs.store(0, std::memory_order_relaxed);
+            sumSqUs.store(0, std::memory_order_relaxed);
+            late.store(0, std::memory_order_relaxed);
+            lastNs = 0;
+        }
+        int64_t last = lastNs;
+        lastNs = nowNs;
+        if (last == 0) return;
+        int64_t interval = nowNs - last;
+        if (interval <= 0 || interval >= IDLE_NS) return;
+
+        uint64_t us = static_cast<uint64_t>(interval / 1000);
+        sumUs.store(sumUs.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+        sumSqUs.store(sumSqUs.load(std::memory_order_relaxed) + us * us, std::memory_order_relaxed);
+        if (interval > lateNs.load(std::memory_order_relaxed)) {
+            late.store(late.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void requestReset(int64_t lateThresholdNs) {
+        lateNs.store(lateThresholdNs, std::memory_order_relaxed);
+        resetRequested.store(true, std::memory_order_release);
+    }
+};
+
 //=============================================================================
 // Transfer Mode
 //=============================================================================
 
 enum class DirettaTransferMode { FIX_AUTO, VAR_AUTO, VAR_MAX, AUTO };
 
+//=============================================================================
+// Streaming (non-temporal) stores for ring writes
+//=============================================================================
+
+// Auto: stream once the ring holds more than the last-level cache ahead of
+// the reader. On/Off: always (writes of 1 KB and more) / never.
+enum class NtStoreMode { Auto, On, Off };
+
 //=============================================================================
 // Configuration
 //=============================================================================
@@ -296,6 +492,50 @@ struct DirettaConfig {
     unsigned int dacStabilizationMs = DirettaBuffer::DAC_STABILIZATION_MS;
     unsigned int onlineWaitMs = DirettaBuffer::ONLINE_WAIT_MS;
     unsigned int formatSwitchDelayMs = DirettaBuffer::FORMAT_SWITCH_DELAY_MS;
+
+    // Thread placement (applied by the threads themselves at creation)
+    ThreadPolicy workerPolicy = ThreadPolicy::fifo(50);
+    ThreadPolicy sdkPolicy;    // SDK-internal threads, identified after open
+
+    // Ring and stream buffer are carved from an arena in enable(), sized for
+    // the largest format squeezelite may send (its -r maximum, stereo)
+    uint32_t maxSampleRate = 768000;
+    int maxChannels = 2;
+    bool hugePages = false;    // Back the arena with huge pages (hugetlbfs, else THP)
+    NtStoreMode ntStores = NtStoreMode::Auto;
+
+    // Parallel conversion of large pushes (owned by the caller, shared by all
+    // rings fed from the same thread); nullptr = convert on the caller
+    ConvertPool* convertPool = nullptr;
+
+    // Ring fill to hold during playback (admissionLevel()); 0 = fill up to
+    // PRODUCER_HIGH_WATER. Also caps prefill and the rebuffer threshold.
+    unsigned int targetLatencyMs = 0;
+
+    // Adaptive buffer: learn the latency target (and so the prefill) per
+    // rate family within [adaptiveMinMs, adaptiveMaxMs], starting from what
+    // was learned before (BufferLearning), else from targetLatencyMs, else
+    // from the upper bound. Learned values are kept under stateDir.
+    bool adaptiveBuffer = false;
+    unsigned int adaptiveMinMs = DirettaBuffer::ADAPTIVE_MIN_MS;
+    unsigned int adaptiveMaxMs = DirettaBuffer::ADAPTIVE_MAX_MS;
+    std::string stateDir;
+
+    // Largest ring share setLatencyBudget() will be given (--latency-budget);
+    // 0 = none. Like targetLatencyMs and adaptiveMaxMs it bounds the ring size.
+    unsigned int latencyBudgetMs = 0;
+
+    // Adaptive cycle time: try cycle times within [adaptiveCycleMinUs,
+    // adaptiveCycleMaxUs] (0 = half / twice the calculated one) and, with
+    // transferMode AUTO, the transfer modes, one setting per session, and
+    // keep what gave the most regular callbacks (CycleTuning)
+    bool adaptiveCycle = false;
+    unsigned int adaptiveCycleMinUs = 0;
+    unsigned int adaptiveCycleMaxUs = 0;
+
+    // Record callback regularity (callbackResult()) without adaptiveCycle,
+    // e.g. for calibration runs
+    bool measureCallbacks = false;
 };
 
 //=============================================================================
@@ -382,9 +622,13 @@ public:
      * @brief Send audio data (push model)
      * @param data Audio buffer
      * @param numSamples Number of samples (for PCM) or special encoding for DSD
+     * @param contentOr If set, OR-ed with the input words consumed (0 stays 0
+     *                  for digital silence), from the pass that packs,
+     *                  upsamples or copies them. PCM only: for DSD the
+     *                  de-interleave that built the planar block has it.
      * @return Bytes consumed
      */
-    size_t sendAudio(const uint8_t* data, size_t numSamples);
+    size_t sendAudio(const uint8_t* data, size_t numSamples, uint32_t* contentOr = nullptr);
 
     float getBufferLevel() const;
     const AudioFormat& getFormat() const { return m_currentFormat; }
@@ -408,6 +652,40 @@ public:
      */
     size_t getPrefillTarget() const { return m_prefillTarget; }
 
+    /**
+     * @brief SDK callback regularity, and underruns playback recovered from
+     *
+     * Callbacks since enable() with DirettaConfig::measureCallbacks, since the
+     * current cycle session with adaptiveCycle; underruns since enable().
+     */
+    CycleTuning::Result callbackResult() const;
+
+    /**
+     * @brief Cycle time and transfer mode (never AUTO) set up by the last open()
+     */
+    CycleTuning::Settings cycleSettings() const { return m_cycleSettings; }
+
+    const std::string& targetName() const { return m_targetName; }
+
+    /**
+     * @brief Ring latency target for the next open(), unless targetLatencyMs
+     *        is lower (--latency-budget: the ring's share for the format);
+     *        0 = none
+     *
+     * With adaptiveBuffer this is where a family with nothing learned yet
+     * starts, and the upper bound for learned targets and for growth after
+     * an underrun.
+     */
+    void setLatencyBudget(unsigned int ms) { m_latencyBudgetMs.store(ms, std::memory_order_relaxed); }
+
+    /**
+     * @brief Latency target learned for this format's rate family with
+     *        adaptiveBuffer, 0 if none
+     */
+    unsigned int learnedLatencyMs(bool dsd, uint32_t rate) const {
+        return m_bufferLearning.learnedMs(BufferLearning::rateFamily(dsd, rate));
+    }
+
     /**
      * @brief Set S24 pack mode hint for 24-bit audio
      *
@@ -451,11 +729,74 @@ public:
         m_spaceAvailable.notify_one();
     }
 
+    /**
+     * @brief eventfd that becomes readable when an armed space wait is met
+     *
+     * For producers running an epoll loop instead of waitForSpace(). The
+     * consumer writes it at most once per armSpaceEvent(), so the worker
+     * makes no syscall while nobody is waiting. Read it to clear.
+     */
+    int spaceEventFd() const { return m_spaceEventFd; }
+
+    /**
+     * @brief Have the consumer signal spaceEventFd() once the fill drops to level
+     * @param level Buffer level (0.0-1.0, as getBufferLevel()) to wait for
+     * @return false if already at or below level (nothing armed, don't wait)
+     */
+    bool armSpaceEvent(float level);
+
+    /**
+     * @brief Fill level up to which the producer may push (for armSpaceEvent())
+     *
+     * PRODUCER_HIGH_WATER, or with DirettaConfig::targetLatencyMs the level
+     * that holds the mean fill at that latency: the producer is gated at
+     * the target minus half a push, plus a trim that the producer thread
+     * integrates every LATENCY_CONTROL_MS from the fill the worker saw at
+     * each pop. The trim only moves while the producer was actually gated,
+     * so a producer slower than real time does not wind it up. In a period
+     * the producer ran ungated, its rate ratio to the consumer biases the
+     * level against the drift it predicts (up while pops outpace pushes,
+     * down while the producer catches up), ahead of the trim.
+     * With DirettaConfig::adaptiveBuffer the target itself moves: up after
+     * an underrun, down while playback stays clean, never below twice the
+     * worst producer stall plus consumer interval jitter seen.
+     * Producer thread only.
+     */
+    float admissionLevel();
+
+    //=========================================================================
+    // Fan-out (one stream, several targets)
+    //=========================================================================
+
+    /**
+     * @brief Play this instance's stream on follower's target as well
+     *
+     * The follower's worker reads this ring through a tap (its own read
+     * position, no copy); nothing is sent to the follower directly, but it is
+     * opened and released with the same format as this instance. All
+     * consumers start on the same byte: after prefill this instance holds its
+     * first buffer until every follower is online (at most
+     * FANOUT_START_TIMEOUT_MS). Call before the follower's enable(), which
+     * then carves no ring of its own.
+     * @return false if the ring has no tap left
+     */
+    bool addFanoutFollower(DirettaSync& follower);
+
+    /**
+     * @brief After a follower's open(): its sink negotiated the source's ring
+     *        layout (sample width, channels, DSD bit order). If not, its
+     *        target cannot play the shared ring and should be released.
+     */
+    bool fanoutFormatMatches() const;
+
+    bool isFanoutFollower() const { return m_fanoutSource != nullptr; }
+
     //=========================================================================
     // Target Management
     //=========================================================================
 
     void setTargetIndex(int index) { m_targetIndex = index; }
+    int getTargetIndex() const { return m_targetIndex; }
     void setMTU(uint32_t mtu) { m_mtuOverride = mtu; }
     bool verifyTargetAvailable();
     static void listTargets();
@@ -481,6 +822,11 @@ private:
     bool reopenForFormatChange();
     void fullReset();
     void shutdownWorker();
+    void workerLoop();
+    bool applyWorkerSchedule(unsigned int cycleTimeUs, int64_t& periodNs);
+    void setWorkerStreaming(bool streaming);
+    void wakeWorker();
+    void parkWorker();
 
     void configureSinkPCM(int rate, int channels, int inputBits, int& acceptedBits);
     void configureSinkDSD(uint32_t dsdBitRate, int channels, const AudioFormat& format);
@@ -490,12 +836,50 @@ private:
                                    bool isDSD, bool isCompressed);
     void beginReconfigure();
     void endReconfigure();
+    bool ringQuiesced() const;    // Inside a ReconfigureGuard, no reader or writer left in the ring
 
     void applyTransferMode(DirettaTransferMode mode, ACQUA::Clock cycleTime);
     unsigned int calculateCycleTime(uint32_t sampleRate, int channels, int bitsPerSample);
     void requestShutdownSilence(int buffers);
     bool waitForOnline(unsigned int timeoutMs);
     void logSinkCapabilities();
+    void placeSdkThreads();
+    void allocateArena();
+    void allocateSilenceBlocks();
+    void configureStreamingStores();
+    void openWorkerCacheCounters();
+    bool fanoutStartGate();
+    void recordFanoutLag(int bytesPerBuffer);
+    void leaveFanout();
+    void reportStreamEvents();
+    void reserveStreamBuffer(size_t bytes);
+    void allowFanoutJoin();
+    void signalSpaceEvent();
+    unsigned int latencyBoundMs() const;
+    void resetLatencyControl(size_t bytesPerSecond, size_t bytesPerBuffer, bool dsd, uint32_t rate);
+    void updateLatencyControl(std::chrono::steady_clock::time_point now);
+    void adaptLatencyTarget(std::chrono::steady_clock::time_point now, double halfPushBytes);
+    void applyLatencyTarget(double ms);
+    void rememberLatencyTarget();
+    DirettaTransferMode resolveTransferMode(DirettaTransferMode mode) const;
+    void beginCycleSession(bool dsd, uint32_t rate, unsigned int& cycleTimeUs, DirettaTransferMode& mode);
+    void restartCycleSession();
+    void endCycleSession();
+    bool cycleRetunePending() const;
+
+    // open(): worker at the streaming rate, parked again unless dismissed
+    class WorkerStreamingGuard {
+    public:
+        explicit WorkerStreamingGuard(DirettaSync& sync) : sync_(sync) { sync_.setWorkerStreaming(true); }
+        ~WorkerStreamingGuard() { if (armed_) sync_.setWorkerStreaming(false); }
+        void dismiss() { armed_ = false; }
+        WorkerStreamingGuard(const WorkerStreamingGuard&) = delete;
+        WorkerStreamingGuard& operator=(const WorkerStreamingGuard&) = delete;
+
+    private:
+        DirettaSync& sync_;
+        bool armed_ = true;
+    };
 
     class ReconfigureGuard {
     public:
@@ -543,6 +927,36 @@ private:
     std::mutex m_configMutex;
     std::atomic<bool> m_reconfiguring{false};
     mutable std::atomic<int> m_ringUsers{0};
+    std::atomic<bool> m_workerPlacementReported{false};
+    bool m_sdkPlacementReported = false;
+
+    // Worker scheduling: open() publishes the cycle time, the worker re-applies
+    // its SCHED_DEADLINE parameters when the generation changes
+    std::atomic<unsigned int> m_workerCycleUs{2620};
+    std::atomic<uint32_t> m_workerSchedGen{0};
+    std::atomic<bool> m_workerDeadlineActive{false};
+    std::atomic<unsigned int> m_workerPeriodUs{0};
+    bool m_deadlineWarned = false;    // Worker thread only
+    WakeupStats m_wakeStats;
+    CallbackStats m_callbackStats;
+
+    // Worker parking: set by open()/startPlayback()/resumePlayback(), cleared
+    // once the stream is stopped. Without it the worker parks instead of polling.
+    std::atomic<bool> m_workerStreaming{false};
+    std::mutex m_workerParkMutex;
+    std::condition_variable m_workerParkCv;
+    std::atomic<uint64_t> m_workerParks{0};         // Worker thread writes only
+    std::atomic<uint64_t> m_workerParkWakes{0};     // Parks ended by wakeWorker()
+    std::atomic<int64_t> m_workerIdleCpuNs{0};
+    std::atomic<int64_t> m_workerIdleWallNs{0};
+
+    // Worker cache misses (perf), for judging streaming stores: opened by
+    // each new worker thread, read by dumpStats()
+    PerfCounterGroup m_workerCache;
+    int m_workerL1dMiss = -1;
+    int m_workerLlcMiss = -1;
+    int m_workerLlcAccess = -1;
+    std::atomic<bool> m_workerCacheReady{false};
 
     // G1: Flow control for DSD atomic sends
     // Condition variable allows producer to wait for buffer space
@@ -550,6 +964,11 @@ private:
     std::mutex m_flowMutex;
     std::condition_variable m_spaceAvailable;
 
+    // Space wait for epoll-driven producers (armSpaceEvent)
+    int m_spaceEventFd = -1;
+    std::atomic<bool> m_spaceEventArmed{false};
+    std::atomic<size_t> m_spaceEventUsed{0};     // Wake when fill <= this (bytes)
+
     // G1: Condition variable for interruptible format transition waits
     // Allows blocking waits to be interrupted on shutdown rather than sleeping
     std::mutex m_transitionMutex;
@@ -559,10 +978,31 @@ private:
     // Ring buffer
     DirettaRingBuffer m_ringBuffer;
 
+    // Startup arena: ring storage and stream buffer, allocated in enable()
+    AudioArena m_arena;
+
     // SDK 148: Persistent stream buffer to bypass corrupted Stream class
     // After Stop→Play, SDK 148's Stream objects are in corrupted state.
     // We manage our own buffer and directly set diretta_stream.Data.P/Size fields.
+    // Normally carved from m_arena; m_streamData is the heap fallback.
+    // configureRing*() grows the fallback for a larger format
+    // (reserveStreamBuffer()), never getNewStream(); the previous one stays
+    // alive until the next growth, as the worker hands it out until it sees
+    // the new generation.
+    uint8_t* m_streamBuffer = nullptr;
+    size_t m_streamCapacity = 0;
     std::vector<uint8_t> m_streamData;
+    std::vector<uint8_t> m_streamDataRetired;
+
+    // Pre-filled silence (PCM 0x00, DSD 0x69), page-aligned and written once
+    // in enable(): in the non-playing states getNewStream() points Data.P at
+    // the block for the current format instead of filling the stream buffer.
+    // Carved from m_arena; m_silenceData is the heap fallback.
+    static constexpr size_t SILENCE_BLOCK_ALIGNMENT = 4096;
+    uint8_t* m_silencePcm = nullptr;
+    uint8_t* m_silenceDsd = nullptr;
+    size_t m_silenceCapacity = 0;
+    std::vector<uint8_t, AlignedAllocator<uint8_t, SILENCE_BLOCK_ALIGNMENT>> m_silenceData;
 
     // Format parameters (atomic snapshot for audio thread)
     std::atomic<int> m_sampleRate{44100};
@@ -585,6 +1025,13 @@ private:
     // G2 fix: Made atomic to ensure proper visibility across threads
     std::atomic<DirettaRingBuffer::DSDConversionMode> m_dsdConversionMode{DirettaRingBuffer::DSDConversionMode::Passthrough};
 
+    // Push pipeline for the current format (input x output conversion x
+    // channel layout), selected in configureRingPCM()/configureRingDSD()
+    using PushFn = size_t (*)(DirettaRingBuffer& ring, const uint8_t* data, size_t numSamples,
+                              int numChannels, int bytesPerSample, size_t& inputBytes, uint32_t* contentOr);
+    std::atomic<PushFn> m_pushFn{nullptr};
+    std::atomic<const char*> m_pushLabel{"PCM"};
+
     // Format generation counter - incremented on ANY format change
     // Allows sendAudio to skip reloading atomics when format hasn't changed
     std::atomic<uint32_t> m_formatGeneration{0};
@@ -592,22 +1039,23 @@ private:
     // Cached format values for sendAudio fast path (updated when generation changes)
     // Protected by generation counter check - no race with configureRingXXX
     uint32_t m_cachedFormatGen{0};
-    bool m_cachedDsdMode{false};
-    bool m_cachedPack24bit{false};
-    bool m_cachedUpsample16to32{false};
-    bool m_cachedUpsample16to24{false};
+    PushFn m_cachedPushFn{nullptr};
+    const char* m_cachedPushLabel{"PCM"};
     int m_cachedChannels{2};
     int m_cachedBytesPerSample{2};
-    DirettaRingBuffer::DSDConversionMode m_cachedDsdConversionMode{DirettaRingBuffer::DSDConversionMode::Passthrough};
 
     // C1: Consumer generation counter for getNewStream fast path
     // Incremented alongside m_formatGeneration in configureRingXXX
     std::atomic<uint32_t> m_consumerStateGen{0};
 
-    // Cached consumer state (only accessed by worker thread)
-    uint32_t m_cachedConsumerGen{0};
+    // Cached consumer state (only accessed by worker thread); the first call
+    // always loads it
+    uint32_t m_cachedConsumerGen{UINT32_MAX};
+    uint8_t* m_cachedStreamBuffer{nullptr};
+    size_t m_cachedStreamCapacity{0};
     int m_cachedBytesPerBuffer{176};
     uint8_t m_cachedSilenceByte{0};
+    uint8_t* m_cachedSilenceBlock{nullptr};
     bool m_cachedConsumerIsDsd{false};
     int m_cachedConsumerSampleRate{44100};
     int m_cachedBytesPerFrame{0};
@@ -625,7 +1073,99 @@ private:
     std::atomic<int> m_streamCount{0};
     std::atomic<int> m_pushCount{0};
     std::atomic<uint32_t> m_underrunCount{0};
+    std::atomic<uint32_t> m_recoveredUnderruns{0};       // Rebuffering completed (not the end of a stream)
+    std::atomic<uint32_t> m_rebufferStarts{0};           // Underruns that entered rebuffering
+    std::atomic<size_t> m_rebufferStartAvail{0};         // Worker: fill at the last start/recovery,
+    std::atomic<size_t> m_rebufferEndAvail{0};           // for reportStreamEvents()
+    std::atomic<size_t> m_rebufferEndThreshold{0};
+    uint32_t m_reportedRebufferStarts = 0;               // Producer thread only
+    uint32_t m_reportedRecoveries = 0;
     std::atomic<bool> m_rebuffering{false};              // Rebuffering after sustained underrun
+    std::atomic<size_t> m_rebufferCap{SIZE_MAX};         // Rebuffer threshold limit (targetLatencyMs)
+
+    // Fill-level controller: the worker records the fill at each pop (single
+    // writer; min/max are taken and reset by the producer), the producer
+    // trims its admission level from them (admissionLevel())
+    std::atomic<uint64_t> m_fillSum{0};
+    std::atomic<uint64_t> m_fillSamples{0};
+    std::atomic<uint64_t> m_poppedBytes{0};
+    std::atomic<size_t> m_fillMin{SIZE_MAX};
+    std::atomic<size_t> m_fillMax{0};
+
+    struct LatencyControl {
+        size_t targetBytes = 0;              // 0 = controller off
+        size_t minGate = 0;                  // Admission level bounds (bytes)
+        size_t maxGate = 0;
+        double bytesPerSecond = 0.0;
+        FillControl::State fill;             // Trim, rate ratio and bias (FillControl::step())
+        float level = DirettaBuffer::PRODUCER_HIGH_WATER;
+        std::chrono::steady_clock::time_point windowStart;
+        uint64_t lastFillSum = 0;
+        uint64_t lastFillSamples = 0;
+        uint64_t lastPopped = 0;
+        uint64_t pushedBytes = 0;            // Producer side, this period
+        uint64_t pushes = 0;
+        uint64_t gatedWaits = 0;
+        // Last period, for dumpStats()
+        double meanFill = 0.0;
+        size_t minFill = 0;
+        size_t maxFill = 0;
+        // Adaptive buffer
+        std::string family;                  // BufferLearning::rateFamily(), "" = not adaptive
+        double targetMs = 0.0;
+        double maxMs = 0.0;                  // adaptiveMaxMs, or the latency budget if lower
+        size_t bytesPerBuffer = 0;
+        std::chrono::steady_clock::time_point lastPush;
+        std::chrono::steady_clock::time_point lastAdapt;
+        uint32_t underruns = 0;              // m_underrunCount at the last check
+        double stallMs = 0.0;                // Worst since the last shrink step
+        double jitterMs = 0.0;
+        double peakStallMs = 0.0;            // Worst this format, as persisted
+        double peakJitterMs = 0.0;
+        bool settled = false;                // Played clean long enough, or grew: worth persisting
+    };
+    LatencyControl m_latency;
+    BufferLearning m_bufferLearning;
+    std::atomic<unsigned int> m_latencyBudgetMs{0};     // setLatencyBudget()
+    std::string m_targetName;
+
+    // Adaptive buffer: longest interval between two pops (worker writes;
+    // the producer takes and resets it), and the previous pop (worker only)
+    std::atomic<int64_t> m_popIntervalMaxNs{0};
+    int64_t m_lastPopNs = 0;
+
+    // Adaptive cycle time: the session running since the last open()
+    struct CycleSession {
+        bool active = false;
+        std::string key;                     // CycleTuning::rateKey()
+        CycleTuning::Settings settings;
+        CycleTuning::Settings base;          // Calculated cycle time, resolved mode
+        uint32_t underruns = 0;              // m_recoveredUnderruns at the start
+    };
+    CycleTuning m_cycleTuning;
+    CycleSession m_cycleSession;
+    CycleTuning::Settings m_cycleSettings;   // Set up by the last open()
+
+    // Fan-out: the followers reading this ring, or the source this
+    // instance follows (set before the first open(), fixed afterwards)
+    std::vector<DirettaSync*> m_fanoutFollowers;
+    DirettaSync* m_fanoutSource = nullptr;
+    int m_fanoutTap = -1;
+    std::mutex m_fanoutMutex;                    // Source: joins vs. followers leaving
+    std::atomic<bool> m_fanoutReady{false};      // Follower: online, waiting for the start
+    bool m_fanoutLeaving = false;                // Follower: tap left, no joins (source's m_fanoutMutex)
+    std::atomic<bool> m_fanoutStarted{false};    // Source: consumers released
+    std::atomic<uint32_t> m_fanoutAligned{0};    // Source: followers joined at the start
+    bool m_fanoutWaiting = false;                // Source worker only
+    std::chrono::steady_clock::time_point m_fanoutWaitStart;
+
+    // Follower lag behind the source's reader (worker writes, dumpStats reads)
+    std::atomic<int64_t> m_fanoutLagUs{0};
+    std::atomic<int64_t> m_fanoutLagMaxUs{0};
+    std::atomic<int64_t> m_fanoutLagSumUs{0};
+    std::atomic<uint64_t> m_fanoutLagSamples{0};
+    std::atomic<uint32_t> m_fanoutLateJoins{0};
+    std::atomic<uint32_t> m_fanoutResyncs{0};
 };
 
 #endif // DIRETTA_SYNC_H
@@ -0,0 +1,83 @@
+/**
+ * @file FillControl.h
+ * @brief One period of the ring fill-level controller (--target-latency)
+ *
+ * DirettaSync::updateLatencyControl() collects a period's mean fill, bytes
+ * pushed and popped and whether the admission gate held the producer back,
+ * and step() turns them into the next gate, in bytes:
+ *
+ *   gate = target - half an average push + trim + rate bias
+ *
+ * The trim integrates the fill error only in periods where the gate held
+ * the producer back (bounded to half the target). In a period the producer
+ * ran ungated, its push/pop ratio biases the gate against the drift it
+ * predicts (bounded to biasMax of the target); otherwise the bias decays.
+ * Arithmetic only, no SDK or atomics.
+ */
+
+#ifndef SQUEEZE2DIRETTA_FILLCONTROL_H
+#define SQUEEZE2DIRETTA_FILLCONTROL_H
+
+#include <algorithm>
+#include <cstdint>
+
+namespace FillControl {
+
+struct Period {
+    double targetBytes = 0.0;
+    double meanFill = 0.0;           // Mean fill the worker saw at its pops
+    double consumedBytes = 0.0;      // Popped this period
+    double pushedBytes = 0.0;        // Pushed this period
+    uint64_t pushes = 0;
+    uint64_t gatedWaits = 0;         // Times the gate held the producer back
+    double minGate = 0.0;
+    double maxGate = 0.0;
+};
+
+struct State {
+    double trim = 0.0;               // Integrated correction (bytes)
+    double rateBias = 0.0;           // Bias from the push/pop ratio (bytes)
+    double rateRatio = 0.0;          // Pushed / popped, last period
+};
+
+/**
+ * @brief Half an average push this period (the gate's swing below target)
+ */
+inline double halfPush(const Period& period) {
+    return period.pushes > 0 ? period.pushedBytes / (2.0 * period.pushes) : 0.0;
+}
+
+/**
+ * @brief Advance the controller by one period
+ * @param gain Share of the fill error folded into the trim per period
+ * @param biasMax Largest rate bias, as a share of the target
+ * @return Admission gate in bytes, within [minGate, maxGate]
+ */
+inline double step(State& state, const Period& period, double gain, double biasMax) {
+    state.rateRatio = period.consumedBytes > 0.0 ? period.pushedBytes / period.consumedBytes : 0.0;
+
+    // Only while the gate was what held the producer back
+    if (period.gatedWaits > 0) {
+        double limit = period.targetBytes / 2.0;
+        state.trim += gain * (period.targetBytes - period.meanFill);
+        state.trim = std::min(std::max(state.trim, -limit), limit);
+    }
+    // A producer that ran free this period (never gated) sets the pace: at
+    // (ratio - 1) x consumed per period the fill is about to drop, or to
+    // overshoot, so lean the level against that before the trim sees it.
+    // While the gate paces the producer the ratio only echoes the gate, and
+    // the bias decays.
+    if (period.gatedWaits == 0 && period.pushedBytes > 0.0) {
+        double biasLimit = period.targetBytes * biasMax;
+        state.rateBias = std::min(std::max((1.0 - state.rateRatio) * period.consumedBytes, -biasLimit), biasLimit);
+    } else {
+        state.rateBias /= 2.0;
+    }
+
+    double gate = period.targetBytes - halfPush(period) + state.trim + state.rateBias;
+    return std::min(std::max(gate, period.minGate), period.maxGate);
+}
+
+} // namespace FillControl
+
+#endif // SQUEEZE2DIRETTA_FILLCONTROL_H
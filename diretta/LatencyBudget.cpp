@@ -0,0 +1,30 @@
+/**
+ * @file LatencyBudget.cpp
+ * @brief Split of one latency budget across squeezelite, the pipe and the ring
+ */
+
+#include "LatencyBudget.h"
+
+#include <algorithm>
+
+namespace LatencyBudget {
+
+unsigned int outputKb(double maxRate, unsigned int budgetMs) {
+    double bytes = maxRate * OUTPUT_FRAME_BYTES * budgetMs * OUTPUT_SHARE / 1000.0;
+    return std::max(OUTPUT_MIN_KB, static_cast<unsigned int>(bytes / 1024.0));
+}
+
+Split plan(unsigned int budgetMs, unsigned int outputKb, uint32_t sampleRate, double ringNeedMs) {
+    Split split;
+    split.outputMs = outputKb * 1024.0 * 1000.0 / (static_cast<double>(sampleRate) * OUTPUT_FRAME_BYTES);
+    split.availableMs = budgetMs - split.outputMs;
+    split.ringNeedMs = ringNeedMs;
+    split.pipeMs = std::min(budgetMs * PIPE_SHARE, split.availableMs - ringNeedMs);
+    return split;
+}
+
+double ringMs(const Split& split, double pipeActualMs) {
+    return std::max(split.ringNeedMs, split.availableMs - pipeActualMs);
+}
+
+} // namespace LatencyBudget
@@ -0,0 +1,55 @@
+/**
+ * @file LatencyBudget.h
+ * @brief Split of one latency budget (--latency-budget) across squeezelite,
+ *        the pipe and the ring
+ *
+ * The budget covers the audio held between squeezelite's decoder and the
+ * target. A quarter is squeezelite's output buffer, sized once in bytes at
+ * the -r maximum (-b) but at least OUTPUT_MIN_KB, so at lower rates it holds
+ * more time. Per format that real duration comes off the budget first. The
+ * ring then gets what measured jitter needs for its rate family (learned
+ * with --adaptive-buffer, else the adaptive minimum), the pipe up to another
+ * quarter, and the ring whatever is left on top.
+ *
+ * Arithmetic only: the wrapper sizes the pipe from pipeMs (which may round
+ * it up to its floor of two squeezelite writes) and passes the result to
+ * ringMs(). Needs neither the Diretta SDK nor the rest of the wrapper.
+ */
+
+#ifndef SQUEEZE2DIRETTA_LATENCYBUDGET_H
+#define SQUEEZE2DIRETTA_LATENCYBUDGET_H
+
+#include <cstdint>
+
+namespace LatencyBudget {
+    constexpr double OUTPUT_SHARE = 0.25;
+    constexpr double PIPE_SHARE = 0.25;
+    constexpr unsigned int OUTPUT_MIN_KB = 512;     // Above every decoder's min_space
+    constexpr unsigned int OUTPUT_FRAME_BYTES = 8;  // Squeezelite's output buffer: S32 stereo
+
+    struct Split {
+        double outputMs = 0.0;       // Squeezelite's output buffer at this rate
+        double availableMs = 0.0;    // Budget left for the pipe and the ring
+        double ringNeedMs = 0.0;     // Ring floor (learned or adaptive minimum)
+        double pipeMs = 0.0;         // Pipe share to ask for
+    };
+
+    /**
+     * @brief Squeezelite's -b output buffer in KB: its share of the budget
+     *        at maxRate, never below OUTPUT_MIN_KB
+     */
+    unsigned int outputKb(double maxRate, unsigned int budgetMs);
+
+    /**
+     * @brief Shares for a new format, before the pipe is sized
+     */
+    Split plan(unsigned int budgetMs, unsigned int outputKb, uint32_t sampleRate, double ringNeedMs);
+
+    /**
+     * @brief Ring share once the pipe's real size (pipeActualMs) is known:
+     *        the rest of the budget, but at least ringNeedMs
+     */
+    double ringMs(const Split& split, double pipeActualMs);
+}
+
+#endif // SQUEEZE2DIRETTA_LATENCYBUDGET_H
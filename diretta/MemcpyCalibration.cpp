@@ -0,0 +1,215 @@
+/**
+ * @file MemcpyCalibration.cpp
+ * @brief Pick the memcpy_audio() strategy by measurement instead of CPUID
+ */
+
+#include "MemcpyCalibration.h"
+#include "CpuInfo.h"
+#include "LogLevel.h"
+#include "StateFile.h"
+#include "memcpyfast_audio.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+namespace {
+
+namespace Calibration {
+    // Per-cycle buffers (44.1k/16-bit, 44.1k/32-bit, 192k/32-bit, DSD512,
+    // 768k/32-bit, all stereo) and the wrapper's 16 KB pipe chunk
+    constexpr size_t SIZES[] = {176, 352, 1536, 5648, 6144, 16384};
+    constexpr int SAMPLES = 1000;
+    constexpr int WARMUP_SAMPLES = 50;
+    constexpr int BATCH = 16;                  // Copies per timed sample (clock overhead)
+    constexpr size_t POOL_BYTES = 512 * 1024;  // Walked like the ring, mostly L2-resident
+    constexpr const char* STATE_FILE = "memcpy.state";
+}
+
+const char* const STRATEGY_NAMES[MEMCPY_AUDIO_STRATEGY_COUNT] = {
+    "default", "avx-unrolled", "avx-fixed", "avx-generic", "avx512", "libc", "rep-movsb"
+};
+
+std::vector<int> availableStrategies() {
+    std::vector<int> strategies;
+#if defined(MEMCPY_AUDIO_X86) && defined(__AVX2__)
+    strategies.push_back(MEMCPY_AUDIO_AVX_UNROLLED);
+    strategies.push_back(MEMCPY_AUDIO_AVX_FIXED);
+    strategies.push_back(MEMCPY_AUDIO_AVX_GENERIC);
+#ifdef __AVX512F__
+    if (detect_avx512()) strategies.push_back(MEMCPY_AUDIO_AVX512);
+#endif
+#endif
+    strategies.push_back(MEMCPY_AUDIO_LIBC);
+#ifdef MEMCPY_AUDIO_HAS_REP_MOVSB
+    strategies.push_back(MEMCPY_AUDIO_REP_MOVSB);
+#endif
+    return strategies;
+}
+
+std::string strategyList(const std::vector<int>& strategies) {
+    std::string list;
+    for (int strategy : strategies) {
+        if (!list.empty()) list += ",";
+        list += memcpyStrategyName(strategy);
+    }
+    return list;
+}
+
+int strategyFromName(const std::string& name) {
+    for (int i = 1; i < MEMCPY_AUDIO_STRATEGY_COUNT; i++) {
+        if (name == STRATEGY_NAMES[i]) return i;
+    }
+    return MEMCPY_AUDIO_DEFAULT;
+}
+
+MemcpyTiming timeStrategy(size_t bytes, std::vector<uint8_t>& src, std::vector<uint8_t>& dst) {
+    using namespace Calibration;
+    std::vector<double> samples;
+    samples.reserve(SAMPLES);
+
+    size_t offset = 0;
+    for (int s = 0; s < WARMUP_SAMPLES + SAMPLES; s++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BATCH; i++) {
+            if (offset + bytes > POOL_BYTES) offset = 0;
+            memcpy_audio(dst.data() + offset, src.data() + offset, bytes);
+            offset += bytes;    // Arbitrary alignment, as ring positions are
+        }
+        __asm__ volatile("" : : "r"(dst.data()) : "memory");    // Keep the copies
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (s >= WARMUP_SAMPLES) samples.push_back(ns / BATCH);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    MemcpyTiming timing;
+    timing.bytes = bytes;
+    double sum = 0;
+    for (double ns : samples) sum += ns;
+    timing.meanNs = sum / samples.size();
+    double var = 0;
+    for (double ns : samples) var += (ns - timing.meanNs) * (ns - timing.meanNs);
+    timing.stddevNs = std::sqrt(var / samples.size());
+    timing.p99Ns = samples[samples.size() * 99 / 100];
+    return timing;
+}
+
+// Lower is better: typical time, tail and spread all delay the worker's
+// callback (a strategy with a low mean but erratic timing loses)
+double timingCost(const MemcpyTiming& t) {
+    return t.meanNs + t.p99Ns + t.stddevNs;
+}
+
+std::string todayIso() {
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%d", std::localtime(&now));
+    return date;
+}
+
+} // namespace
+
+const char* memcpyStrategyName(int strategy) {
+    if (strategy < 0 || strategy >= MEMCPY_AUDIO_STRATEGY_COUNT) return "unknown";
+    return STRATEGY_NAMES[strategy];
+}
+
+std::vector<MemcpyCandidate> calibrateMemcpy() {
+    using namespace Calibration;
+
+    std::vector<int> strategies = availableStrategies();
+    std::vector<MemcpyCandidate> results(strategies.size());
+    for (size_t c = 0; c < strategies.size(); c++) {
+        results[c].strategy = strategies[c];
+    }
+
+    std::vector<uint8_t> src(POOL_BYTES, 0x5A);
+    std::vector<uint8_t> dst(POOL_BYTES, 0x00);
+    int previous = g_memcpy_audio_strategy;
+
+    // Size-major, so slow drift (frequency, other load) hits every candidate alike
+    for (size_t bytes : SIZES) {
+        double best = 0;
+        for (MemcpyCandidate& candidate : results) {
+            setMemcpyAudioStrategy(candidate.strategy);
+            candidate.timings.push_back(timeStrategy(bytes, src, dst));
+            double cost = timingCost(candidate.timings.back());
+            if (best == 0 || cost < best) best = cost;
+        }
+        for (MemcpyCandidate& candidate : results) {
+            candidate.score += timingCost(candidate.timings.back()) / best;
+        }
+    }
+    setMemcpyAudioStrategy(previous);
+
+    for (MemcpyCandidate& candidate : results) {
+        candidate.score /= static_cast<double>(std::size(SIZES));
+    }
+    std::stable_sort(results.begin(), results.end(),
+                     [](const MemcpyCandidate& a, const MemcpyCandidate& b) { return a.score < b.score; });
+    return results;
+}
+
+bool saveMemcpyCalibration(const std::string& stateDir, const std::vector<MemcpyCandidate>& results,
+                           std::string& error) {
+    if (results.empty()) {
+        error = "no candidates";
+        return false;
+    }
+    setMemcpyAudioStrategy(results.front().strategy);
+
+    StateFile state(stateDir, Calibration::STATE_FILE);
+    state.set("cpu", cpuModelName());
+    state.set("candidates", strategyList(availableStrategies()));
+    state.set("strategy", memcpyStrategyName(results.front().strategy));
+    state.set("calibrated", todayIso());
+    for (const MemcpyCandidate& candidate : results) {
+        std::ostringstream score;
+        score << std::fixed << std::setprecision(3) << candidate.score;
+        state.set(std::string("score.") + memcpyStrategyName(candidate.strategy), score.str());
+    }
+    return state.save(error);
+}
+
+int selectMemcpyStrategy(const std::string& stateDir, bool forceCalibration) {
+    std::vector<int> strategies = availableStrategies();
+    if (strategies.size() == 1) {
+        setMemcpyAudioStrategy(strategies.front());
+        LOG_INFO("[Memcpy] " << memcpyStrategyName(strategies.front()) << " (only strategy in this build)");
+        return g_memcpy_audio_strategy;
+    }
+
+    StateFile state(stateDir, Calibration::STATE_FILE);
+    if (!forceCalibration && state.load() && state.get("cpu") == cpuModelName() &&
+        state.get("candidates") == strategyList(strategies)) {
+        int strategy = strategyFromName(state.get("strategy"));
+        if (strategy != MEMCPY_AUDIO_DEFAULT) {
+            setMemcpyAudioStrategy(strategy);
+            LOG_INFO("[Memcpy] " << memcpyStrategyName(strategy) << " (calibrated "
+                     << state.get("calibrated", "?") << ", " << state.path() << ")");
+            return strategy;
+        }
+    }
+
+    LOG_INFO("[Memcpy] Calibrating " << strategyList(strategies) << "...");
+    std::vector<MemcpyCandidate> results = calibrateMemcpy();
+
+    std::string error;
+    bool saved = saveMemcpyCalibration(stateDir, results, error);
+    std::ostringstream summary;
+    summary << memcpyStrategyName(results.front().strategy);
+    if (results.size() > 1) {
+        summary << " (next: " << memcpyStrategyName(results[1].strategy) << " +" << std::fixed
+                << std::setprecision(0) << (results[1].score / results.front().score - 1.0) * 100.0 << "%)";
+    }
+    LOG_INFO("[Memcpy] Calibrated: " << summary.str());
+    if (!saved) {
+        LOG_WARN("[Memcpy] Could not save calibration: " << error << " — it will run again next start"
+                 << " (see --state-dir)");
+    }
+    return g_memcpy_audio_strategy;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file MemcpyCalibration.h
+ * @brief Pick the memcpy_audio() strategy by measurement instead of CPUID
+ *
+ * Whether the unrolled AVX copies beat glibc (ERMS rep movsb on recent x86)
+ * depends on the CPU. Each strategy built into this binary is timed at the
+ * sizes the ring actually copies (one buffer per cycle for common formats,
+ * and the 16 KB pipe chunk); the one with the lowest mean + p99 wins and is
+ * pinned for the process. The result is stored in the state directory and
+ * reused while the CPU model and build stay the same.
+ */
+
+#ifndef SQUEEZE2DIRETTA_MEMCPYCALIBRATION_H
+#define SQUEEZE2DIRETTA_MEMCPYCALIBRATION_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct MemcpyTiming {
+    size_t bytes = 0;
+    double meanNs = 0;
+    double p99Ns = 0;
+    double stddevNs = 0;
+};
+
+struct MemcpyCandidate {
+    int strategy = 0;                  // MemcpyAudioStrategy
+    std::vector<MemcpyTiming> timings; // One per calibration size
+    double score = 0;                  // Mean of (mean + p99 + stddev) relative to the best, per size
+};
+
+const char* memcpyStrategyName(int strategy);
+
+/**
+ * @brief Time every strategy available in this build, best first
+ *        (takes a few hundred ms)
+ */
+std::vector<MemcpyCandidate> calibrateMemcpy();
+
+/**
+ * @brief Pin the best candidate and store it in the state directory
+ * @param error Set to the reason if the state file could not be written
+ */
+bool saveMemcpyCalibration(const std::string& stateDir, const std::vector<MemcpyCandidate>& results,
+                           std::string& error);
+
+/**
+ * @brief Pin the memcpy_audio() strategy for this process
+ *
+ * Uses the state file if it matches this CPU and build, otherwise
+ * calibrates and saves the result. Logs the choice.
+ * @param forceCalibration Measure even if a state file exists
+ * @return Pinned strategy
+ */
+int selectMemcpyStrategy(const std::string& stateDir, bool forceCalibration = false);
+
+#endif // SQUEEZE2DIRETTA_MEMCPYCALIBRATION_H
@@ -0,0 +1,153 @@
+/**
+ * @file MemoryLock.cpp
+ * @brief Process memory locking and pre-faulting for the RT audio path
+ */
+
+#include "MemoryLock.h"
+#include "LogLevel.h"
+
+#include <alloca.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifndef MCL_ONFAULT
+#define MCL_ONFAULT 4
+#endif
+
+namespace {
+
+std::atomic<bool> g_memoryLocked{false};
+
+constexpr int CAP_IPC_LOCK_BIT = 14;
+
+// CAP_IPC_LOCK lets us lock past RLIMIT_MEMLOCK (root, or AmbientCapabilities=)
+bool hasIpcLockCapability() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 7, "CapEff:") == 0) {
+            uint64_t caps = std::strtoull(line.c_str() + 7, nullptr, 16);
+            return (caps >> CAP_IPC_LOCK_BIT) & 1;
+        }
+    }
+    return false;
+}
+
+// Mapped size of the process (/proc/self/statm), the upper bound of what
+// MCL_CURRENT will lock right now
+size_t mappedBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    statm >> pages;
+    return pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Stack size of threads created without an explicit one (RLIMIT_STACK)
+size_t defaultStackBytes() {
+    size_t bytes = 8 * 1024 * 1024;
+    pthread_attr_t attr;
+    if (pthread_getattr_default_np(&attr) == 0) {
+        pthread_attr_getstacksize(&attr, &bytes);
+        pthread_attr_destroy(&attr);
+    }
+    return bytes;
+}
+
+std::string describeLimit(rlim_t limit) {
+    if (limit == RLIM_INFINITY) return "unlimited";
+    std::ostringstream oss;
+    oss << limit / 1024 << " KB";
+    return oss.str();
+}
+
+void warnLimitHint() {
+    LOG_WARN("[Memory] Set LimitMEMLOCK=infinity in the systemd unit (or 'ulimit -l unlimited'),"
+             << " or run with CAP_IPC_LOCK");
+}
+
+} // namespace
+
+bool lockProcessMemory(unsigned int targets, unsigned int threads) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_MEMLOCK, &rl) != 0) {
+        rl.rlim_cur = 0;
+    }
+
+    size_t mapped = mappedBytes();
+    size_t buffers = targets * MemoryLock::TARGET_HEADROOM_BYTES;
+    bool privileged = hasIpcLockCapability();
+
+    auto fits = [&](size_t stackBytes) {
+        size_t needed = mapped + buffers + threads * stackBytes;
+        if (rl.rlim_cur == RLIM_INFINITY || privileged || rl.rlim_cur >= needed) return true;
+        LOG_WARN("[Memory] RLIMIT_MEMLOCK is " << describeLimit(rl.rlim_cur) << ", about "
+                 << needed / (1024 * 1024) << " MB needed (" << targets << " target(s), " << threads
+                 << " threads at " << stackBytes / 1024 << " KB of stack) — memory NOT locked,"
+                 << " page faults may hit the audio threads");
+        warnLimitHint();
+        return false;
+    };
+    auto failed = [&](int err) {
+        LOG_WARN("[Memory] mlockall failed: " << strerror(err)
+                 << " (RLIMIT_MEMLOCK " << describeLimit(rl.rlim_cur) << ") — memory NOT locked");
+        warnLimitHint();
+        return false;
+    };
+
+    if (!fits(MemoryLock::STACK_PREFAULT_BYTES)) return false;
+
+    // Populate and lock what is mapped now, then lock later mappings page by
+    // page as they are touched
+    const char* mode = "MCL_CURRENT, then MCL_FUTURE|MCL_ONFAULT";
+    if (mlockall(MCL_CURRENT) != 0) return failed(errno);
+    if (mlockall(MCL_FUTURE | MCL_ONFAULT) != 0) {
+        if (errno != EINVAL) {
+            int err = errno;
+            munlockall();
+            return failed(err);
+        }
+        // Before Linux 4.4: every later mapping, thread stacks included, is
+        // locked in full
+        if (!fits(defaultStackBytes())) {
+            munlockall();
+            return false;
+        }
+        mode = "MCL_CURRENT|MCL_FUTURE, no MCL_ONFAULT";
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            int err = errno;
+            munlockall();
+            return failed(err);
+        }
+    }
+
+    g_memoryLocked.store(true, std::memory_order_release);
+    LOG_INFO("[Memory] Locked (" << mode << "), " << mapped / 1024 << " KB mapped, RLIMIT_MEMLOCK "
+             << describeLimit(rl.rlim_cur) << (privileged ? " (CAP_IPC_LOCK)" : ""));
+    return true;
+}
+
+bool isMemoryLocked() {
+    return g_memoryLocked.load(std::memory_order_acquire);
+}
+
+__attribute__((noinline)) void prefaultStack(size_t bytes) {
+    if (!isMemoryLocked()) return;
+
+    // One write per page below the current frame; locked pages stay resident
+    volatile unsigned char* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < bytes; offset += page) {
+        stack[offset] = 0;
+    }
+}
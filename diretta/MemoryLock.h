@@ -0,0 +1,49 @@
+/**
+ * @file MemoryLock.h
+ * @brief Process memory locking and pre-faulting for the RT audio path
+ *
+ * lockProcessMemory() runs once at startup, before DirettaSync allocates its
+ * buffers. What is mapped then (code, libraries) is locked and populated;
+ * what is mapped afterwards is locked as it is first touched (MCL_ONFAULT),
+ * so the untouched part of every thread's stack (8 MB by default) is not
+ * pinned. The RT buffers do not wait for that: the audio arena is mapped
+ * with MAP_POPULATE, and RT threads call prefaultStack() when they start.
+ * Kernels before 4.4 have no MCL_ONFAULT and lock every mapping in full.
+ */
+
+#ifndef SQUEEZE2DIRETTA_MEMORYLOCK_H
+#define SQUEEZE2DIRETTA_MEMORYLOCK_H
+
+#include <cstddef>
+
+namespace MemoryLock {
+    // Locked memory we expect to need per Diretta target on top of what is
+    // resident at startup: 16MB ring (max) and SDK buffers
+    constexpr size_t TARGET_HEADROOM_BYTES = 32 * 1024 * 1024;
+    // Threads per target: worker and Diretta SDK internals (estimate)
+    constexpr unsigned int THREADS_PER_TARGET = 4;
+    constexpr size_t STACK_PREFAULT_BYTES = 256 * 1024;
+}
+
+/**
+ * @brief mlockall(MCL_CURRENT), then mlockall(MCL_FUTURE|MCL_ONFAULT),
+ *        checking RLIMIT_MEMLOCK first
+ *
+ * Without CAP_IPC_LOCK a finite limit below the expected footprint would make
+ * later allocations fail under MCL_FUTURE, so locking is skipped (with a
+ * warning) instead.
+ * @param targets Diretta targets driven (TARGET_HEADROOM_BYTES each)
+ * @param threads Threads expected: STACK_PREFAULT_BYTES of stack each, or
+ *                the whole default stack where MCL_ONFAULT is missing
+ * @return true if memory is now locked
+ */
+bool lockProcessMemory(unsigned int targets, unsigned int threads);
+
+bool isMemoryLocked();
+
+/**
+ * @brief Touch the next bytes of the calling thread's stack (no-op if not locked)
+ */
+void prefaultStack(size_t bytes = MemoryLock::STACK_PREFAULT_BYTES);
+
+#endif // SQUEEZE2DIRETTA_MEMORYLOCK_H
@@ -0,0 +1,115 @@
+/**
+ * @file PerfCounter.cpp
+ * @brief Minimal perf_event_open() counter group
+ */
+
+#include "PerfCounter.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int perfEventOpen(perf_event_attr* attr, int groupFd) {
+    return static_cast<int>(syscall(SYS_perf_event_open, attr, 0 /* this thread */, -1 /* any CPU */,
+                                    groupFd, PERF_FLAG_FD_CLOEXEC));
+}
+
+} // namespace
+
+PerfCounterGroup::~PerfCounterGroup() {
+    close();
+}
+
+void PerfCounterGroup::close() {
+    for (int i = 0; i < m_count; i++) {
+        ::close(m_fds[i]);
+        m_fds[i] = -1;
+    }
+    m_count = 0;
+    m_leader = -1;
+}
+
+int PerfCounterGroup::add(uint32_t type, uint64_t config) {
+    if (m_count >= MAX_COUNTERS) {
+        m_lastError = "too many counters";
+        return -1;
+    }
+
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (m_leader < 0) ? 1 : 0;    // Members follow the leader
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    int fd = perfEventOpen(&attr, m_leader);
+    if (fd < 0) {
+        m_lastError = std::strerror(errno);
+        if (errno == EACCES || errno == EPERM) {
+            m_lastError += " (check /proc/sys/kernel/perf_event_paranoid or CAP_PERFMON)";
+        }
+        return -1;
+    }
+
+    if (m_leader < 0) m_leader = fd;
+    m_fds[m_count] = fd;
+    return m_count++;
+}
+
+int PerfCounterGroup::addTracepoint(const char* event) {
+    int id = tracepointId(event);
+    if (id < 0) {
+        m_lastError = std::string("tracepoint ") + event + " not found (tracefs not mounted?)";
+        return -1;
+    }
+    return add(PERF_TYPE_TRACEPOINT, static_cast<uint64_t>(id));
+}
+
+void PerfCounterGroup::enable() {
+    if (m_leader >= 0) ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounterGroup::disable() {
+    if (m_leader >= 0) ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounterGroup::reset() {
+    if (m_leader >= 0) ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+}
+
+bool PerfCounterGroup::read(uint64_t* values) const {
+    if (m_leader < 0) return false;
+
+    // PERF_FORMAT_GROUP layout: nr, then one value per member
+    uint64_t data[1 + MAX_COUNTERS];
+    ssize_t n = ::read(m_leader, data, sizeof(data));
+    if (n < static_cast<ssize_t>(sizeof(uint64_t)) || data[0] != static_cast<uint64_t>(m_count)) {
+        return false;
+    }
+    for (int i = 0; i < m_count; i++) {
+        values[i] = data[1 + i];
+    }
+    return true;
+}
+
+int PerfCounterGroup::tracepointId(const char* event) {
+    static const char* const roots[] = {"/sys/kernel/tracing/events/", "/sys/kernel/debug/tracing/events/"};
+    for (const char* root : roots) {
+        std::string path = std::string(root) + event + "/id";
+        FILE* f = std::fopen(path.c_str(), "r");
+        if (!f) continue;
+        int id = -1;
+        if (std::fscanf(f, "%d", &id) != 1) id = -1;
+        std::fclose(f);
+        if (id >= 0) return id;
+    }
+    return -1;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file PerfCounter.h
+ * @brief Minimal perf_event_open() counter group
+ *
+ * Counts for the calling thread only (not inherited by threads it creates).
+ * Members are enabled and disabled together; enable()/disable() are a single
+ * ioctl and do not allocate, so they can bracket RT code.
+ */
+
+#ifndef SQUEEZE2DIRETTA_PERFCOUNTER_H
+#define SQUEEZE2DIRETTA_PERFCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class PerfCounterGroup {
+public:
+    static constexpr int MAX_COUNTERS = 8;
+
+    PerfCounterGroup() = default;
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    /**
+     * @brief Add a counter (PERF_TYPE_* / config), created disabled
+     * @return Counter index, or -1 if the kernel refused it (see lastError())
+     */
+    int add(uint32_t type, uint64_t config);
+
+    /**
+     * @brief Add a tracepoint counter, e.g. "raw_syscalls/sys_enter"
+     */
+    int addTracepoint(const char* event);
+
+    void enable();
+    void disable();
+    void reset();
+
+    /**
+     * @brief Close all counters (the group can then be rebuilt with add())
+     */
+    void close();
+
+    /**
+     * @brief Read all counters into values[0..count())
+     */
+    bool read(uint64_t* values) const;
+
+    int count() const { return m_count; }
+    bool valid() const { return m_leader >= 0; }
+    const std::string& lastError() const { return m_lastError; }
+
+    /**
+     * @brief Tracepoint id from tracefs, -1 if unavailable
+     */
+    static int tracepointId(const char* event);
+
+private:
+    int m_leader = -1;
+    int m_fds[MAX_COUNTERS] = {-1, -1, -1, -1, -1, -1, -1, -1};
+    int m_count = 0;
+    std::string m_lastError;
+};
+
+#endif // SQUEEZE2DIRETTA_PERFCOUNTER_H
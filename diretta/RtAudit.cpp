@@ -0,0 +1,305 @@
+/**
+ * @file RtAudit.cpp
+ * @brief Real-time safety audit (RT_AUDIT builds only)
+ *
+ * malloc & co. are replaced by thin wrappers around glibc's __libc_* entry
+ * points; operator new/delete go through malloc/free and are covered too.
+ * Outside an RT scope the wrappers only test one thread-local pointer.
+ */
+
+#ifdef RT_AUDIT
+
+#include "RtAudit.h"
+#include "PerfCounter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#include <execinfo.h>
+#include <linux/perf_event.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+constexpr int MAX_THREADS = 16;
+
+struct ThreadSlot {
+    const char* role = nullptr;
+    int instance = -1;                              // -1 = one thread per role
+    char comm[16] = {};
+    pid_t tid = 0;
+    std::atomic<uint64_t> scopes{0};
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> allocBytes{0};
+    std::atomic<uint64_t> steadyOps{0};             // Steady state, outside RT scopes
+    std::atomic<const char*> firstScope{nullptr};   // Scope of the first violation
+    PerfCounterGroup perf;
+    int syscallIdx = -1;
+    int ctxSwitchIdx = -1;
+    int threads = 0;                                // Threads that held this slot
+    uint64_t carried[PerfCounterGroup::MAX_COUNTERS] = {};  // Counts of earlier threads
+};
+
+ThreadSlot g_slots[MAX_THREADS];
+std::atomic<int> g_slotCount{0};
+std::mutex g_registerMutex;            // Workers of several targets start in parallel
+RtAuditMode g_mode = RtAuditMode::Count;
+bool g_syscallTracepoint = false;
+std::atomic<int> g_steadyState{0};     // 0 = not started, 1 = active, 2 = ended
+
+__thread ThreadSlot* t_slot = nullptr;
+__thread const char* t_scope = nullptr;     // Innermost RT scope, nullptr = not in one
+__thread bool t_inHook = false;
+
+[[noreturn]] void abortOnHeapOp(const char* op, size_t size) {
+    char msg[256];
+    int len = std::snprintf(msg, sizeof(msg), "\n[RT audit] %s(%zu) inside %s on %s (tid %d) — aborting\n",
+                            op, size, t_scope ? t_scope : "steady state", t_slot->role,
+                            static_cast<int>(t_slot->tid));
+    if (len > 0) (void)!write(STDERR_FILENO, msg, static_cast<size_t>(len));
+
+    void* frames[48];
+    int depth = backtrace(frames, 48);
+    backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+    std::abort();
+}
+
+inline void onHeapOp(const char* op, size_t size, bool isFree) {
+    ThreadSlot* slot = t_slot;
+    if (!slot || t_inHook) return;
+
+    if (!t_scope) {
+        if (g_steadyState.load(std::memory_order_relaxed) != 1) return;
+        slot->steadyOps.fetch_add(1, std::memory_order_relaxed);
+        if (g_mode == RtAuditMode::Abort) {
+            t_inHook = true;
+            abortOnHeapOp(op, size);
+        }
+        return;
+    }
+
+    t_inHook = true;
+    if (isFree) {
+        slot->frees.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        slot->allocs.fetch_add(1, std::memory_order_relaxed);
+        slot->allocBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    const char* expected = nullptr;
+    slot->firstScope.compare_exchange_strong(expected, t_scope, std::memory_order_relaxed);
+
+    if (g_mode == RtAuditMode::Abort) {
+        abortOnHeapOp(op, size);
+    }
+    t_inHook = false;
+}
+
+} // namespace
+
+//=============================================================================
+// Allocator interposition
+//=============================================================================
+
+extern "C" {
+
+void* malloc(size_t size) {
+    onHeapOp("malloc", size, false);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    onHeapOp("calloc", count * size, false);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    onHeapOp("realloc", size, false);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    if (ptr) onHeapOp("free", 0, true);
+    __libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    onHeapOp("memalign", size, false);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    onHeapOp("aligned_alloc", size, false);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    onHeapOp("posix_memalign", size, false);
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) return ENOMEM;
+    *out = ptr;
+    return 0;
+}
+
+} // extern "C"
+
+//=============================================================================
+// Threads and scopes
+//=============================================================================
+
+void rtAuditInit(RtAuditMode mode) {
+    g_mode = mode;
+    g_syscallTracepoint = PerfCounterGroup::tracepointId("raw_syscalls/sys_enter") >= 0;
+    std::cout << "[RT audit] Enabled (" << (mode == RtAuditMode::Abort ? "abort" : "count")
+              << " mode), syscall counting "
+              << (g_syscallTracepoint ? "via raw_syscalls:sys_enter" : "unavailable — context switches only")
+              << std::endl;
+}
+
+void rtAuditRegisterThread(const char* role, int instance) {
+    if (t_slot) return;
+    std::lock_guard<std::mutex> lock(g_registerMutex);
+
+    // The worker is recreated on every reopen: its successors share one slot
+    // (the previous worker of a target is joined before the next one starts)
+    ThreadSlot* found = nullptr;
+    int registered = std::min(g_slotCount.load(std::memory_order_acquire), MAX_THREADS);
+    for (int i = 0; i < registered && !found; i++) {
+        if (std::strcmp(g_slots[i].role, role) == 0 && g_slots[i].instance == instance) found = &g_slots[i];
+    }
+    if (!found) {
+        int index = g_slotCount.load(std::memory_order_relaxed);
+        if (index >= MAX_THREADS) {
+            std::cerr << "[RT audit] More than " << MAX_THREADS << " threads, " << role
+                      << " not audited" << std::endl;
+            return;
+        }
+        found = &g_slots[index];
+        found->role = role;
+        found->instance = instance;
+        g_slotCount.store(index + 1, std::memory_order_release);
+    }
+
+    ThreadSlot& slot = *found;
+    uint64_t previous[PerfCounterGroup::MAX_COUNTERS] = {};
+    if (slot.perf.read(previous)) {
+        for (int i = 0; i < slot.perf.count(); i++) slot.carried[i] += previous[i];
+    }
+    slot.perf.close();
+    slot.threads++;
+    slot.tid = static_cast<pid_t>(syscall(SYS_gettid));
+    prctl(PR_GET_NAME, slot.comm, 0, 0, 0);
+
+    slot.syscallIdx = -1;
+    if (g_syscallTracepoint) {
+        slot.syscallIdx = slot.perf.addTracepoint("raw_syscalls/sys_enter");
+    }
+    slot.ctxSwitchIdx = slot.perf.add(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+    if (!slot.perf.valid()) {
+        std::cerr << "[RT audit] " << role;
+        if (instance >= 0) std::cerr << " " << instance;
+        std::cerr << ": perf counters unavailable (" << slot.perf.lastError()
+                  << "), counting allocations only" << std::endl;
+    }
+
+    t_slot = &slot;
+}
+
+RtAuditScope::RtAuditScope(const char* name) : m_previous(t_scope) {
+    ThreadSlot* slot = t_slot;
+    if (!slot || m_previous) {
+        t_scope = slot ? name : nullptr;
+        return;
+    }
+    slot->scopes.fetch_add(1, std::memory_order_relaxed);
+    slot->perf.enable();
+    t_scope = name;
+}
+
+RtAuditScope::~RtAuditScope() {
+    ThreadSlot* slot = t_slot;
+    t_scope = m_previous;
+    if (slot && !m_previous) {
+        slot->perf.disable();
+    }
+}
+
+void rtAuditSteadyState(bool active) {
+    int expected = active ? 0 : 1;
+    g_steadyState.compare_exchange_strong(expected, active ? 1 : 2, std::memory_order_relaxed);
+}
+
+//=============================================================================
+// Report
+//=============================================================================
+
+uint64_t rtAuditReport() {
+    uint64_t violations = 0;
+    int count = std::min(g_slotCount.load(std::memory_order_relaxed), MAX_THREADS);
+
+    std::cout << "\n═══════ RT Audit Report ═══════" << std::endl;
+    for (int i = 0; i < count; i++) {
+        ThreadSlot& slot = g_slots[i];
+        uint64_t scopes = slot.scopes.load(std::memory_order_relaxed);
+        uint64_t allocs = slot.allocs.load(std::memory_order_relaxed);
+        uint64_t frees = slot.frees.load(std::memory_order_relaxed);
+        uint64_t steadyOps = slot.steadyOps.load(std::memory_order_relaxed);
+        violations += allocs + frees + steadyOps;
+
+        std::cout << "  " << slot.role;
+        if (slot.instance >= 0) std::cout << " " << slot.instance;
+        std::cout << " (" << slot.comm << ", tid " << slot.tid;
+        if (slot.threads > 1) std::cout << ", " << slot.threads << " threads";
+        std::cout << "): "
+                  << scopes << " scopes, " << allocs << " allocs ("
+                  << slot.allocBytes.load(std::memory_order_relaxed) << " bytes), " << frees << " frees";
+
+        uint64_t values[PerfCounterGroup::MAX_COUNTERS] = {};
+        if (slot.perf.read(values)) {
+            for (int c = 0; c < slot.perf.count(); c++) values[c] += slot.carried[c];
+            if (slot.syscallIdx >= 0) {
+                // The disabling ioctl of every scope is itself counted
+                uint64_t syscalls = values[slot.syscallIdx];
+                syscalls = syscalls > scopes ? syscalls - scopes : 0;
+                std::cout << ", " << syscalls << " syscalls";
+            }
+            if (slot.ctxSwitchIdx >= 0) {
+                std::cout << ", " << values[slot.ctxSwitchIdx] << " context switches";
+            }
+        }
+        std::cout << std::endl;
+
+        if (g_steadyState.load(std::memory_order_relaxed) != 0) {
+            std::cout << "    steady state (first playback to shutdown), outside RT scopes: "
+                      << steadyOps << " heap operations" << std::endl;
+        }
+
+        const char* first = slot.firstScope.load(std::memory_order_relaxed);
+        if (first) {
+            std::cout << "    first heap operation in " << first << std::endl;
+        }
+    }
+    std::cout << "  Result: " << (violations == 0 ? "CLEAN" : "HEAP OPERATIONS IN RT SCOPES OR STEADY STATE")
+              << " (" << violations << ")" << std::endl;
+    std::cout << "═══════════════════════════════\n" << std::endl;
+    return violations;
+}
+
+#endif // RT_AUDIT
@@ -0,0 +1,83 @@
+/**
+ * @file RtAudit.h
+ * @brief Real-time safety audit (RT_AUDIT builds only)
+ *
+ * Built with -DRT_AUDIT=ON, the process interposes malloc/free and counts,
+ * per registered thread, every heap operation made inside an RT scope
+ * (getNewStream() on the worker, sendAudio() on the ingest thread). Syscalls
+ * inside the same scopes are counted with a perf raw_syscalls:sys_enter
+ * counter that is only enabled while in scope (context switches are counted
+ * alongside, and used alone if the tracepoint is not accessible).
+ *
+ * Heap operations on registered threads are also counted, in or out of
+ * scopes, between first playback and shutdown (steady state); they fail
+ * the audit like those in RT scopes. --rt-audit abort turns the first of
+ * either into a backtrace + abort(). A per-thread report is printed at exit.
+ *
+ * In normal builds every macro below compiles to nothing.
+ */
+
+#ifndef SQUEEZE2DIRETTA_RTAUDIT_H
+#define SQUEEZE2DIRETTA_RTAUDIT_H
+
+#ifdef RT_AUDIT
+
+#include <cstdint>
+
+enum class RtAuditMode { Count, Abort };
+
+/**
+ * @brief Resolve the syscall tracepoint and set the mode (call early in main)
+ */
+void rtAuditInit(RtAuditMode mode);
+
+/**
+ * @brief Register the calling thread under a role name (not RT-safe: opens
+ *        its perf counters). Scopes on unregistered threads are ignored.
+ *
+ * Threads of the same role that run side by side (one worker per target
+ * with zones or fan-out) pass an instance number, and each gets its own
+ * slot and counter group; a thread that replaces an earlier one (the worker
+ * after a reopen) takes over that one's slot.
+ */
+void rtAuditRegisterThread(const char* role, int instance = -1);
+
+/**
+ * @brief Open/close the steady-state window (first playback to shutdown)
+ *
+ * While open, every heap operation on a registered thread is counted, in or
+ * out of RT scopes, and fails the audit. The first call with true opens it; later ones are no-ops.
+ */
+void rtAuditSteadyState(bool active);
+
+/**
+ * @brief Print the per-thread report
+ * @return Number of heap operations seen inside RT scopes or in steady state
+ */
+uint64_t rtAuditReport();
+
+class RtAuditScope {
+public:
+    explicit RtAuditScope(const char* name);
+    ~RtAuditScope();
+
+    RtAuditScope(const RtAuditScope&) = delete;
+    RtAuditScope& operator=(const RtAuditScope&) = delete;
+
+private:
+    const char* m_previous;
+};
+
+#define RT_AUDIT_THREAD(...) rtAuditRegisterThread(__VA_ARGS__)
+#define RT_AUDIT_SCOPE(name) RtAuditScope rtAuditScope_(name)
+#define RT_AUDIT_STEADY_STATE(active) rtAuditSteadyState(active)
+
+#else
+
+#define RT_AUDIT_THREAD(...) do {} while(0)
+#define RT_AUDIT_SCOPE(name) do {} while(0)
+#define RT_AUDIT_STEADY_STATE(active) do {} while(0)
+
+#endif // RT_AUDIT
+
+#endif // SQUEEZE2DIRETTA_RTAUDIT_H
@@ -0,0 +1,107 @@
+/**
+ * @file SqStream.cpp
+ * @brief The patched squeezelite's stdout stream: format header and test signals
+ */
+
+#include "SqStream.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+#include <unistd.h>
+
+namespace {
+
+void putS32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+} // namespace
+
+namespace SqStream {
+
+uint32_t headerRate(bool dsd, uint32_t rate, DsdContainer container) {
+    if (!dsd) return rate;
+    return rate / (container == DOP ? 16 : 32);
+}
+
+SqFormatHeader testHeader(bool dsd, uint32_t rate, DsdContainer container) {
+    SqFormatHeader hdr{};
+    std::memcpy(hdr.magic, "SQFH", 4);
+    hdr.version = 1;
+    hdr.channels = CHANNELS;
+    hdr.bit_depth = !dsd ? 32 : container == DOP ? 24 : 1;
+    hdr.dsd_format = dsd ? container : PCM;
+    hdr.sample_rate = headerRate(dsd, rate, container);
+    return hdr;
+}
+
+std::vector<uint8_t> renderPcm(uint32_t rate) {
+    size_t frames = static_cast<size_t>(rate * LOOP_SECONDS);
+    std::vector<uint8_t> out;
+    out.reserve(frames * CHANNELS * 4);
+    for (size_t i = 0; i < frames; i++) {
+        double s = TONE_LEVEL * std::sin(2.0 * M_PI * TONE_HZ * i / rate);
+        int32_t v = static_cast<int32_t>(std::lround(s * 2147483647.0));
+        for (int ch = 0; ch < CHANNELS; ch++) putS32(out, static_cast<uint32_t>(v));
+    }
+    return out;
+}
+
+std::vector<uint8_t> renderDsd(uint32_t bitRate, DsdContainer container) {
+    size_t bits = static_cast<size_t>(bitRate * LOOP_SECONDS);
+    std::vector<uint8_t> bytes(bits / 8, 0);
+    double i1 = 0.0, i2 = 0.0, y = 0.0;
+    for (size_t n = 0; n < bits; n++) {
+        double x = TONE_LEVEL * std::sin(2.0 * M_PI * TONE_HZ * n / bitRate);
+        i1 += x - y;
+        i2 += i1 - y;
+        y = i2 >= 0.0 ? 1.0 : -1.0;
+        if (y > 0) bytes[n / 8] |= static_cast<uint8_t>(0x80 >> (n % 8));
+    }
+
+    std::vector<uint8_t> out;
+    if (container == DOP) {
+        size_t frames = bytes.size() / 2;
+        out.reserve(frames * CHANNELS * 4);
+        for (size_t f = 0; f < frames; f++) {
+            uint32_t marker = (f & 1) ? 0xFA : 0x05;
+            uint32_t word = (marker << 24) | (uint32_t(bytes[2 * f]) << 16) | (uint32_t(bytes[2 * f + 1]) << 8);
+            for (int ch = 0; ch < CHANNELS; ch++) putS32(out, word);
+        }
+    } else {
+        size_t frames = bytes.size() / 4;
+        out.reserve(frames * CHANNELS * 4);
+        for (size_t f = 0; f < frames; f++) {
+            const uint8_t* b = &bytes[4 * f];
+            uint32_t word = container == U32_BE
+                ? (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | b[3]
+                : (uint32_t(b[3]) << 24) | (uint32_t(b[2]) << 16) | (uint32_t(b[1]) << 8) | b[0];
+            for (int ch = 0; ch < CHANNELS; ch++) putS32(out, word);
+        }
+    }
+    return out;
+}
+
+bool writeAll(int fd, struct iovec* iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t n = writev(fd, iov, iovcnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;    // Reader went away
+        }
+        while (iovcnt > 0 && static_cast<size_t>(n) >= iov->iov_len) {
+            n -= static_cast<ssize_t>(iov->iov_len);
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + n;
+            iov->iov_len -= static_cast<size_t>(n);
+        }
+    }
+    return true;
+}
+
+} // namespace SqStream
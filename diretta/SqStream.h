@@ -0,0 +1,83 @@
+/**
+ * @file SqStream.h
+ * @brief The patched squeezelite's stdout stream: format header and test signals
+ *
+ * squeezelite writes a 16-byte "SQFH" header, then S32_LE frames, on every
+ * format change (output_stdout.c). The wrapper parses that stream; the
+ * calibration runs (runTestSignal()) and squeezelite-testgen write it in
+ * squeezelite's place, from the test signals below: a 1 kHz tone at -6 dBFS
+ * as PCM, or as DSD from a second-order sigma-delta modulator, in any of
+ * squeezelite's DSD containers.
+ *
+ * Needs neither the Diretta SDK nor the rest of the wrapper (squeezelite-testgen
+ * is built from this and its own source only).
+ */
+
+#ifndef SQUEEZE2DIRETTA_SQSTREAM_H
+#define SQUEEZE2DIRETTA_SQSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <sys/uio.h>
+
+// ================================================================
+// In-band format header (must match squeezelite output_stdout.c)
+// ================================================================
+struct __attribute__((packed)) SqFormatHeader {
+    uint8_t  magic[4];       // "SQFH"
+    uint8_t  version;        // Protocol version: 1
+    uint8_t  channels;       // 2 for stereo
+    uint8_t  bit_depth;      // PCM: 16/24/32, DSD: 1, DoP: 24
+    uint8_t  dsd_format;     // 0=PCM, 1=DOP, 2=DSD_U32_LE, 3=DSD_U32_BE
+    uint32_t sample_rate;    // Sample/frame rate in Hz (LE)
+    uint8_t  reserved[4];    // Zero-filled
+};
+
+static_assert(sizeof(SqFormatHeader) == 16, "SqFormatHeader must be 16 bytes");
+
+namespace SqStream {
+    // dsd_format values
+    enum DsdContainer : uint8_t { PCM = 0, DOP = 1, U32_LE = 2, U32_BE = 3 };
+
+    constexpr int CHANNELS = 2;
+    constexpr double TONE_HZ = 1000.0;
+    constexpr double TONE_LEVEL = 0.5;     // -6 dBFS
+    constexpr double LOOP_SECONDS = 0.1;   // Whole number of tone periods at every rate
+    constexpr double WRITE_MS = 10.0;      // Default write size, as squeezelite's
+
+    /**
+     * @brief Frame rate squeezelite announces for a rate (DSD: the bit rate
+     *        per container word)
+     * @param rate PCM sample rate or DSD bit rate
+     */
+    uint32_t headerRate(bool dsd, uint32_t rate, DsdContainer container);
+
+    /**
+     * @brief Header squeezelite sends before the test signal
+     */
+    SqFormatHeader testHeader(bool dsd, uint32_t rate, DsdContainer container);
+
+    /**
+     * @brief One loop (LOOP_SECONDS) of the tone as S32_LE stereo frames
+     */
+    std::vector<uint8_t> renderPcm(uint32_t rate);
+
+    /**
+     * @brief One loop of the tone as DSD in squeezelite's containers
+     *
+     * MSB = earliest bit. DoP puts 2 bytes per channel in bits 8-23 under
+     * the 0x05/0xFA marker; u32 packs 4 bytes with the earliest byte most
+     * (u32be) or least (u32le) significant.
+     */
+    std::vector<uint8_t> renderDsd(uint32_t bitRate, DsdContainer container);
+
+    /**
+     * @brief writev() until every iovec is written (advances iov)
+     * @return false if the reader went away
+     */
+    bool writeAll(int fd, struct iovec* iov, int iovcnt);
+}
+
+#endif // SQUEEZE2DIRETTA_SQSTREAM_H
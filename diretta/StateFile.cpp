@@ -0,0 +1,76 @@
+/**
+ * @file StateFile.cpp
+ * @brief Small key=value files for results worth keeping across restarts
+ */
+
+#include "StateFile.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <sys/stat.h>
+
+StateFile::StateFile(const std::string& stateDir, const std::string& name)
+    : m_dir(stateDir)
+    , m_path(stateDir + "/" + name) {
+}
+
+bool StateFile::load() {
+    std::ifstream in(m_path);
+    if (!in) {
+        return false;
+    }
+
+    m_values.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        m_values[line.substr(0, eq)] = line.substr(eq + 1);
+    }
+    return true;
+}
+
+bool StateFile::save(std::string& error) const {
+    if (mkdir(m_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        error = m_dir + ": " + std::strerror(errno);
+        return false;
+    }
+
+    std::string tmp = m_path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) {
+            error = tmp + ": " + std::strerror(errno);
+            return false;
+        }
+        out << "# squeeze2diretta state - delete to measure again" << std::endl;
+        for (const auto& entry : m_values) {
+            out << entry.first << "=" << entry.second << std::endl;
+        }
+        if (!out.flush()) {
+            error = tmp + ": write failed";
+            std::remove(tmp.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(tmp.c_str(), m_path.c_str()) != 0) {
+        error = m_path + ": " + std::strerror(errno);
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string StateFile::get(const std::string& key, const std::string& fallback) const {
+    auto it = m_values.find(key);
+    return it != m_values.end() ? it->second : fallback;
+}
+
+void StateFile::set(const std::string& key, const std::string& value) {
+    m_values[key] = value;
+}
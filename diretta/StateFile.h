@@ -0,0 +1,50 @@
+/**
+ * @file StateFile.h
+ * @brief Small key=value files for results worth keeping across restarts
+ *
+ * Calibration results (memcpy strategy, ...) are measured once and stored
+ * under the state directory (default /var/lib/squeeze2diretta, created by
+ * the systemd unit's StateDirectory=), so later starts skip the measurement.
+ * Files are plain text, one "key=value" per line, '#' starts a comment.
+ */
+
+#ifndef SQUEEZE2DIRETTA_STATEFILE_H
+#define SQUEEZE2DIRETTA_STATEFILE_H
+
+#include <map>
+#include <string>
+
+namespace StateDir {
+    constexpr const char* DEFAULT_PATH = "/var/lib/squeeze2diretta";
+}
+
+class StateFile {
+public:
+    StateFile(const std::string& stateDir, const std::string& name);
+
+    /**
+     * @brief Read the file; false if it does not exist or cannot be read
+     */
+    bool load();
+
+    /**
+     * @brief Write atomically (temporary file + rename), creating the
+     *        state directory if needed
+     * @param error Set to the reason on failure
+     */
+    bool save(std::string& error) const;
+
+    std::string get(const std::string& key, const std::string& fallback = "") const;
+    void set(const std::string& key, const std::string& value);
+    void clear() { m_values.clear(); }
+    const std::map<std::string, std::string>& values() const { return m_values; }
+
+    const std::string& path() const { return m_path; }
+
+private:
+    std::string m_dir;
+    std::string m_path;
+    std::map<std::string, std::string> m_values;
+};
+
+#endif // SQUEEZE2DIRETTA_STATEFILE_H
@@ -0,0 +1,557 @@
+/**
+ * @file ThreadPolicy.cpp
+ * @brief Thread naming, CPU affinity and scheduling policy
+ */
+
+#include "ThreadPolicy.h"
+#include "LogLevel.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+#ifndef SCHED_RESET_ON_FORK
+#define SCHED_RESET_ON_FORK 0x40000000
+#endif
+#ifndef SCHED_FLAG_RESET_ON_FORK
+#define SCHED_FLAG_RESET_ON_FORK 0x01
+#endif
+
+namespace {
+
+// sched_setattr()/sched_getattr() have no glibc wrapper on older distributions
+struct DeadlineAttr {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t  sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;     // nanoseconds
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+};
+
+int setDeadlineAttr(pid_t tid, uint64_t runtimeNs, uint64_t deadlineNs, uint64_t periodNs,
+                    bool resetOnFork = true) {
+    DeadlineAttr attr{};
+    attr.size = sizeof(attr);
+    attr.sched_policy = SCHED_DEADLINE;
+    attr.sched_flags = resetOnFork ? SCHED_FLAG_RESET_ON_FORK : 0;
+    attr.sched_runtime = runtimeNs;
+    attr.sched_deadline = deadlineNs;
+    attr.sched_period = periodNs;
+    return static_cast<int>(syscall(SYS_sched_setattr, tid, &attr, 0));
+}
+
+bool getDeadlineAttr(pid_t tid, DeadlineAttr& attr) {
+    std::memset(&attr, 0, sizeof(attr));
+    return syscall(SYS_sched_getattr, tid, &attr, sizeof(attr), 0) == 0;
+}
+
+// A thread as the registry knows it: tids are reused once a thread exits,
+// the start time (clock ticks since boot) tells the new thread apart
+struct ThreadKey {
+    pid_t tid;
+    unsigned long long start;
+
+    bool operator==(const ThreadKey& other) const { return tid == other.tid && start == other.start; }
+};
+
+// Registry of threads we created (or already placed as foreign)
+std::mutex s_registryMutex;
+std::vector<ThreadKey> s_ownThreads;
+std::vector<ThreadKey> s_foreignThreads;
+std::vector<std::string> s_assignedNames;
+
+bool contains(const std::vector<ThreadKey>& v, const ThreadKey& key) {
+    return std::find(v.begin(), v.end(), key) != v.end();
+}
+
+// Field 22 of /proc/self/task/<tid>/stat; 0 if the thread is gone
+unsigned long long threadStartTime(pid_t tid) {
+    std::ifstream f("/proc/self/task/" + std::to_string(tid) + "/stat");
+    std::string stat;
+    std::getline(f, stat);
+    size_t paren = stat.rfind(')');    // comm may contain spaces and parentheses
+    if (paren == std::string::npos) return 0;
+    std::istringstream fields(stat.substr(paren + 1));
+    std::string field;
+    for (int i = 3; i <= 22 && (fields >> field); i++) {
+        if (i == 22) return std::strtoull(field.c_str(), nullptr, 10);
+    }
+    return 0;
+}
+
+// Drop exited threads, so that a reused tid is not mistaken for them
+void pruneRegistry(std::vector<ThreadKey>& v, const std::vector<ThreadKey>& live) {
+    v.erase(std::remove_if(v.begin(), v.end(), [&live](const ThreadKey& key) { return !contains(live, key); }),
+            v.end());
+}
+
+std::string readComm(pid_t tid) {
+    std::ifstream f("/proc/self/task/" + std::to_string(tid) + "/comm");
+    std::string name;
+    std::getline(f, name);
+    return name;
+}
+
+bool writeComm(pid_t tid, const std::string& name) {
+    std::ofstream f("/proc/self/task/" + std::to_string(tid) + "/comm");
+    if (!f) return false;
+    f << name.substr(0, 15);
+    return static_cast<bool>(f);
+}
+
+std::vector<pid_t> listProcessThreads() {
+    std::vector<pid_t> tids;
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) return tids;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') continue;
+        tids.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+    }
+    closedir(dir);
+    return tids;
+}
+
+bool parseInt(const std::string& s, int& out) {
+    if (s.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    long v = std::strtol(s.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0') return false;
+    out = static_cast<int>(v);
+    return true;
+}
+
+bool parseCpuList(const std::string& list, std::vector<int>& cpus, std::string& error) {
+    cpus.clear();
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t dash = item.find('-');
+        int first = 0, last = 0;
+        if (dash == std::string::npos) {
+            if (!parseInt(item, first)) { error = "bad CPU '" + item + "'"; return false; }
+            last = first;
+        } else if (!parseInt(item.substr(0, dash), first) ||
+                   !parseInt(item.substr(dash + 1), last) || last < first) {
+            error = "bad CPU range '" + item + "'";
+            return false;
+        }
+        if (first < 0 || last >= CPU_SETSIZE) { error = "CPU out of range '" + item + "'"; return false; }
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    if (cpus.empty()) { error = "empty CPU list"; return false; }
+    return true;
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream out;
+    for (size_t i = 0; i < cpus.size(); ) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) j++;
+        if (i > 0) out << ",";
+        out << cpus[i];
+        if (j > i) out << "-" << cpus[j];
+        i = j + 1;
+    }
+    return out.str();
+}
+
+} // namespace
+
+//=============================================================================
+// Parsing
+//=============================================================================
+
+const char* threadRoleName(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::Worker:      return "worker";
+        case ThreadRole::Ingest:      return "ingest";
+        case ThreadRole::LogDrain:    return "log";
+        case ThreadRole::Sdk:         return "sdk";
+        case ThreadRole::Squeezelite: return "squeezelite";
+        case ThreadRole::Convert:     return "convert";
+        default:                      return "?";
+    }
+}
+
+bool parseThreadPolicy(const std::string& spec, ThreadPolicy& policy, std::string& error) {
+    ThreadPolicy result;
+
+    std::string sched = spec;
+    size_t at = spec.find('@');
+    if (at != std::string::npos) {
+        sched = spec.substr(0, at);
+        if (!parseCpuList(spec.substr(at + 1), result.cpus, error)) return false;
+    }
+
+    if (!sched.empty()) {
+        std::string name = sched;
+        std::string param;
+        size_t colon = sched.find(':');
+        if (colon != std::string::npos) {
+            name = sched.substr(0, colon);
+            param = sched.substr(colon + 1);
+        }
+
+        if (name == "other") {
+            result.policy = SchedPolicy::Other;
+            if (!param.empty() && (!parseInt(param, result.priority) ||
+                                   result.priority < -20 || result.priority > 19)) {
+                error = "nice value must be -20..19";
+                return false;
+            }
+        } else if (name == "fifo" || name == "rr") {
+            result.policy = (name == "fifo") ? SchedPolicy::Fifo : SchedPolicy::RoundRobin;
+            if (!parseInt(param, result.priority) || result.priority < 1 || result.priority > 99) {
+                error = name + " needs a priority 1..99 (e.g. " + name + ":50)";
+                return false;
+            }
+        } else if (name == "deadline" && param == "auto") {
+            result.policy = SchedPolicy::Deadline;    // Parameters filled in by the owner
+        } else if (name == "deadline") {
+            result.policy = SchedPolicy::Deadline;
+            size_t slash = param.find('/');
+            int runtime = 0, period = 0;
+            if (slash == std::string::npos ||
+                !parseInt(param.substr(0, slash), runtime) ||
+                !parseInt(param.substr(slash + 1), period) ||
+                runtime <= 0 || period < runtime) {
+                error = "deadline needs auto or <runtime_us>/<period_us> with runtime <= period";
+                return false;
+            }
+            result.dlRuntimeUs = static_cast<uint32_t>(runtime);
+            result.dlPeriodUs = static_cast<uint32_t>(period);
+        } else {
+            error = "unknown policy '" + name + "' (other, fifo, rr, deadline)";
+            return false;
+        }
+    }
+
+    policy = result;
+    return true;
+}
+
+bool parseThreadAssignment(const std::string& arg, ThreadPlacement& placement, std::string& error) {
+    size_t eq = arg.find('=');
+    if (eq == std::string::npos) {
+        error = "expected <role>=<policy>[:<param>][@<cpus>]";
+        return false;
+    }
+    std::string roleName = arg.substr(0, eq);
+
+    for (int i = 0; i < static_cast<int>(ThreadRole::COUNT); i++) {
+        ThreadRole role = static_cast<ThreadRole>(i);
+        if (roleName == threadRoleName(role)) {
+            if (!parseThreadPolicy(arg.substr(eq + 1), placement[role], error)) {
+                error = roleName + ": " + error;
+                return false;
+            }
+            if (placement[role].isDeadlineAuto() && role != ThreadRole::Worker) {
+                error = roleName + ": deadline:auto is only available for the worker";
+                return false;
+            }
+            // Applied without RESET_ON_FORK, and a SCHED_DEADLINE task
+            // without it cannot create threads
+            if (placement[role].policy == SchedPolicy::Deadline && role == ThreadRole::Squeezelite) {
+                error = roleName + ": deadline cannot be inherited by squeezelite's threads (use fifo or rr)";
+                return false;
+            }
+            return true;
+        }
+    }
+    error = "unknown thread role '" + roleName + "' (worker, ingest, log, sdk, squeezelite, convert)";
+    return false;
+}
+
+//=============================================================================
+// Placement
+//=============================================================================
+
+pid_t currentThreadId() {
+    return static_cast<pid_t>(syscall(SYS_gettid));
+}
+
+bool applyThreadPolicy(pid_t tid, const ThreadPolicy& policy, std::string* error) {
+    bool ok = true;
+    std::ostringstream err;
+
+    // Affinity first: SCHED_DEADLINE admission depends on the CPU mask
+    if (!policy.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : policy.cpus) CPU_SET(cpu, &set);
+        if (sched_setaffinity(tid, sizeof(set), &set) != 0) {
+            err << "affinity " << formatCpuList(policy.cpus) << ": " << strerror(errno) << "; ";
+            ok = false;
+        }
+    }
+
+    switch (policy.policy) {
+        case SchedPolicy::Inherit:
+            break;
+
+        case SchedPolicy::Other: {
+            struct sched_param param{};
+            if (sched_setscheduler(tid, SCHED_OTHER, &param) != 0 ||
+                setpriority(PRIO_PROCESS, static_cast<id_t>(tid), policy.priority) != 0) {
+                err << "SCHED_OTHER nice " << policy.priority << ": " << strerror(errno) << "; ";
+                ok = false;
+            }
+            break;
+        }
+
+        case SchedPolicy::Fifo:
+        case SchedPolicy::RoundRobin: {
+            struct sched_param param{};
+            param.sched_priority = policy.priority;
+            // RESET_ON_FORK: threads/processes created by an RT thread start
+            // as SCHED_OTHER instead of silently inheriting its RT priority
+            int native = (policy.policy == SchedPolicy::Fifo) ? SCHED_FIFO : SCHED_RR;
+            if (sched_setscheduler(tid, native | SCHED_RESET_ON_FORK, &param) != 0) {
+                err << describeThreadPolicy(policy) << ": " << strerror(errno) << "; ";
+                ok = false;
+            }
+            break;
+        }
+
+        case SchedPolicy::Deadline: {
+            if (policy.dlPeriodUs == 0) {
+                err << "SCHED_DEADLINE period not set; ";
+                ok = false;
+                break;
+            }
+            uint64_t runtimeNs = static_cast<uint64_t>(policy.dlRuntimeUs) * 1000;
+            uint64_t periodNs = static_cast<uint64_t>(policy.dlPeriodUs) * 1000;
+            uint64_t deadlineNs = policy.dlDeadlineUs ? static_cast<uint64_t>(policy.dlDeadlineUs) * 1000 : periodNs;
+            if (setDeadlineAttr(tid, runtimeNs, deadlineNs, periodNs) != 0) {
+                err << describeThreadPolicy(policy) << ": " << strerror(errno) << "; ";
+                ok = false;
+            }
+            break;
+        }
+    }
+
+    if (!ok && error) {
+        *error = err.str();
+        if (error->size() >= 2) error->resize(error->size() - 2);
+    }
+    return ok;
+}
+
+PreparedThreadPolicy prepareThreadPolicy(const ThreadPolicy& policy, bool resetOnFork) {
+    PreparedThreadPolicy prepared;
+    CPU_ZERO(&prepared.cpus);
+    if (!policy.cpus.empty()) {
+        prepared.setAffinity = true;
+        for (int cpu : policy.cpus) CPU_SET(cpu, &prepared.cpus);
+    }
+
+    switch (policy.policy) {
+        case SchedPolicy::Inherit:
+            break;
+        case SchedPolicy::Other:
+            prepared.native = SCHED_OTHER;
+            prepared.nice = policy.priority;
+            break;
+        case SchedPolicy::Fifo:
+        case SchedPolicy::RoundRobin:
+            prepared.native = (policy.policy == SchedPolicy::Fifo) ? SCHED_FIFO : SCHED_RR;
+            if (resetOnFork) prepared.native |= SCHED_RESET_ON_FORK;
+            prepared.priority = policy.priority;
+            break;
+        case SchedPolicy::Deadline:
+            // Without RESET_ON_FORK the kernel refuses fork() from the task
+            if (policy.dlPeriodUs == 0 || !resetOnFork) break;
+            prepared.deadline = true;
+            prepared.dlRuntimeNs = static_cast<uint64_t>(policy.dlRuntimeUs) * 1000;
+            prepared.dlPeriodNs = static_cast<uint64_t>(policy.dlPeriodUs) * 1000;
+            prepared.dlDeadlineNs = policy.dlDeadlineUs ? static_cast<uint64_t>(policy.dlDeadlineUs) * 1000
+                                                        : prepared.dlPeriodNs;
+            break;
+    }
+    return prepared;
+}
+
+int applyPreparedPolicy(const PreparedThreadPolicy& prepared) {
+    // Affinity first: SCHED_DEADLINE admission depends on the CPU mask
+    if (prepared.setAffinity && sched_setaffinity(0, sizeof(prepared.cpus), &prepared.cpus) != 0) {
+        return errno;
+    }
+    if (prepared.deadline) {
+        if (setDeadlineAttr(0, prepared.dlRuntimeNs, prepared.dlDeadlineNs, prepared.dlPeriodNs) != 0) return errno;
+    } else if (prepared.native != -1) {
+        struct sched_param param{};
+        param.sched_priority = prepared.priority;
+        if (sched_setscheduler(0, prepared.native, &param) != 0) return errno;
+        if ((prepared.native & ~SCHED_RESET_ON_FORK) == SCHED_OTHER &&
+            setpriority(PRIO_PROCESS, 0, prepared.nice) != 0) {
+            return errno;
+        }
+    }
+    return 0;
+}
+
+bool placeCurrentThread(const char* name, const ThreadPolicy& policy, bool verbose, bool rename) {
+    pid_t tid = currentThreadId();
+
+    if (rename) {
+        pthread_setname_np(pthread_self(), std::string(name).substr(0, 15).c_str());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        ThreadKey key{tid, threadStartTime(tid)};
+        if (!contains(s_ownThreads, key)) s_ownThreads.push_back(key);
+        if (rename && std::find(s_assignedNames.begin(), s_assignedNames.end(), name) == s_assignedNames.end()) {
+            s_assignedNames.push_back(name);
+        }
+    }
+
+    std::string error;
+    bool ok = applyThreadPolicy(0, policy, &error);
+    const char* label = name;
+
+    if (!ok) {
+        LOG_WARN("[Threads] " << label << " (tid " << tid << "): could not apply "
+                 << describeThreadPolicy(policy) << " — " << error
+                 << " (needs root or CAP_SYS_NICE)");
+    }
+    if (verbose) {
+        LOG_INFO("[Threads] " << label << " (tid " << tid << "): " << describeThreadPlacement(tid));
+    } else {
+        LOG_DEBUG("[Threads] " << label << " (tid " << tid << "): " << describeThreadPlacement(tid));
+    }
+    return ok;
+}
+
+int placeForeignThreads(const char* name, const ThreadPolicy& policy, bool verbose) {
+    std::vector<pid_t> fresh;
+    std::string processComm = readComm(getpid());
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        std::vector<ThreadKey> live;
+        for (pid_t tid : listProcessThreads()) {
+            ThreadKey key{tid, threadStartTime(tid)};
+            if (key.start != 0) live.push_back(key);
+        }
+        pruneRegistry(s_ownThreads, live);
+        pruneRegistry(s_foreignThreads, live);
+
+        for (const ThreadKey& key : live) {
+            if (key.tid == getpid() || contains(s_ownThreads, key) || contains(s_foreignThreads, key)) continue;
+            s_foreignThreads.push_back(key);
+            fresh.push_back(key.tid);
+        }
+
+        // Rename only threads that still carry an inherited name (ours or the
+        // process name) — keep any name the SDK chose itself
+        for (pid_t tid : fresh) {
+            std::string comm = readComm(tid);
+            bool inherited = (comm == processComm) ||
+                std::find(s_assignedNames.begin(), s_assignedNames.end(), comm) != s_assignedNames.end();
+            if (inherited) writeComm(tid, name);
+        }
+    }
+
+    for (pid_t tid : fresh) {
+        std::string error;
+        if (!applyThreadPolicy(tid, policy, &error)) {
+            LOG_WARN("[Threads] " << name << " (tid " << tid << "): could not apply "
+                     << describeThreadPolicy(policy) << " — " << error);
+        }
+        if (verbose) {
+            LOG_INFO("[Threads] " << readComm(tid) << " (tid " << tid << "): " << describeThreadPlacement(tid));
+        } else {
+            LOG_DEBUG("[Threads] " << readComm(tid) << " (tid " << tid << "): " << describeThreadPlacement(tid));
+        }
+    }
+    return static_cast<int>(fresh.size());
+}
+
+//=============================================================================
+// Reporting
+//=============================================================================
+
+std::string describeThreadPolicy(const ThreadPolicy& policy) {
+    std::ostringstream out;
+    switch (policy.policy) {
+        case SchedPolicy::Inherit:    out << "inherit"; break;
+        case SchedPolicy::Other:      out << "SCHED_OTHER nice " << policy.priority; break;
+        case SchedPolicy::Fifo:       out << "SCHED_FIFO/" << policy.priority; break;
+        case SchedPolicy::RoundRobin: out << "SCHED_RR/" << policy.priority; break;
+        case SchedPolicy::Deadline:
+            if (policy.dlPeriodUs == 0) {
+                out << "SCHED_DEADLINE auto";
+            } else {
+                out << "SCHED_DEADLINE " << policy.dlRuntimeUs << "/";
+                if (policy.dlDeadlineUs) out << policy.dlDeadlineUs << "/";
+                out << policy.dlPeriodUs << "us";
+            }
+            break;
+    }
+    if (!policy.cpus.empty()) out << " cpus=" << formatCpuList(policy.cpus);
+    return out.str();
+}
+
+std::string describeThreadPlacement(pid_t tid) {
+    std::ostringstream out;
+
+    int native = sched_getscheduler(tid);
+    if (native != -1) native &= ~SCHED_RESET_ON_FORK;
+    switch (native) {
+        case SCHED_FIFO:
+        case SCHED_RR: {
+            struct sched_param param{};
+            sched_getparam(tid, &param);
+            out << (native == SCHED_FIFO ? "SCHED_FIFO/" : "SCHED_RR/") << param.sched_priority;
+            break;
+        }
+        case SCHED_DEADLINE: {
+            DeadlineAttr attr;
+            if (getDeadlineAttr(tid, attr)) {
+                out << "SCHED_DEADLINE " << attr.sched_runtime / 1000 << "/"
+                    << attr.sched_deadline / 1000 << "/" << attr.sched_period / 1000 << "us";
+            } else {
+                out << "SCHED_DEADLINE";
+            }
+            break;
+        }
+        case -1:
+            out << "unknown (" << strerror(errno) << ")";
+            break;
+        default: {
+            errno = 0;
+            int nice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+            out << "SCHED_OTHER nice " << (errno == 0 ? nice : 0);
+            break;
+        }
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(tid, sizeof(set), &set) == 0) {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+        out << " cpus=" << formatCpuList(cpus);
+    }
+    return out.str();
+}
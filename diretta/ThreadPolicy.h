@@ -0,0 +1,155 @@
+/**
+ * @file ThreadPolicy.h
+ * @brief Thread naming, CPU affinity and scheduling policy
+ *
+ * Placement is applied by each thread itself when it starts (or, for the
+ * squeezelite child, right after fork()), instead of being patched in from
+ * outside with taskset/chrt once the process is already running.
+ *
+ * Placement spec syntax (one per --thread option):
+ *   <role>=<policy>[:<param>][@<cpus>]
+ *
+ *   role    worker | ingest | log | sdk | squeezelite | convert
+ *   policy  other[:nice] | fifo:<prio> | rr:<prio> | deadline:<runtime>/<period>
+ *           | deadline:auto (worker only: derived from the Diretta cycle time)
+ *   cpus    CPU list, e.g. 2  or  2,3  or  1-3
+ *
+ *   Examples: worker=fifo:60@2  sdk=fifo:55@2  squeezelite=other:-5@1,3  ingest=@3
+ *             convert=@1,3  (one CPU per conversion thread, round-robin)
+ *
+ * Roles left unset inherit from the thread that creates them. CPU affinity
+ * is inherited as usual; RT policies are set with RESET_ON_FORK so they do
+ * not leak into threads or processes started by an RT thread. The
+ * squeezelite role is the exception: it is applied without RESET_ON_FORK
+ * (so SCHED_DEADLINE is refused there), as it is meant for every thread
+ * squeezelite creates.
+ */
+
+#ifndef SQUEEZE2DIRETTA_THREADPOLICY_H
+#define SQUEEZE2DIRETTA_THREADPOLICY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include <sys/types.h>
+
+enum class SchedPolicy { Inherit, Other, Fifo, RoundRobin, Deadline };
+
+struct ThreadPolicy {
+    SchedPolicy policy = SchedPolicy::Inherit;
+    int priority = 0;               // FIFO/RR: 1-99, OTHER: nice value (-20..19)
+    uint32_t dlRuntimeUs = 0;       // SCHED_DEADLINE budget per period
+    uint32_t dlDeadlineUs = 0;      // SCHED_DEADLINE relative deadline (0 = period)
+    uint32_t dlPeriodUs = 0;        // SCHED_DEADLINE period (0 = auto, set by owner)
+    std::vector<int> cpus;          // Empty = inherit affinity
+
+    bool isInherit() const { return policy == SchedPolicy::Inherit && cpus.empty(); }
+    bool isDeadlineAuto() const { return policy == SchedPolicy::Deadline && dlPeriodUs == 0; }
+
+    static ThreadPolicy fifo(int prio) {
+        ThreadPolicy p;
+        p.policy = SchedPolicy::Fifo;
+        p.priority = prio;
+        return p;
+    }
+};
+
+enum class ThreadRole { Worker = 0, Ingest, LogDrain, Sdk, Squeezelite, Convert, COUNT };
+
+/**
+ * @brief Per-role placement table, filled from --thread options
+ */
+struct ThreadPlacement {
+    ThreadPolicy roles[static_cast<int>(ThreadRole::COUNT)];
+
+    ThreadPlacement() {
+        // F1 default: worker at SCHED_FIFO 50, everything else inherits
+        roles[static_cast<int>(ThreadRole::Worker)] = ThreadPolicy::fifo(50);
+    }
+
+    ThreadPolicy& operator[](ThreadRole role) { return roles[static_cast<int>(role)]; }
+    const ThreadPolicy& operator[](ThreadRole role) const { return roles[static_cast<int>(role)]; }
+};
+
+const char* threadRoleName(ThreadRole role);
+
+/**
+ * @brief Parse "<role>=<spec>" into the placement table
+ * @return false with a human-readable message in error on bad input
+ */
+bool parseThreadAssignment(const std::string& arg, ThreadPlacement& placement, std::string& error);
+
+/**
+ * @brief Parse "<policy>[:<param>][@<cpus>]" (the part after "<role>=")
+ */
+bool parseThreadPolicy(const std::string& spec, ThreadPolicy& policy, std::string& error);
+
+/**
+ * @brief Apply affinity and scheduling policy to a thread
+ * @param tid Kernel thread id, 0 = calling thread
+ * @return true if everything requested was applied
+ */
+bool applyThreadPolicy(pid_t tid, const ThreadPolicy& policy, std::string* error = nullptr);
+
+/**
+ * @brief A policy resolved to plain syscall arguments, applied between
+ *        fork() and exec() where only async-signal-safe calls are allowed
+ */
+struct PreparedThreadPolicy {
+    bool setAffinity = false;
+    cpu_set_t cpus;
+    int native = -1;                // sched_setscheduler() policy and flags, -1 = leave alone
+    int priority = 0;               // FIFO/RR priority
+    int nice = 0;                   // SCHED_OTHER
+    bool deadline = false;
+    uint64_t dlRuntimeNs = 0;
+    uint64_t dlDeadlineNs = 0;
+    uint64_t dlPeriodNs = 0;
+};
+
+/**
+ * @brief Resolve a policy for applyPreparedPolicy() (allocates: call before fork())
+ * @param resetOnFork false = threads and processes the caller creates keep
+ *                    the RT policy (not possible with SCHED_DEADLINE)
+ */
+PreparedThreadPolicy prepareThreadPolicy(const ThreadPolicy& policy, bool resetOnFork = true);
+
+/**
+ * @brief Apply a prepared policy to the calling thread with raw syscalls only
+ * @return 0, or the errno of the first step that failed
+ */
+int applyPreparedPolicy(const PreparedThreadPolicy& prepared);
+
+/**
+ * @brief Name, place and register the calling thread
+ *
+ * Registered threads are ours; anything else showing up in /proc/self/task
+ * is attributed to the Diretta SDK by placeForeignThreads(), so every thread
+ * we start must call this before an open() can run elsewhere. Entries are
+ * keyed on tid and start time and dropped once the thread exits.
+ * Logs the effective placement (INFO if verbose is true, DEBUG otherwise).
+ * With rename=false the kernel thread name is left alone (used for the main
+ * thread, whose name is what ps/pgrep/killall report for the process).
+ */
+bool placeCurrentThread(const char* name, const ThreadPolicy& policy,
+                        bool verbose = false, bool rename = true);
+
+/**
+ * @brief Name and place threads we did not create (Diretta SDK internals)
+ *
+ * Each foreign thread is handled once; later calls only pick up new ones
+ * (a reused tid is a new thread).
+ * @return Number of newly placed threads
+ */
+int placeForeignThreads(const char* name, const ThreadPolicy& policy, bool verbose = false);
+
+/**
+ * @brief Describe the effective scheduling of a thread, e.g. "SCHED_FIFO/50 cpus=2-3"
+ */
+std::string describeThreadPlacement(pid_t tid);
+std::string describeThreadPolicy(const ThreadPolicy& policy);
+
+pid_t currentThreadId();
+
+#endif // SQUEEZE2DIRETTA_THREADPOLICY_H
@@ -0,0 +1,124 @@
+/**
+ * @file ZoneFile.cpp
+ * @brief Zone file of multi-zone mode (--zones <file>)
+ */
+
+#include "ZoneFile.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// Split a zone line into tokens; double quotes keep spaces ("Living Room")
+std::vector<std::string> splitZoneLine(const std::string& line) {
+    std::vector<std::string> tokens;
+    std::string token;
+    bool quoted = false, haveToken = false;
+    for (char c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            haveToken = true;
+        } else if (!quoted && (c == ' ' || c == '\t' || c == '\r')) {
+            if (haveToken) tokens.push_back(token);
+            token.clear();
+            haveToken = false;
+        } else if (!quoted && c == '#') {
+            break;  // Comment
+        } else {
+            token += c;
+            haveToken = true;
+        }
+    }
+    if (haveToken) tokens.push_back(token);
+    return tokens;
+}
+
+} // namespace
+
+bool loadZoneFile(const std::string& path, const ZoneSpec& defaults,
+                  std::vector<ZoneSpec>& zones, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path + ": " + strerror(errno);
+        return false;
+    }
+    return parseZones(in, path, defaults, zones, error);
+}
+
+bool parseZones(std::istream& in, const std::string& source, const ZoneSpec& defaults,
+                std::vector<ZoneSpec>& zones, std::string& error) {
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        std::vector<std::string> tokens = splitZoneLine(line);
+        if (tokens.empty()) continue;
+
+        ZoneSpec zone;
+        zone.target = -1;
+        zone.rates = defaults.rates;
+        zone.worker = defaults.worker;
+        std::string where = source + ":" + std::to_string(lineNo) + ": ";
+
+        for (const auto& token : tokens) {
+            size_t eq = token.find('=');
+            if (eq == std::string::npos) {
+                error = where + "expected key=value, got '" + token + "'";
+                return false;
+            }
+            std::string key = token.substr(0, eq);
+            std::string value = token.substr(eq + 1);
+
+            if (key == "name") {
+                zone.name = value;
+            } else if (key == "target") {
+                char* end = nullptr;
+                long target = std::strtol(value.c_str(), &end, 10);
+                if (*end != '\0' || target < 1) {
+                    error = where + "invalid target '" + value + "' (1 = first)";
+                    return false;
+                }
+                zone.target = static_cast<int>(target - 1);
+            } else if (key == "mac") {
+                zone.mac = value;
+            } else if (key == "rates") {
+                zone.rates = value;
+            } else if (key == "worker") {
+                std::string policyError;
+                if (!parseThreadPolicy(value, zone.worker, policyError)) {
+                    error = where + "worker=" + value + ": " + policyError;
+                    return false;
+                }
+            } else {
+                error = where + "unknown key '" + key + "'";
+                return false;
+            }
+        }
+
+        if (zone.name.empty() || zone.target < 0) {
+            error = where + "name= and target= are required";
+            return false;
+        }
+        for (const auto& other : zones) {
+            if (other.name == zone.name) {
+                error = where + "duplicate zone name '" + zone.name + "'";
+                return false;
+            }
+            if (other.target == zone.target) {
+                error = where + "target " + std::to_string(zone.target + 1)
+                        + " already used by '" + other.name + "'";
+                return false;
+            }
+        }
+        zones.push_back(zone);
+    }
+
+    if (zones.empty()) {
+        error = source + ": no zones defined";
+        return false;
+    }
+    return true;
+}
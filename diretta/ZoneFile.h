@@ -0,0 +1,47 @@
+/**
+ * @file ZoneFile.h
+ * @brief Zone file of multi-zone mode (--zones <file>)
+ *
+ * One zone per line, key=value tokens; double quotes keep spaces in a value
+ * ("Living Room") and '#' starts a comment:
+ *
+ *   name=<player>  target=<n>  [mac=<mac>] [rates=<max>] [worker=<policy>]
+ *
+ * target counts from 1, like -t. rates and worker default to the global -r
+ * and --thread worker= values. Needs neither the Diretta SDK nor the rest
+ * of the wrapper.
+ */
+
+#ifndef SQUEEZE2DIRETTA_ZONEFILE_H
+#define SQUEEZE2DIRETTA_ZONEFILE_H
+
+#include "ThreadPolicy.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+struct ZoneSpec {
+    std::string name;                    // squeezelite player name (-n)
+    int target = 0;                      // Diretta target (0-based)
+    std::string mac;                     // -m (derived from the name if empty)
+    std::string rates;                   // -r maximum (default: global -r)
+    ThreadPolicy worker;                 // Worker placement (default: --thread worker=)
+};
+
+/**
+ * @brief Read a zone file
+ * @param defaults rates and worker for zones that do not set them
+ * @return false with "<file>:<line>: <reason>" in error on bad input, a
+ *         name or target used twice, or no zone at all
+ */
+bool loadZoneFile(const std::string& path, const ZoneSpec& defaults,
+                  std::vector<ZoneSpec>& zones, std::string& error);
+
+/**
+ * @brief Same, from a stream; source names it in error messages
+ */
+bool parseZones(std::istream& in, const std::string& source, const ZoneSpec& defaults,
+                std::vector<ZoneSpec>& zones, std::string& error);
+
+#endif // SQUEEZE2DIRETTA_ZONEFILE_H
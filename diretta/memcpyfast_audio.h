@@ -16,6 +16,43 @@
     #define MEMCPY_AUDIO_ARM64 1
 #endif
 
+//---------------------------------------------------------------------
+// Copy strategy for memcpy_audio(), pinned at startup by the memcpy
+// calibration (MemcpyCalibration.h) through setMemcpyAudioStrategy(),
+// which resolves it once into the function memcpy_audio() calls.
+// DEFAULT keeps the CPUID-based choice.
+//---------------------------------------------------------------------
+enum MemcpyAudioStrategy {
+    MEMCPY_AUDIO_DEFAULT = 0,
+    MEMCPY_AUDIO_AVX_UNROLLED,   // memcpy_audio_fast: 512-byte unrolled AVX (FastMemcpy_Audio.h)
+    MEMCPY_AUDIO_AVX_FIXED,      // memcpy_audio_fixed: overlapping-tail AVX
+    MEMCPY_AUDIO_AVX_GENERIC,    // memcpy_fast (FastMemcpy_Avx.h)
+    MEMCPY_AUDIO_AVX512,         // memcpy_audio_avx512 (FastMemcpy_Audio_AVX512.h)
+    MEMCPY_AUDIO_LIBC,           // glibc memcpy (ERMS rep movsb or vector, glibc's choice)
+    MEMCPY_AUDIO_REP_MOVSB,      // rep movsb, always
+    MEMCPY_AUDIO_STRATEGY_COUNT
+};
+
+inline int g_memcpy_audio_strategy = MEMCPY_AUDIO_DEFAULT;
+
+using MemcpyAudioFn = void* (*)(void* dst, const void* src, size_t len);
+
+inline void* memcpy_audio_libc(void* dst, const void* src, size_t len) {
+    return std::memcpy(dst, src, len);
+}
+
+#if defined(MEMCPY_AUDIO_X86) && defined(__x86_64__) && defined(__GNUC__)
+#define MEMCPY_AUDIO_HAS_REP_MOVSB 1
+static inline void memcpy_rep_movsb(void* dst, const void* src, size_t size) {
+    __asm__ volatile("rep movsb" : "+D"(dst), "+S"(src), "+c"(size) : : "memory");
+}
+
+inline void* memcpy_audio_rep_movsb(void* dst, const void* src, size_t len) {
+    memcpy_rep_movsb(dst, src, len);
+    return dst;
+}
+#endif
+
 //---------------------------------------------------------------------
 // x86 with AVX2: Use optimized SIMD memcpy
 //---------------------------------------------------------------------
@@ -133,13 +170,93 @@ static inline void prefetch_audio_buffer(const void* src, size_t size) {
     }
 }
 
+/**
+ * Non-temporal copy for ring writes far ahead of the reader
+ * Streaming stores bypass the cache, so data that will not be read for
+ * hundreds of ms does not evict the consumer's working set.
+ * Ends with sfence: NT stores are weakly ordered and must be visible
+ * before the caller publishes its write position.
+ */
+static inline void memcpy_audio_stream(void* dst, const void* src, size_t size) {
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+
+    // Head: regular stores up to the first 32-byte boundary of dst
+    size_t head = (32 - (reinterpret_cast<uintptr_t>(d) & 31)) & 31;
+    if (head > size) head = size;
+    if (head > 0) {
+        memcpy_audio_fixed(d, s, head);
+        d += head;
+        s += head;
+        size -= head;
+    }
+
+    while (size >= 128) {
+        __m256i r0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 0));
+        __m256i r1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32));
+        __m256i r2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 64));
+        __m256i r3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 0), r0);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 32), r1);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 64), r2);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + 96), r3);
+        s += 128;
+        d += 128;
+        size -= 128;
+    }
+    while (size >= 32) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+        s += 32;
+        d += 32;
+        size -= 32;
+    }
+
+    if (size > 0) {
+        memcpy_audio_fixed(d, s, size);
+    }
+    _mm_sfence();
+    _mm256_zeroupper();
+}
+
 //---------------------------------------------------------------------
 // Threshold for AVX-512 usage (32KB)
 //---------------------------------------------------------------------
 #define AVX512_THRESHOLD (32 * 1024)
 
+inline void* memcpy_audio_fixed_strategy(void* dst, const void* src, size_t len) {
+    memcpy_audio_fixed(dst, src, len);
+    return dst;
+}
+
+inline void* memcpy_audio_unrolled(void* dst, const void* src, size_t len) {
+    return memcpy_audio_fast(dst, src, len);
+}
+
+inline void* memcpy_audio_generic(void* dst, const void* src, size_t len) {
+    return memcpy_fast(dst, src, len);
+}
+
+#ifdef __AVX512F__
+inline void* memcpy_audio_avx512_strategy(void* dst, const void* src, size_t len) {
+    return memcpy_audio_avx512(dst, src, len);
+}
+#endif
+
+// DEFAULT strategy: selects optimal path based on size and CPU
+inline void* memcpy_audio_auto(void* dst, const void* src, size_t len) {
+#ifdef __AVX512F__
+    if (len >= AVX512_THRESHOLD && detect_avx512()) {
+        return memcpy_audio_avx512(dst, src, len);
+    }
+#endif
+    return memcpy_audio_fast(dst, src, len);
+}
+
+inline MemcpyAudioFn g_memcpy_audio_impl = memcpy_audio_auto;
+
 //---------------------------------------------------------------------
-// Main dispatcher - selects optimal path based on size and CPU (x86)
+// Main dispatcher - one indirect call to the pinned strategy (x86)
 //---------------------------------------------------------------------
 static inline void* memcpy_audio(void *dst, const void *src, size_t len) {
 #ifndef NDEBUG
@@ -152,13 +269,7 @@ static inline void* memcpy_audio(void *dst, const void *src, size_t len) {
     }
 #endif
 
-#ifdef __AVX512F__
-    if (len >= AVX512_THRESHOLD && detect_avx512()) {
-        return memcpy_audio_avx512(dst, src, len);
-    }
-#endif
-
-    return memcpy_audio_fast(dst, src, len);
+    return g_memcpy_audio_impl(dst, src, len);
 }
 
 #else // !AVX2 (ARM64, x86 without AVX2, and other platforms)
@@ -178,8 +289,10 @@ static inline void prefetch_audio_buffer(const void* src, size_t size) {
     // ARM64: __builtin_prefetch could be added here if needed
 }
 
+inline MemcpyAudioFn g_memcpy_audio_impl = memcpy_audio_libc;
+
 /**
- * Audio memcpy - uses standard memcpy
+ * Audio memcpy - uses standard memcpy unless rep movsb was pinned
  * GCC/Clang will auto-vectorize with NEON on ARM64
  * On x86 without AVX2, glibc memcpy is already well-optimized
  */
@@ -193,7 +306,7 @@ static inline void* memcpy_audio(void *dst, const void *src, size_t len) {
         abort();
     }
 #endif
-    return std::memcpy(dst, src, len);
+    return g_memcpy_audio_impl(dst, src, len);
 }
 
 /**
@@ -203,6 +316,111 @@ static inline void memcpy_audio_fixed(void* dst, const void* src, size_t size) {
     std::memcpy(dst, src, size);
 }
 
+/**
+ * Non-temporal copy for ring writes far ahead of the reader
+ * - ARM64: LDP/STNP pairs (non-temporal hint, ordered by the caller's
+ *   store-release of the write position)
+ * - x86 without AVX2: SSE2 _mm_stream_si128 + sfence
+ * - Others: standard memcpy
+ */
+#if defined(MEMCPY_AUDIO_ARM64) && defined(__GNUC__)
+static inline void memcpy_audio_stream(void* dst, const void* src, size_t size) {
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+
+    while (size >= 64) {
+        __asm__ volatile(
+            "ldp q0, q1, [%[s]]\n\t"
+            "ldp q2, q3, [%[s], #32]\n\t"
+            "stnp q0, q1, [%[d]]\n\t"
+            "stnp q2, q3, [%[d], #32]\n\t"
+            :
+            : [s] "r"(s), [d] "r"(d)
+            : "v0", "v1", "v2", "v3", "memory");
+        s += 64;
+        d += 64;
+        size -= 64;
+    }
+    if (size > 0) {
+        std::memcpy(d, s, size);
+    }
+}
+#elif defined(MEMCPY_AUDIO_X86)
+#include <emmintrin.h>
+
+static inline void memcpy_audio_stream(void* dst, const void* src, size_t size) {
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+
+    size_t head = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+    if (head > size) head = size;
+    std::memcpy(d, s, head);
+    d += head;
+    s += head;
+    size -= head;
+
+    while (size >= 16) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+        s += 16;
+        d += 16;
+        size -= 16;
+    }
+    std::memcpy(d, s, size);
+    _mm_sfence();
+}
+#else
+static inline void memcpy_audio_stream(void* dst, const void* src, size_t size) {
+    std::memcpy(dst, src, size);
+}
+#endif
+
 #endif // MEMCPY_AUDIO_X86 && __AVX2__
 
+/**
+ * Pin the strategy memcpy_audio() uses (resolved here, not per call)
+ * Strategies not built in fall back to DEFAULT. memcpy_audio_fixed(),
+ * memcpy_audio_stream() and the ring's exact-size pops never consult it.
+ */
+static inline void setMemcpyAudioStrategy(int strategy) {
+    MemcpyAudioFn fn = nullptr;
+    switch (strategy) {
+#if defined(MEMCPY_AUDIO_X86) && defined(__AVX2__)
+        case MEMCPY_AUDIO_AVX_UNROLLED: fn = memcpy_audio_unrolled; break;
+        case MEMCPY_AUDIO_AVX_FIXED:    fn = memcpy_audio_fixed_strategy; break;
+        case MEMCPY_AUDIO_AVX_GENERIC:  fn = memcpy_audio_generic; break;
+#ifdef __AVX512F__
+        case MEMCPY_AUDIO_AVX512:       fn = memcpy_audio_avx512_strategy; break;
+#endif
+#endif
+        case MEMCPY_AUDIO_LIBC:         fn = memcpy_audio_libc; break;
+#ifdef MEMCPY_AUDIO_HAS_REP_MOVSB
+        case MEMCPY_AUDIO_REP_MOVSB:    fn = memcpy_audio_rep_movsb; break;
+#endif
+        default: break;
+    }
+    if (fn == nullptr) {
+        strategy = MEMCPY_AUDIO_DEFAULT;
+#if defined(MEMCPY_AUDIO_X86) && defined(__AVX2__)
+        fn = memcpy_audio_auto;
+#else
+        fn = memcpy_audio_libc;
+#endif
+    }
+    g_memcpy_audio_strategy = strategy;
+    g_memcpy_audio_impl = fn;
+}
+
+/**
+ * Pull a range into L1 ahead of a copy (one prefetch per cache line)
+ * Used by the ring consumer for its next buffer when the producer writes
+ * with streaming stores, so that data comes from DRAM, not the cache.
+ */
+static inline void prefetch_audio_range(const void* src, size_t size) {
+    const char* p = static_cast<const char*>(src);
+    for (size_t offset = 0; offset < size; offset += 64) {
+        __builtin_prefetch(p + offset, 0, 3);
+    }
+}
+
 #endif // __MEMCPYFAST_AUDIO_H__
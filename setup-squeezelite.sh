@@ -179,8 +179,16 @@ main() {
         exit 1
     fi
 
+    # An older revision of the patch (format header only, no coalesced
+    # writes) is reverted first so the current one applies cleanly
+    if grep -q "sq_format_header" output_stdout.c 2>/dev/null && \
+       ! grep -q "SQ_STDOUT_WRITE_BYTES" output_stdout.c 2>/dev/null; then
+        echo -e "${YELLOW}Older format header patch found, updating it...${NC}"
+        git checkout -- output_stdout.c
+    fi
+
     # Check if already patched (v2.0 format header patch)
-    if grep -q "sq_format_header" output_stdout.c 2>/dev/null; then
+    if grep -q "SQ_STDOUT_WRITE_BYTES" output_stdout.c 2>/dev/null; then
         echo -e "${GREEN}v2.0 format header patch already applied${NC}"
     else
         echo -e "${GREEN}Applying v2.0 format header patch...${NC}"
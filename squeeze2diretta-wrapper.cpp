@@ -20,49 +20,69 @@
 
 #include "DirettaSync.h"
 #include "globals.h"
+#include "ThreadPolicy.h"
+#include "MemoryLock.h"
+#include "RtAudit.h"
+#include "AudioArena.h"
+#include "ConvertPool.h"
+#include "Benchmark.h"
+#include "Calibration.h"
+#include "MemcpyCalibration.h"
+#include "StateFile.h"
+#include "SqStream.h"
+#include "ZoneFile.h"
+#include "LatencyBudget.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <vector>
 #include <cstring>
 #include <cstdlib>
+#include <cctype>
+#include <algorithm>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <fcntl.h>
-#include <poll.h>
 #include <memory>
+#include <future>
 #include <thread>
 #include <mutex>
 #include <chrono>
 #include <sstream>
+#include <atomic>
+#include <fstream>
+#include <condition_variable>
+#include <functional>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <sys/ioctl.h>
 
 // Version
 #define WRAPPER_VERSION "2.0.2"
 
-// Check if buffer is all zeros (PCM/DSD silence from squeezelite)
+// Check if buffer is all zeros (PCM/DSD silence from squeezelite). For data
+// that is not converted; conversions report it from their own pass
 static bool isSilence(const uint8_t* data, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        if (data[i] != 0) return false;
-    }
-    return true;
+    return or_reduce_audio(data, len) == 0;
 }
 
 // ================================================================
-// In-band format header (must match squeezelite output_stdout.c)
+// In-band format header (SqFormatHeader, SqStream.h)
 // ================================================================
-struct __attribute__((packed)) SqFormatHeader {
-    uint8_t  magic[4];       // "SQFH"
-    uint8_t  version;        // Protocol version: 1
-    uint8_t  channels;       // 2 for stereo
-    uint8_t  bit_depth;      // PCM: 16/24/32, DSD: 1, DoP: 24
-    uint8_t  dsd_format;     // 0=PCM, 1=DOP, 2=DSD_U32_LE, 3=DSD_U32_BE
-    uint32_t sample_rate;    // Sample/frame rate in Hz (LE)
-    uint8_t  reserved[4];    // Zero-filled
-};
 
-static_assert(sizeof(SqFormatHeader) == 16, "SqFormatHeader must be 16 bytes");
+// Squeezelite always outputs S32_LE (4 bytes per sample)
+static constexpr size_t SQZ_BYTES_PER_SAMPLE = 4;
+
+// PCM read/send chunk (DSD: see chunk_bytes_for())
+static constexpr size_t PIPE_BUF_SIZE = 16384;
+
+// Highest squeezelite -r: PCM up to 768 kHz by default, 1.5 MHz frame rates
+// carry DSD1024 in u32 containers (45.1584 MHz / 32 = 1,411,200)
+static constexpr uint32_t MAX_SQUEEZELITE_RATE = 1536000;
 
 static constexpr uint8_t SQFH_MAGIC[4] = {'S', 'Q', 'F', 'H'};
 
@@ -78,7 +98,7 @@ static bool isValidHeader(const SqFormatHeader& hdr) {
     if (hdr.dsd_format > 3) return false;
     if (hdr.bit_depth != 1 && hdr.bit_depth != 16 &&
         hdr.bit_depth != 24 && hdr.bit_depth != 32) return false;
-    if (hdr.sample_rate == 0 || hdr.sample_rate > 768000) return false;
+    if (hdr.sample_rate == 0 || hdr.sample_rate > MAX_SQUEEZELITE_RATE) return false;
     return true;
 }
 
@@ -90,12 +110,103 @@ enum class DSDFormatType : uint8_t {
     U32_BE = 3   // Native DSD Big Endian
 };
 
+// Squeezelite's coalesced write size (SQ_STDOUT_WRITE_BYTES, set once at
+// startup): one PipeReader buffer, less under a tight --latency-budget
+static size_t g_pipe_write_bytes = 65536;
+
+// ================================================================
+// Kernel pipe capacity and occupancy
+// ================================================================
+// While the ingest thread is stalled (open() on a format change, waiting
+// for ring space) the pipe is all squeezelite has to write into. It is
+// sized per format for --pipe-stall-ms of input, so squeezelite keeps
+// decoding through such a stall. Occupancy is sampled on every read.
+class PipeGauge {
+public:
+    explicit PipeGauge(int fd) : m_fd(fd) {
+        int capacity = fcntl(fd, F_GETPIPE_SZ);
+        if (capacity > 0) m_capacity = static_cast<size_t>(capacity);
+    }
+
+    // Capacity for stall_ms of bytes_per_second: at least two of
+    // squeezelite's writes, at most /proc/sys/fs/pipe-max-size (the kernel
+    // rounds up to a power of two pages). 0 ms keeps the current size.
+    void resize(double bytes_per_second, unsigned int stall_ms, size_t min_bytes) {
+        if (stall_ms == 0) return;
+        size_t want = static_cast<size_t>(bytes_per_second * stall_ms / 1000.0);
+        want = std::min(std::max(want, min_bytes), maxCapacity());
+        int got = fcntl(m_fd, F_SETPIPE_SZ, static_cast<int>(want));
+        if (got < 0) {
+            // EBUSY: more is queued than the new size holds; keep the old one
+            LOG_DEBUG("[Pipe] Cannot resize to " << want / 1024 << " KB: " << strerror(errno));
+            return;
+        }
+        m_capacity = static_cast<size_t>(got);
+        LOG_INFO("[Pipe] Capacity " << m_capacity / 1024 << " KB ("
+                 << std::fixed << std::setprecision(0)
+                 << m_capacity * 1000.0 / bytes_per_second << " ms of input)");
+    }
+
+    // A read() asked for want bytes and got got: a short read drained the
+    // pipe, a full one leaves FIONREAD behind. Squeezelite is back-pressured
+    // when its next write (backpressure_bytes) no longer fits.
+    void sample(size_t want, ssize_t got, size_t backpressure_bytes) {
+        if (got <= 0) return;
+        size_t occupancy = static_cast<size_t>(got);
+        int queued = 0;
+        if (occupancy == want && ioctl(m_fd, FIONREAD, &queued) == 0) {
+            occupancy += static_cast<size_t>(queued);
+        }
+        occupancy = std::min(occupancy, m_capacity);    // Writes racing the ioctl
+        m_samples++;
+        m_sum += occupancy;
+        m_peak = std::max(m_peak, occupancy);
+        if (occupancy + backpressure_bytes > m_capacity) m_full++;
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+    // One stats line, then start a new period
+    void print(const char* prefix) {
+        std::cout << prefix << "[Pipe] capacity " << m_capacity / 1024 << " KB";
+        if (m_samples > 0) {
+            std::cout << ", occupancy avg " << m_sum / m_samples / 1024 << " KB, peak "
+                      << m_peak / 1024 << " KB, squeezelite back-pressured in "
+                      << std::fixed << std::setprecision(1)
+                      << 100.0 * m_full / m_samples << "% of " << m_samples << " reads";
+        }
+        std::cout << std::endl;
+        m_samples = m_sum = m_full = 0;
+        m_peak = 0;
+    }
+
+private:
+    static size_t maxCapacity() {
+        static const size_t max_bytes = []() {
+            size_t value = 0;
+            std::ifstream in("/proc/sys/fs/pipe-max-size");
+            if (!(in >> value) || value == 0) value = 1048576;
+            return value;
+        }();
+        return max_bytes;
+    }
+
+    int m_fd;
+    size_t m_capacity = 65536;    // Linux default
+    uint64_t m_samples = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_full = 0;
+    size_t m_peak = 0;
+};
+
 // ================================================================
 // Buffered pipe reader with peek support
 // ================================================================
 class PipeReader {
 public:
-    explicit PipeReader(int fd) : m_fd(fd), m_pos(0), m_len(0) {}
+    static constexpr size_t BUFFER_BYTES = 65536;    // Default kernel pipe size
+
+    explicit PipeReader(int fd) : m_fd(fd), m_pos(0), m_len(0), m_gauge(fd) {}
 
     // Read exactly n bytes (blocking). Returns false on EOF/error.
     bool readExact(void* dst, size_t n) {
@@ -115,7 +226,7 @@ public:
             }
 
             // Buffer empty — refill from pipe
-            ssize_t n_read = ::read(m_fd, m_buf, sizeof(m_buf));
+            ssize_t n_read = readPipe(m_buf, sizeof(m_buf));
             if (n_read <= 0) return false;  // EOF or error
             m_pos = 0;
             m_len = static_cast<size_t>(n_read);
@@ -142,7 +253,7 @@ public:
 
         // Read more data
         while (m_len < n) {
-            ssize_t n_read = ::read(m_fd, m_buf + m_len, sizeof(m_buf) - m_len);
+            ssize_t n_read = readPipe(m_buf + m_len, sizeof(m_buf) - m_len);
             if (n_read <= 0) return false;
             m_len += static_cast<size_t>(n_read);
         }
@@ -158,7 +269,7 @@ public:
         size_t avail = m_len - m_pos;
         if (avail == 0) {
             // Buffer empty — refill from pipe
-            ssize_t n_read = ::read(m_fd, m_buf, sizeof(m_buf));
+            ssize_t n_read = readPipe(m_buf, sizeof(m_buf));
             if (n_read <= 0) return n_read;
             m_pos = 0;
             m_len = static_cast<size_t>(n_read);
@@ -184,42 +295,156 @@ public:
         return static_cast<ssize_t>(chunk);
     }
 
-    // Wait for data with timeout. Returns true if data available, false on timeout.
-    bool waitForData(int timeout_ms) {
-        if (m_len - m_pos > 0) return true;  // Internal buffer has data
-        struct pollfd pfd = { m_fd, POLLIN, 0 };
-        return ::poll(&pfd, 1, timeout_ms) > 0;
+    // Non-blocking pipe: called when it is empty, returns once it is readable
+    // (true) or the reader should give up (false). Not used by fill().
+    void setWaiter(std::function<bool()> waiter) { m_waiter = std::move(waiter); }
+
+    // Bytes buffered and not yet consumed (served without touching the pipe)
+    size_t buffered() const { return m_len - m_pos; }
+
+    // One read() into the free space, for non-blocking pipes driven by epoll.
+    // Returns bytes read, 0 on EOF, -1 on error (errno EAGAIN: pipe drained).
+    ssize_t fill() {
+        size_t avail = m_len - m_pos;
+        if (avail > 0 && m_pos > 0) {
+            memmove(m_buf, m_buf + m_pos, avail);
+        }
+        m_pos = 0;
+        m_len = avail;
+        if (m_len == sizeof(m_buf)) {
+            errno = EAGAIN;  // Full: consume before filling again
+            return -1;
+        }
+        ssize_t n_read = ::read(m_fd, m_buf + m_len, sizeof(m_buf) - m_len);
+        m_gauge.sample(sizeof(m_buf) - m_len, n_read, g_pipe_write_bytes);
+        if (n_read > 0) m_len += static_cast<size_t>(n_read);
+        return n_read;
     }
 
+    // Push back the last n bytes returned by readUpTo()/readExact()
+    void unread(size_t n) { m_pos -= std::min(n, m_pos); }
+
+    PipeGauge& gauge() { return m_gauge; }
+
 private:
+    ssize_t readPipe(uint8_t* dst, size_t n) {
+        ssize_t n_read;
+        while ((n_read = ::read(m_fd, dst, n)) < 0 && errno == EAGAIN && m_waiter) {
+            if (!m_waiter()) return -1;
+        }
+        m_gauge.sample(n, n_read, g_pipe_write_bytes);
+        return n_read;
+    }
+
     int m_fd;
     size_t m_pos;
     size_t m_len;
-    uint8_t m_buf[65536];
+    std::function<bool()> m_waiter;
+    PipeGauge m_gauge;
+    uint8_t m_buf[BUFFER_BYTES];
 };
 
 // ================================================================
 // Global state
 // ================================================================
 static pid_t squeezelite_pid = 0;
-static bool running = true;
+static std::atomic<bool> running{true};
 static std::unique_ptr<DirettaSync> g_diretta;
+static std::vector<std::unique_ptr<DirettaSync>> g_fanout;  // --fanout followers
+static ConvertPool g_convert;                               // --convert-threads
 
-// Signal handler for clean shutdown
-void signal_handler(int sig) {
-    std::cout << "\nSignal " << sig << " received, shutting down..." << std::endl;
-    running = false;
+// ================================================================
+// Control signals and epoll tags
+// ================================================================
+// SIGINT/SIGTERM/SIGUSR1/SIGCHLD are blocked in every thread (block them
+// before the first thread starts) and read from a signalfd by the control
+// loop, so no code runs in signal context. Children get them back before exec.
+static sigset_t control_signals() {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGTERM);
+    sigaddset(&set, SIGUSR1);
+    sigaddset(&set, SIGCHLD);
+    return set;
+}
 
-    if (squeezelite_pid > 0) {
-        kill(squeezelite_pid, SIGTERM);
-    }
+// What an epoll event of a control loop belongs to (data.u64: source, zone)
+enum class LoopSource : uint32_t {
+    Pipe,           // squeezelite stdout
+    Space,          // DirettaSync::spaceEventFd()
+    Signal,         // signalfd
+    IdleTimer,      // timerfd: idle release
+    StatsTimer,     // timerfd: --stats-interval
+    Tick,           // timerfd: multi-zone housekeeping
+    Jobs            // eventfd: multi-zone control thread completions
+};
+
+static uint64_t loop_tag(LoopSource source, uint32_t zone = 0) {
+    return (static_cast<uint64_t>(source) << 32) | zone;
+}
+
+static LoopSource loop_source(uint64_t tag) { return static_cast<LoopSource>(tag >> 32); }
+static uint32_t loop_zone(uint64_t tag) { return static_cast<uint32_t>(tag); }
+
+static bool loop_add(int epoll_fd, int fd, uint64_t tag) {
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = tag;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+// Clear a readable eventfd/timerfd
+static void drain_fd(int fd) {
+    uint64_t count;
+    ssize_t ignored = read(fd, &count, sizeof(count));
+    (void)ignored;
+}
+
+// One-shot (interval 0) or periodic timerfd; 0 ms disarms
+static void set_timer(int fd, int64_t first_ms, int64_t interval_ms = 0) {
+    struct itimerspec spec{};
+    spec.it_value.tv_sec = first_ms / 1000;
+    spec.it_value.tv_nsec = (first_ms % 1000) * 1000000;
+    spec.it_interval.tv_sec = interval_ms / 1000;
+    spec.it_interval.tv_nsec = (interval_ms % 1000) * 1000000;
+    timerfd_settime(fd, 0, &spec, nullptr);
+}
+
+// ================================================================
+// Async log drain (prints DIRETTA_LOG_ASYNC entries from hot paths)
+// ================================================================
+static std::thread g_logDrainThread;
+static std::atomic<bool> g_logDrainRunning{false};
+
+static void start_log_drain(const ThreadPolicy& policy) {
+    if (!g_logRing) return;
+
+    g_logDrainRunning = true;
+    g_logDrainThread = std::thread([policy]() {
+        placeCurrentThread("s2d-log", policy, true);
+        prefaultStack();
+
+        LogEntry entry;
+        while (g_logDrainRunning.load(std::memory_order_acquire) || !g_logRing->empty()) {
+            if (!g_logRing->pop(entry)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+            std::cout << "[async " << entry.timestamp_us / 1000 << "ms] "
+                      << entry.message << std::endl;
+        }
+    });
 }
 
-// SIGUSR1 handler for runtime stats
-void stats_signal_handler(int /*sig*/) {
-    if (g_diretta) {
-        g_diretta->dumpStats();
+// Stop the drain thread (flushing what is left) and free the log ring
+static void stop_logging() {
+    if (g_logDrainThread.joinable()) {
+        g_logDrainRunning = false;
+        g_logDrainThread.join();
     }
+    delete g_logRing;
+    g_logRing = nullptr;
 }
 
 // ================================================================
@@ -237,15 +462,46 @@ struct Config {
     std::string dsd_format = ":u32be";   // -D format
     // Diretta options
     int diretta_target = 0;
+    std::vector<int> fanout_targets;     // --fanout: extra targets fed from the same ring
     int thread_mode = 1;
     unsigned int cycle_time = 2620;
     bool cycle_time_auto = true;
+    DirettaTransferMode transfer_mode = DirettaTransferMode::AUTO;
     unsigned int mtu = 0;
+    unsigned int target_latency_ms = 0;  // --target-latency: ring fill to hold (0 = up to high water)
+    bool adaptive_buffer = false;        // --adaptive-buffer: learn the fill per rate family
+    unsigned int adaptive_min_ms = DirettaBuffer::ADAPTIVE_MIN_MS;
+    unsigned int adaptive_max_ms = DirettaBuffer::ADAPTIVE_MAX_MS;
+    bool adaptive_cycle = false;         // --adaptive-cycle: try cycle settings per rate
+    unsigned int adaptive_cycle_min_us = 0;
+    unsigned int adaptive_cycle_max_us = 0;
+
+    // Thread placement (--thread <role>=<spec>)
+    ThreadPlacement threads;
+    bool lock_memory = true;             // mlockall + pre-fault (--no-mlock)
+    bool huge_pages = false;             // Huge-page backed audio buffers (--hugepages)
+    NtStoreMode nt_stores = NtStoreMode::Auto;  // Streaming ring writes (--nt-stores)
+    int convert_threads = 0;             // Parallel conversion threads (--convert-threads)
+#ifdef RT_AUDIT
+    RtAuditMode rt_audit_mode = RtAuditMode::Count;
+#endif
 
     // Other
     bool verbose = false;
     bool quiet = false;
     bool list_targets = false;
+    std::string bench;                   // --bench <name>: run a benchmark and exit
+    bool calibrate = false;              // --calibrate [<families>]: find settings and exit
+    std::vector<std::string> calibrate_families;
+    std::vector<int> calibrate_thread_modes;   // --calibrate-thread-modes (default: --thread-mode)
+    unsigned int calibrate_seconds = 10; // --calibrate-seconds: per rate
+    std::string calibrate_signal;        // Calibration run: test signal instead of squeezelite
+    std::string calibrate_report;        // Calibration run: where to write CalibrationReport
+    std::string state_dir = StateDir::DEFAULT_PATH;  // Calibration results (--state-dir)
+    std::string zones_file;              // --zones <file>: multi-zone mode
+    unsigned int stats_interval = 0;     // --stats-interval <s>: periodic statistics (0 = off)
+    unsigned int pipe_stall_ms = 100;    // --pipe-stall-ms: pipe capacity in input time (0 = kernel default)
+    unsigned int latency_budget_ms = 0;  // --latency-budget: squeezelite output + pipe + ring (0 = off)
     std::string squeezelite_path = "squeezelite";
 };
 
@@ -267,25 +523,86 @@ void print_usage(const char* prog) {
     std::cout << "                          -D           = DoP (DSD over PCM)" << std::endl;
     std::cout << "                          -D :u32be    = Native DSD Big Endian (MSB)" << std::endl;
     std::cout << "                          -D :u32le    = Native DSD Little Endian (LSB)" << std::endl;
+    std::cout << "  --pipe-stall-ms <ms>  Size the squeezelite pipe to ride out a stall this long" << std::endl;
+    std::cout << "                        (default: 100, 0 = kernel default; capped by" << std::endl;
+    std::cout << "                        /proc/sys/fs/pipe-max-size)" << std::endl;
+    std::cout << "  --latency-budget <ms> Audio held between decoder and target, split across" << std::endl;
+    std::cout << "                        squeezelite's output buffer (-b), the pipe and the ring" << std::endl;
+    std::cout << "                        (replaces --pipe-stall-ms; default: 0 = off)" << std::endl;
     std::cout << std::endl;
     std::cout << "Diretta Options:" << std::endl;
     std::cout << "  -t, --target <number> Diretta target number (default: 1 = first)" << std::endl;
     std::cout << "  -l, --list-targets    List Diretta targets and exit" << std::endl;
+    std::cout << "  --fanout <n>[,<n>...] Play the same stream, in step, on more targets" << std::endl;
     std::cout << "  --thread-mode <n>     THRED_MODE bitmask (default: 1)" << std::endl;
     std::cout << "  --cycle-time <us>     Transfer cycle time in microseconds (default: auto)" << std::endl;
+    std::cout << "  --transfer-mode <m>   auto (default), varmax, varauto or fixauto" << std::endl;
     std::cout << "  --mtu <bytes>         MTU override (default: auto-detect)" << std::endl;
+    std::cout << "  --target-latency <ms> Hold the ring buffer at this fill during playback" << std::endl;
+    std::cout << "                        (default: 0 = fill up to 75%)" << std::endl;
+    std::cout << "  --adaptive-buffer [<min>-<max>]" << std::endl;
+    std::cout << "                        Learn the ring fill (and prefill) per target and rate" << std::endl;
+    std::cout << "                        family within these bounds in ms (default: 20-300)" << std::endl;
+    std::cout << "  --adaptive-cycle [<min>-<max>]" << std::endl;
+    std::cout << "                        Try cycle times (bounds in us, default: half to twice" << std::endl;
+    std::cout << "                        the calculated one) and transfer modes per rate" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Thread Placement:" << std::endl;
+    std::cout << "  --thread <role>=<policy>[:<param>][@<cpus>]  (repeatable)" << std::endl;
+    std::cout << "                        role:   worker, ingest, log, sdk, squeezelite, convert" << std::endl;
+    std::cout << "                        policy: other[:nice], fifo:<prio>, rr:<prio>," << std::endl;
+    std::cout << "                                deadline:<runtime_us>/<period_us>" << std::endl;
+    std::cout << "                        cpus:   e.g. 2  or  2,3  or  1-3" << std::endl;
+    std::cout << "                        Example: --thread worker=fifo:60@2 --thread squeezelite=@1" << std::endl;
+    std::cout << "                        (default: worker=fifo:50, others inherit)" << std::endl;
+    std::cout << "  --no-mlock            Do not lock memory (mlockall) or pre-fault buffers" << std::endl;
+    std::cout << "  --hugepages           Back audio buffers with huge pages (hugetlbfs, else THP)" << std::endl;
+    std::cout << "  --nt-stores <mode>    Streaming stores for ring writes: auto (default, when" << std::endl;
+    std::cout << "                        the fill exceeds the last-level cache), on, off" << std::endl;
+    std::cout << "  --convert-threads <n> Convert large chunks on n extra threads (0-" << ConvertPool::MAX_WORKERS
+              << ", default 0)," << std::endl;
+    std::cout << "                        for DSD512/DSD1024 on small multi-core boards" << std::endl;
+#ifdef RT_AUDIT
+    std::cout << "  --rt-audit <mode>     RT audit build: count (default) or abort on heap use" << std::endl;
+    std::cout << "                        in getNewStream()/sendAudio(); report printed at exit" << std::endl;
+#endif
     std::cout << std::endl;
     std::cout << "Other:" << std::endl;
     std::cout << "  -v                    Verbose output (debug level)" << std::endl;
     std::cout << "  -q, --quiet           Quiet mode (warnings and errors only)" << std::endl;
     std::cout << "  -h, --help            Show this help" << std::endl;
     std::cout << "  --squeezelite <path>  Path to squeezelite binary" << std::endl;
+    std::cout << "  --bench <name>        Run a benchmark and exit: ring, ntstore, memcpy, pop," << std::endl;
+    std::cout << "                        convert, all" << std::endl;
+    std::cout << "  --calibrate [<family>,...]" << std::endl;
+    std::cout << "                        Play test signals through the target (no LMS needed)," << std::endl;
+    std::cout << "                        find the lowest stable settings per rate family" << std::endl;
+    std::cout << "                        (pcm48k ... pcm1536k, dsd64 ... dsd1024; default: all" << std::endl;
+    std::cout << "                        up to -r) and write <state-dir>/recommended.conf" << std::endl;
+    std::cout << "  --calibrate-seconds <s>  Play time per rate and run (default: 10)" << std::endl;
+    std::cout << "  --calibrate-thread-modes <n>,...  Thread modes to try (default: --thread-mode)" << std::endl;
+    std::cout << "  --state-dir <path>    Calibration results (default: " << StateDir::DEFAULT_PATH << ")" << std::endl;
+    std::cout << "  --zones <file>        Multi-zone mode: one squeezelite + Diretta target per" << std::endl;
+    std::cout << "                        line (name=, target=, mac=, rates=, worker=); -n/-m/-t" << std::endl;
+    std::cout << "                        are then taken from the file" << std::endl;
+    std::cout << "  --stats-interval <s>  Print statistics every s seconds (as SIGUSR1 does)" << std::endl;
     std::cout << std::endl;
     std::cout << "NOTE: Requires patched squeezelite with in-band format headers." << std::endl;
     std::cout << "      Run setup-squeezelite.sh to build the patched version." << std::endl;
     std::cout << std::endl;
 }
 
+// "<min>-<max>", min > 0
+static bool parse_bounds(const std::string& text, unsigned int& min_value, unsigned int& max_value) {
+    std::istringstream in(text);
+    char dash = 0;
+    unsigned int lo = 0, hi = 0;
+    if (!(in >> lo >> dash >> hi) || dash != '-' || lo == 0 || hi < lo) return false;
+    min_value = lo;
+    max_value = hi;
+    return true;
+}
+
 Config parse_args(int argc, char* argv[]) {
     Config config;
 
@@ -326,6 +643,18 @@ Config parse_args(int argc, char* argv[]) {
             else if (arg == "-a") config.sample_format = std::stoi(value);
             else if (arg == "-t" || arg == "--target") config.diretta_target = std::stoi(value) - 1;
         }
+        else if (arg == "--fanout" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                int target = std::atoi(item.c_str());
+                if (target < 1) {
+                    std::cerr << "Invalid --fanout target: " << item << std::endl;
+                    exit(1);
+                }
+                config.fanout_targets.push_back(target - 1);
+            }
+        }
         else if (arg == "--thread-mode" && i + 1 < argc) {
             config.thread_mode = std::stoi(argv[++i]);
         }
@@ -333,17 +662,198 @@ Config parse_args(int argc, char* argv[]) {
             config.cycle_time = static_cast<unsigned int>(std::stoi(argv[++i]));
             config.cycle_time_auto = false;
         }
+        else if (arg == "--transfer-mode" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            std::transform(mode.begin(), mode.end(), mode.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if (mode == "auto") {
+                config.transfer_mode = DirettaTransferMode::AUTO;
+            } else if (mode == "varmax") {
+                config.transfer_mode = DirettaTransferMode::VAR_MAX;
+            } else if (mode == "varauto") {
+                config.transfer_mode = DirettaTransferMode::VAR_AUTO;
+            } else if (mode == "fixauto") {
+                config.transfer_mode = DirettaTransferMode::FIX_AUTO;
+            } else {
+                std::cerr << "Invalid --transfer-mode: " << mode << " (auto, varmax, varauto or fixauto)" << std::endl;
+                exit(1);
+            }
+        }
         else if (arg == "--mtu" && i + 1 < argc) {
             config.mtu = static_cast<unsigned int>(std::stoi(argv[++i]));
         }
+        else if (arg == "--target-latency" && i + 1 < argc) {
+            config.target_latency_ms = static_cast<unsigned int>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--adaptive-buffer") {
+            config.adaptive_buffer = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                std::string bounds = argv[++i];
+                if (!parse_bounds(bounds, config.adaptive_min_ms, config.adaptive_max_ms)) {
+                    std::cerr << "Invalid --adaptive-buffer bounds: " << bounds << " (e.g. 20-300)" << std::endl;
+                    exit(1);
+                }
+            }
+        }
+        else if (arg == "--adaptive-cycle") {
+            config.adaptive_cycle = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                std::string bounds = argv[++i];
+                if (!parse_bounds(bounds, config.adaptive_cycle_min_us, config.adaptive_cycle_max_us)) {
+                    std::cerr << "Invalid --adaptive-cycle bounds: " << bounds << " (e.g. 500-5000)" << std::endl;
+                    exit(1);
+                }
+            }
+        }
         else if (arg == "--squeezelite" && i + 1 < argc) {
             config.squeezelite_path = argv[++i];
         }
+        else if (arg == "--no-mlock") {
+            config.lock_memory = false;
+        }
+        else if (arg == "--hugepages") {
+            config.huge_pages = true;
+        }
+        else if (arg == "--nt-stores" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "auto") {
+                config.nt_stores = NtStoreMode::Auto;
+            } else if (mode == "on") {
+                config.nt_stores = NtStoreMode::On;
+            } else if (mode == "off") {
+                config.nt_stores = NtStoreMode::Off;
+            } else {
+                std::cerr << "Invalid --nt-stores mode: " << mode << " (auto, on or off)" << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--convert-threads" && i + 1 < argc) {
+            config.convert_threads = std::stoi(argv[++i]);
+            if (config.convert_threads < 0 || config.convert_threads > ConvertPool::MAX_WORKERS) {
+                std::cerr << "Invalid --convert-threads: " << config.convert_threads
+                          << " (0-" << ConvertPool::MAX_WORKERS << ")" << std::endl;
+                exit(1);
+            }
+        }
+        else if (arg == "--bench" && i + 1 < argc) {
+            config.bench = argv[++i];
+        }
+        else if (arg == "--calibrate") {
+            config.calibrate = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                std::stringstream list(argv[++i]);
+                std::string item;
+                while (std::getline(list, item, ',')) {
+                    config.calibrate_families.push_back(item);
+                }
+            }
+        }
+        else if (arg == "--calibrate-seconds" && i + 1 < argc) {
+            config.calibrate_seconds = static_cast<unsigned int>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--calibrate-thread-modes" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                config.calibrate_thread_modes.push_back(std::atoi(item.c_str()));
+            }
+        }
+        else if (arg == "--calibrate-signal" && i + 1 < argc) {
+            config.calibrate_signal = argv[++i];
+        }
+        else if (arg == "--calibrate-report" && i + 1 < argc) {
+            config.calibrate_report = argv[++i];
+        }
+        else if (arg == "--state-dir" && i + 1 < argc) {
+            config.state_dir = argv[++i];
+        }
+        else if (arg == "--zones" && i + 1 < argc) {
+            config.zones_file = argv[++i];
+        }
+        else if (arg == "--stats-interval" && i + 1 < argc) {
+            config.stats_interval = static_cast<unsigned int>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--pipe-stall-ms" && i + 1 < argc) {
+            config.pipe_stall_ms = static_cast<unsigned int>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--latency-budget" && i + 1 < argc) {
+            config.latency_budget_ms = static_cast<unsigned int>(std::stoi(argv[++i]));
+        }
+#ifdef RT_AUDIT
+        else if (arg == "--rt-audit" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "count") {
+                config.rt_audit_mode = RtAuditMode::Count;
+            } else if (mode == "abort") {
+                config.rt_audit_mode = RtAuditMode::Abort;
+            } else {
+                std::cerr << "Invalid --rt-audit mode: " << mode << " (count or abort)" << std::endl;
+                exit(1);
+            }
+        }
+#endif
+        else if (arg == "--thread" && i + 1 < argc) {
+            std::string error;
+            if (!parseThreadAssignment(argv[++i], config.threads, error)) {
+                std::cerr << "Invalid --thread " << argv[i] << ": " << error << std::endl;
+                exit(1);
+            }
+        }
     }
 
     return config;
 }
 
+// The command line for calibration runs: what --calibrate sweeps (and the
+// calibration and adaptive options) left out, the runs add their own
+std::vector<std::string> calibration_base_args(int argc, char* argv[]) {
+    static const char* const WITH_VALUE[] = {
+        "--thread-mode", "--cycle-time", "--transfer-mode", "--target-latency", "--latency-budget", "--stats-interval",
+        "--calibrate-seconds", "--calibrate-thread-modes", "--calibrate-signal", "--calibrate-report",
+        "--zones", "--bench"
+    };
+    std::vector<std::string> args{"/proc/self/exe"};
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool skip_value = false;
+        for (const char* option : WITH_VALUE) {
+            if (arg == option) skip_value = true;
+        }
+        if (skip_value) {
+            i++;
+        } else if (arg == "--calibrate") {
+            if (i + 1 < argc && argv[i + 1][0] != '-') i++;
+        } else if (arg == "--adaptive-buffer" || arg == "--adaptive-cycle") {
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) i++;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    return args;
+}
+
+// --latency-budget (shares in LatencyBudget.h, see split_latency_budget())
+static constexpr unsigned int SQUEEZELITE_STREAM_BUF_KB = 2048;   // Squeezelite's default
+static constexpr size_t MIN_WRITE_BYTES = 16384;                  // Squeezelite's FRAME_BLOCK at S32 stereo
+
+// Squeezelite's -b output buffer in KB: its share at the -r maximum (the
+// same default as build_squeezelite_args()), never below the floor
+static unsigned int budget_output_kb(const std::string& rates, unsigned int budget_ms) {
+    double max_rate = 768000.0;
+    if (!rates.empty()) {
+        unsigned long rate = std::strtoul(rates.c_str(), nullptr, 10);
+        if (rate >= 44100 && rate <= MAX_SQUEEZELITE_RATE) max_rate = static_cast<double>(rate);
+    }
+    return LatencyBudget::outputKb(max_rate, budget_ms);
+}
+
+// Write size that fits twice in the pipe's share at 44.1 kHz
+static size_t budget_write_bytes(unsigned int budget_ms) {
+    double share = 44100.0 * SQZ_BYTES_PER_SAMPLE * 2 * budget_ms * LatencyBudget::PIPE_SHARE / 1000.0;
+    size_t bytes = static_cast<size_t>(share / 2) / 4096 * 4096;
+    return std::min(std::max(bytes, MIN_WRITE_BYTES), PipeReader::BUFFER_BYTES);
+}
+
 std::vector<std::string> build_squeezelite_args(const Config& config, const std::string& output_path) {
     std::vector<std::string> args;
 
@@ -390,6 +900,14 @@ std::vector<std::string> build_squeezelite_args(const Config& config, const std:
         args.push_back(config.codecs);
     }
 
+    // Output buffer: its share of --latency-budget (the stream buffer of
+    // compressed input keeps squeezelite's default)
+    if (config.latency_budget_ms > 0) {
+        args.push_back("-b");
+        args.push_back(std::to_string(SQUEEZELITE_STREAM_BUF_KB) + ":" +
+                       std::to_string(budget_output_kb(config.rates, config.latency_budget_ms)));
+    }
+
     // DSD output format
     args.push_back("-D");
     if (config.dsd_format != "dop") {
@@ -404,6 +922,22 @@ std::vector<std::string> build_squeezelite_args(const Config& config, const std:
     return args;
 }
 
+// Run a per-frame conversion on the --convert-threads pool (in slices of
+// whole frames, each writing its own part of dst), or inline without one.
+// fn returns the OR of the input words it read; 0 overall means silence
+template <typename Fn>
+static uint32_t convert_frames(Fn& fn, size_t num_frames, size_t bytes_per_frame) {
+    if (!g_convert.active()) {
+        return fn(0, num_frames);
+    }
+    std::atomic<uint32_t> content{0};
+    auto slice = [&](size_t first, size_t end) {
+        content.fetch_or(fn(first, end), std::memory_order_relaxed);
+    };
+    g_convert.run(slice, num_frames, bytes_per_frame);
+    return content.load(std::memory_order_relaxed);
+}
+
 // ================================================================
 // DSD de-interleave: interleaved S32_LE → planar with byte-swap
 //
@@ -412,16 +946,21 @@ std::vector<std::string> build_squeezelite_args(const Config& config, const std:
 // On the pipe: byte[0]=last DSD byte, byte[3]=first DSD byte.
 // We byte-swap to restore correct temporal order.
 // ================================================================
-static void deinterleave_dsd_native(const uint8_t* src, uint8_t* dst,
-                                     size_t num_frames, size_t bytes_per_frame,
-                                     size_t channels) {
+static uint32_t deinterleave_dsd_native_frames(const uint8_t* src, uint8_t* dst,
+                                                size_t num_frames, size_t bytes_per_frame,
+                                                size_t first_frame, size_t end_frame) {
     size_t bytes_per_channel = num_frames * 4;
+    uint32_t content = 0;
 
-    for (size_t frame = 0; frame < num_frames; frame++) {
+    for (size_t frame = first_frame; frame < end_frame; frame++) {
         size_t src_offset = frame * bytes_per_frame;
         size_t dst_offset_L = frame * 4;
         size_t dst_offset_R = bytes_per_channel + frame * 4;
 
+        uint32_t words[2];
+        memcpy(words, src + src_offset, 8);
+        content |= words[0] | words[1];
+
         // L channel: byte-swap from LE pipe order to correct temporal order
         dst[dst_offset_L + 0] = src[src_offset + 3];
         dst[dst_offset_L + 1] = src[src_offset + 2];
@@ -434,6 +973,18 @@ static void deinterleave_dsd_native(const uint8_t* src, uint8_t* dst,
         dst[dst_offset_R + 2] = src[src_offset + 5];
         dst[dst_offset_R + 3] = src[src_offset + 4];
     }
+    return content;
+}
+
+// Returns the OR of the input words (0 = silence)
+static uint32_t deinterleave_dsd_native(const uint8_t* src, uint8_t* dst,
+                                         size_t num_frames, size_t bytes_per_frame,
+                                         size_t channels) {
+    (void)channels;    // Stereo layout
+    auto slice = [&](size_t first, size_t end) {
+        return deinterleave_dsd_native_frames(src, dst, num_frames, bytes_per_frame, first, end);
+    };
+    return convert_frames(slice, num_frames, bytes_per_frame);
 }
 
 // ================================================================
@@ -443,18 +994,23 @@ static void deinterleave_dsd_native(const uint8_t* src, uint8_t* dst,
 // Each 32-bit sample contains 16 bits of DSD data.
 // Output: planar native DSD [L L L...][R R R...]
 // ================================================================
-static void convert_dop_to_native_dsd(const uint8_t* src, uint8_t* dst,
-                                       size_t num_frames, size_t bytes_per_frame,
-                                       size_t channels) {
+static uint32_t convert_dop_to_native_dsd_frames(const uint8_t* src, uint8_t* dst,
+                                                  size_t num_frames, size_t bytes_per_frame,
+                                                  size_t channels, size_t first_frame, size_t end_frame) {
     size_t dsd_bytes_per_frame = 2 * channels;
     size_t output_size = num_frames * dsd_bytes_per_frame;
     size_t bytes_per_channel = output_size / channels;
+    uint32_t content = 0;
 
-    for (size_t frame = 0; frame < num_frames; frame++) {
+    for (size_t frame = first_frame; frame < end_frame; frame++) {
         size_t src_offset = frame * bytes_per_frame;
         size_t dst_offset_L = frame * 2;
         size_t dst_offset_R = bytes_per_channel + frame * 2;
 
+        uint32_t words[2];    // Markers included, like isSilence()
+        memcpy(words, src + src_offset, 8);
+        content |= words[0] | words[1];
+
         // Extract DSD from L channel (bytes 1-2, MSB first for DFF)
         dst[dst_offset_L + 0] = src[src_offset + 2];  // DSD MSB
         dst[dst_offset_L + 1] = src[src_offset + 1];  // DSD LSB
@@ -463,193 +1019,1537 @@ static void convert_dop_to_native_dsd(const uint8_t* src, uint8_t* dst,
         dst[dst_offset_R + 0] = src[src_offset + 6];  // DSD MSB
         dst[dst_offset_R + 1] = src[src_offset + 5];  // DSD LSB
     }
+    return content;
 }
 
-// ================================================================
-// Main
-// ================================================================
-int main(int argc, char* argv[]) {
-
-    std::cout << "================================================================" << std::endl;
-    std::cout << "  squeeze2diretta v" << WRAPPER_VERSION << std::endl;
-    std::cout << "  Squeezelite to Diretta Bridge" << std::endl;
-    std::cout << "  Using DirettaSync from DirettaRendererUPnP v2.0" << std::endl;
-    std::cout << "  In-band format signaling (no stderr parsing)" << std::endl;
-    std::cout << "================================================================" << std::endl;
-    std::cout << std::endl;
-
-    // Parse arguments
-    Config config = parse_args(argc, argv);
+// Returns the OR of the input words (0 = silence)
+static uint32_t convert_dop_to_native_dsd(const uint8_t* src, uint8_t* dst,
+                                           size_t num_frames, size_t bytes_per_frame,
+                                           size_t channels) {
+    auto slice = [&](size_t first, size_t end) {
+        return convert_dop_to_native_dsd_frames(src, dst, num_frames, bytes_per_frame, channels, first, end);
+    };
+    return convert_frames(slice, num_frames, bytes_per_frame);
+}
 
-    // Validate PCM output bit depth
-    const int output_bit_depth = config.sample_format;
-    if (output_bit_depth != 16 && output_bit_depth != 24 && output_bit_depth != 32) {
-        LOG_ERROR("Invalid sample format: " << output_bit_depth << " (must be 16, 24, or 32)");
-        return 1;
+// Build the Diretta format for a header: DSD at its actual bit rate (as DFF,
+// MSB first: the byte-swap happens in de-interleave), PCM at the -a depth
+static AudioFormat format_from_header(const SqFormatHeader& hdr, int output_bit_depth) {
+    DSDFormatType dsd_type = static_cast<DSDFormatType>(hdr.dsd_format);
+
+    AudioFormat format;
+    format.sampleRate = hdr.sample_rate;
+    format.bitDepth = static_cast<unsigned int>(output_bit_depth);
+    format.channels = hdr.channels;
+    format.isDSD = (dsd_type != DSDFormatType::NONE);
+    format.isCompressed = false;
+
+    if (dsd_type == DSDFormatType::U32_BE || dsd_type == DSDFormatType::U32_LE) {
+        // Native DSD: frame rate × 32 = DSD bit rate
+        format.sampleRate = hdr.sample_rate * 32;
+        format.bitDepth = 1;
+    } else if (dsd_type == DSDFormatType::DOP) {
+        // DoP: carrier rate × 16 = DSD bit rate
+        format.sampleRate = hdr.sample_rate * 16;
+        format.bitDepth = 1;
     }
-
-    g_verbose = config.verbose;
-    if (config.verbose) {
-        g_logLevel = LogLevel::DEBUG;
-    } else if (config.quiet) {
-        g_logLevel = LogLevel::WARN;
+    if (format.isDSD) {
+        format.dsdFormat = AudioFormat::DSDFormat::DFF;
     }
+    return format;
+}
 
-    if (g_verbose) {
-        g_logRing = new LogRing();
+// Bytes of squeezelite output per read and sendAudio(), whole frames. DSD
+// uses ~12 ms chunks (calculateDsdSamplesPerCall) so that DSD512/DSD1024, at
+// 5.6-12 MB/s, are not handled in 1-3 ms slices; one pipe reader buffer at most.
+// With conversion threads PCM gets ~12 ms chunks too, to split them usefully.
+static size_t chunk_bytes_for(const SqFormatHeader& hdr, const AudioFormat& format) {
+    size_t bytes_per_frame = SQZ_BYTES_PER_SAMPLE * hdr.channels;
+    size_t chunk = PIPE_BUF_SIZE;
+    if (!format.isDSD && g_convert.active()) {
+        chunk = std::max(chunk, static_cast<size_t>(hdr.sample_rate) * bytes_per_frame * 12 / 1000);
     }
-
-    // List targets if requested
-    if (config.list_targets) {
-        DirettaSync::listTargets();
-        if (g_logRing) delete g_logRing;
-        return 0;
+    if (format.isDSD) {
+        // DSD bits per channel and frame: 16 in DoP, 32 in u32 containers
+        size_t bits_per_frame = static_cast<DSDFormatType>(hdr.dsd_format) == DSDFormatType::DOP ? 16 : 32;
+        size_t samples = DirettaBuffer::calculateDsdSamplesPerCall(format.sampleRate);
+        chunk = std::max(chunk, samples / bits_per_frame * bytes_per_frame);
     }
+    chunk = std::min(chunk, PipeReader::BUFFER_BYTES);
+    return chunk / bytes_per_frame * bytes_per_frame;
+}
 
-    // Setup signal handlers
-    signal(SIGINT, signal_handler);
-    signal(SIGTERM, signal_handler);
-    signal(SIGUSR1, stats_signal_handler);
-
-    // Create DirettaSync instance
-    g_diretta = std::make_unique<DirettaSync>();
-
-    DirettaConfig direttaConfig;
-    direttaConfig.threadMode = config.thread_mode;
-    direttaConfig.cycleTime = config.cycle_time;
-    direttaConfig.cycleTimeAuto = config.cycle_time_auto;
-    direttaConfig.mtu = config.mtu;
+// Size the squeezelite pipe for the new format (see PipeGauge)
+static void resize_pipe(PipeReader& reader, const SqFormatHeader& hdr, unsigned int stall_ms) {
+    double bytes_per_second = static_cast<double>(hdr.sample_rate) * SQZ_BYTES_PER_SAMPLE * hdr.channels;
+    reader.gauge().resize(bytes_per_second, stall_ms, 2 * g_pipe_write_bytes);
+}
 
-    if (config.diretta_target >= 0) {
-        g_diretta->setTargetIndex(config.diretta_target);
-    }
-    if (config.mtu > 0) {
-        g_diretta->setMTU(config.mtu);
+// ================================================================
+// Latency budget (--latency-budget)
+// ================================================================
+// Shares as in LatencyBudget.h; the pipe gets at least two squeezelite
+// writes. What cannot fit is logged as a warning.
+
+// Pipe and ring shares for a new format, before open()
+static void split_latency_budget(PipeReader& reader, DirettaSync& diretta, const SqFormatHeader& hdr,
+                                 const AudioFormat& format, unsigned int budget_ms, unsigned int output_kb) {
+    double bytes_per_second = static_cast<double>(hdr.sample_rate) * SQZ_BYTES_PER_SAMPLE * hdr.channels;
+    double ring_need = std::max<double>(DirettaBuffer::ADAPTIVE_MIN_MS,
+                                        diretta.learnedLatencyMs(format.isDSD, format.sampleRate));
+    LatencyBudget::Split split = LatencyBudget::plan(budget_ms, output_kb, hdr.sample_rate, ring_need);
+    double output_ms = split.outputMs;
+    reader.gauge().resize(bytes_per_second, static_cast<unsigned int>(std::max(1.0, split.pipeMs)),
+                          2 * g_pipe_write_bytes);
+
+    double pipe_actual = reader.gauge().capacity() * 1000.0 / bytes_per_second;
+    double ring_ms = LatencyBudget::ringMs(split, pipe_actual);
+    diretta.setLatencyBudget(static_cast<unsigned int>(std::lround(ring_ms)));
+    double total_ms = output_ms + pipe_actual + ring_ms;
+    LOG_INFO("[Budget] " << budget_ms << " ms at " << hdr.sample_rate << "Hz: squeezelite output "
+             << std::fixed << std::setprecision(0) << output_ms << " ms (" << output_kb << " KB), pipe "
+             << pipe_actual << " ms, ring " << ring_ms << " ms");
+    if (total_ms > budget_ms + 0.5) {
+        LOG_WARN("[Budget] " << budget_ms << " ms cannot be met at " << hdr.sample_rate << "Hz: "
+                 << std::fixed << std::setprecision(0) << total_ms << " ms held (squeezelite's output buffer "
+                 << output_ms << " ms, at least " << LatencyBudget::OUTPUT_MIN_KB << " KB; pipe floor "
+                 << 2 * g_pipe_write_bytes / 1024 << " KB; ring needs " << ring_need << " ms)");
     }
+}
 
-    LOG_INFO("Initializing Diretta...");
-
-    if (!g_diretta->enable(direttaConfig)) {
-        LOG_ERROR("Failed to enable Diretta. Check that a Diretta target is available.");
-        LOG_ERROR("Use -l to list available targets.");
-        if (g_logRing) delete g_logRing;
-        return 1;
+// Ingest thread load over one stats period. While the ring throttles the
+// producer the input rate is the stream's real-time rate and busy% is what
+// it costs: 100 / busy% is the real-time headroom.
+static void print_ingest_stats(double wall_s, double waited_s, uint64_t input_bytes) {
+    if (wall_s <= 0.0) return;
+    double busy = std::min(1.0, std::max(0.0, (wall_s - waited_s) / wall_s));
+    std::cout << "[Ingest] " << std::fixed << std::setprecision(2)
+              << input_bytes / wall_s / 1e6 << " MB/s in, busy "
+              << std::setprecision(1) << busy * 100.0 << "%";
+    if (busy > 0.0) {
+        std::cout << " (" << 1.0 / busy << "x real-time headroom)";
     }
+    std::cout << " over " << wall_s << "s" << std::endl;
+    if (g_convert.active()) {
+        std::cout << "[Convert] " << g_convert.workers() << " extra thread(s): "
+                  << g_convert.parallelRuns() << " chunks split, "
+                  << g_convert.inlineRuns() << " too small to split" << std::endl;
+    }
+}
 
-    LOG_INFO("Diretta enabled successfully");
+// ================================================================
+// Squeezelite child process
+// ================================================================
+// What the child reports on the exec sync pipe before exec (or instead of it)
+struct ChildFailure {
+    enum Step : int { Placement, Redirect, Exec } step;
+    int error;                           // errno
+};
 
-    // Create pipe for squeezelite stdout (audio + headers)
+// Fork and exec squeezelite with stdout on a new pipe (read end returned in
+// read_fd). Returns the child PID, or -1. Returns once the child has exec'd,
+// i.e. after its thread placement has been applied.
+//
+// Between fork() and exec() the child of this multi-threaded process may
+// only make async-signal-safe calls (another thread may have held the malloc
+// or log lock at fork time): everything is prepared here, the child uses
+// raw syscalls and reports failures to the parent through the sync pipe.
+static pid_t spawn_squeezelite(const std::vector<std::string>& args,
+                               const ThreadPolicy& policy, int& read_fd) {
     int pipefd[2];
     if (pipe(pipefd) == -1) {
         LOG_ERROR("Failed to create pipe: " << strerror(errno));
-        g_diretta->disable();
-        if (g_logRing) delete g_logRing;
-        return 1;
+        return -1;
     }
+    // Room for two of squeezelite's coalesced writes, so it can finish one
+    // while we drain the other (squeezelite asks for the same size itself)
+    fcntl(pipefd[1], F_SETPIPE_SZ, static_cast<int>(2 * g_pipe_write_bytes));
+
+    // Without RESET_ON_FORK: squeezelite's threads inherit the policy
+    PreparedThreadPolicy prepared = prepareThreadPolicy(policy, false);
+    sigset_t signals = control_signals();
+
+    // argv for execvp, built before fork(): the child of a multi-threaded
+    // process should not allocate before exec
+    std::vector<char*> c_args;
+    for (auto& arg : args) {
+        c_args.push_back(const_cast<char*>(arg.c_str()));
+    }
+    c_args.push_back(nullptr);
 
-    // Build squeezelite command
-    std::vector<std::string> squeezelite_args = build_squeezelite_args(config, "-");
-    if (g_logLevel >= LogLevel::DEBUG) {
-        std::cout << "Squeezelite command: ";
-        for (const auto& arg : squeezelite_args) {
-            std::cout << arg << " ";
-        }
-        std::cout << std::endl;
+    // Close-on-exec pipe: reaches EOF once the child has exec'd
+    int exec_sync[2] = {-1, -1};
+    if (pipe2(exec_sync, O_CLOEXEC) == -1) {
+        exec_sync[0] = exec_sync[1] = -1;
     }
 
-    // Fork and exec squeezelite
-    squeezelite_pid = fork();
+    pid_t pid = fork();
 
-    if (squeezelite_pid == -1) {
+    if (pid == -1) {
         LOG_ERROR("Failed to fork");
         close(pipefd[0]);
         close(pipefd[1]);
-        g_diretta->disable();
-        if (g_logRing) delete g_logRing;
-        return 1;
+        if (exec_sync[0] != -1) {
+            close(exec_sync[0]);
+            close(exec_sync[1]);
+        }
+        return -1;
     }
 
-    if (squeezelite_pid == 0) {
+    if (pid == 0) {
         // Child process: redirect stdout to pipe, let stderr pass through
         close(pipefd[0]);  // Close read end
+        if (exec_sync[0] != -1) close(exec_sync[0]);
+        auto report = [&](ChildFailure::Step step, int error) {
+            ChildFailure failure{step, error};
+            if (exec_sync[1] != -1) {
+                ssize_t ignored = write(exec_sync[1], &failure, sizeof(failure));
+                (void)ignored;
+            }
+        };
+
+        // Placement is applied before exec; squeezelite's threads inherit it
+        if (!policy.isInherit()) {
+            int error = applyPreparedPolicy(prepared);
+            if (error != 0) report(ChildFailure::Placement, error);
+        }
 
         if (dup2(pipefd[1], STDOUT_FILENO) == -1) {
-            LOG_ERROR("Failed to redirect stdout: " << strerror(errno));
-            exit(1);
+            report(ChildFailure::Redirect, errno);
+            _exit(1);
         }
         close(pipefd[1]);
 
         // v2.0: stderr is NOT redirected — squeezelite logs pass through
         // to the parent process stderr for debugging (visible with -v)
 
-        // Convert args to C-style array
-        std::vector<char*> c_args;
-        for (auto& arg : squeezelite_args) {
-            c_args.push_back(const_cast<char*>(arg.c_str()));
-        }
-        c_args.push_back(nullptr);
+        // The signal mask survives exec: hand squeezelite its signals back
+        sigprocmask(SIG_UNBLOCK, &signals, nullptr);
 
         execvp(c_args[0], c_args.data());
 
-        LOG_ERROR("Failed to execute squeezelite: " << strerror(errno));
-        exit(1);
+        report(ChildFailure::Exec, errno);
+        _exit(1);
     }
 
     // Parent process
     close(pipefd[1]);  // Close write end
-    int fifo_fd = pipefd[0];
+    read_fd = pipefd[0];
+
+    if (exec_sync[0] != -1) {
+        close(exec_sync[1]);
+        ChildFailure failure;
+        ssize_t n;
+        while ((n = read(exec_sync[0], &failure, sizeof(failure))) != 0) {
+            if (n == -1 && errno == EINTR) continue;
+            if (n != static_cast<ssize_t>(sizeof(failure))) break;
+            switch (failure.step) {
+                case ChildFailure::Placement:
+                    LOG_WARN("[Threads] squeezelite: could not apply " << describeThreadPolicy(policy)
+                             << " — " << strerror(failure.error) << " (needs root or CAP_SYS_NICE)");
+                    break;
+                case ChildFailure::Redirect:
+                    LOG_ERROR("Failed to redirect squeezelite's stdout: " << strerror(failure.error));
+                    break;
+                case ChildFailure::Exec:
+                    LOG_ERROR("Failed to execute squeezelite: " << strerror(failure.error));
+                    break;
+            }
+        }
+        close(exec_sync[0]);
+        LOG_INFO("[Threads] squeezelite (pid " << pid << "): "
+                 << describeThreadPlacement(pid));
+    }
+    return pid;
+}
 
-    LOG_INFO("Squeezelite started (PID: " << squeezelite_pid << ")");
-    LOG_INFO("Waiting for first track header...");
-    LOG_INFO("");
+// ================================================================
+// Multi-zone mode (--zones <file>)
+// ================================================================
+// One process drives N zones, each a squeezelite child and a DirettaSync
+// instance with its own ring and worker thread. What does not need to be
+// per zone is shared: one ingest thread multiplexes the zone pipes with
+// epoll, one control thread runs the blocking SDK open()/release() calls
+// (seconds, on a format change) so a zone switching format never stalls the
+// others, and the log ring, I/O buffers and memcpy calibration are common.
+// ================================================================
 
-    // ================================================================
-    // Main loop: synchronous header-based format detection
-    // ================================================================
-    // The patched squeezelite writes a 16-byte "SQFH" header to stdout
-    // only when the format changes (or for the first track). Same-format
-    // gapless transitions emit no header — audio flows uninterrupted.
-    // No stderr parsing or race conditions.
-    // ================================================================
+// Squeezelite takes its MAC from the host's interface when -m is absent, and
+// LMS merges players with the same MAC: give each zone a stable, locally
+// administered one derived from its name
+static std::string zone_mac(const std::string& name) {
+    uint32_t hash = 2166136261u;    // FNV-1a
+    for (unsigned char c : name) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    char mac[18];
+    snprintf(mac, sizeof(mac), "02:53:44:%02x:%02x:%02x",
+             (hash >> 16) & 0xff, (hash >> 8) & 0xff, hash & 0xff);
+    return mac;
+}
 
-    PipeReader reader(fifo_fd);
+struct Zone {
+    ZoneSpec spec;
+    uint32_t index = 0;                  // In the supervisor's list (epoll tags)
+    std::unique_ptr<DirettaSync> diretta;
 
-    // Squeezelite always outputs S32_LE (4 bytes per sample)
-    const size_t SQZ_BYTES_PER_SAMPLE = 4;
-    const size_t PIPE_BUF_SIZE = 16384;
-    const float RING_HIGH_WATER = 0.75f;  // Wait when ring buffer > 75% full
-    constexpr int IDLE_RELEASE_TIMEOUT_S = 5;  // Release target after 5s idle
+    // squeezelite child and its pipe (fd -1 while the child is down)
+    pid_t pid = -1;
+    int fd = -1;
+    std::unique_ptr<PipeReader> reader;
+    bool armed = false;                  // fd in the epoll set
+    bool throttled = false;              // Ring above high water: waiting for the space event
 
-    // Current format state
-    AudioFormat current_format;
-    DSDFormatType current_dsd_type = DSDFormatType::NONE;
-    unsigned int current_rate = 0;
-    uint8_t current_depth = 0;
+    // Stream state (same meaning as in the single-zone loop)
+    SqFormatHeader hdr{};
+    AudioFormat format;
+    size_t chunk_bytes = PIPE_BUF_SIZE;  // chunk_bytes_for() the current format
+    bool have_format = false;
     bool diretta_open = false;
 
-    // Streaming state
+    // Pending control-thread job (at most one per zone); the ingest thread
+    // leaves the zone alone until done is set
+    enum class Job { None, Open, Release };
+    Job job = Job::None;
+    AudioFormat job_format;
+    bool job_ok = false;
+    std::atomic<bool> job_done{false};
+
+    std::chrono::steady_clock::time_point last_data;
+    std::chrono::steady_clock::time_point last_audio;
+    std::chrono::steady_clock::time_point respawn_at;
     uint64_t total_bytes = 0;
-    uint64_t total_frames = 0;
+    unsigned int restarts = 0;
+};
+
+// Runs the blocking DirettaSync calls of all zones, one at a time, and
+// signals completion through an eventfd watched by the ingest loop
+class ZoneControl {
+public:
+    ZoneControl(size_t zones, int notify_fd) : m_notifyFd(notify_fd) {
+        m_queue.reserve(zones);    // One job per zone at most: never reallocates
+    }
+
+    // Returns once the thread has registered (see placeCurrentThread())
+    void start() {
+        std::promise<void> registered;
+        std::future<void> registeredFuture = registered.get_future();
+        m_thread = std::thread([this, registered = std::move(registered)]() mutable {
+            placeCurrentThread("s2d-zonectl", ThreadPolicy(), true);
+            registered.set_value();
+            run();
+        });
+        registeredFuture.wait();
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_one();
+        if (m_thread.joinable()) m_thread.join();
+    }
 
-    std::vector<uint8_t> audio_buf(PIPE_BUF_SIZE);
-    std::vector<uint8_t> planar_buf(PIPE_BUF_SIZE);
+    void submit(Zone* zone) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(zone);
+        }
+        m_cv.notify_one();
+    }
+
+private:
+    void run() {
+        while (true) {
+            Zone* zone;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+                if (m_stop) return;
+                zone = m_queue.front();
+                m_queue.erase(m_queue.begin());
+            }
+
+            if (zone->job == Zone::Job::Open) {
+                zone->job_ok = zone->diretta->open(zone->job_format);
+                // Squeezelite always outputs MSB-aligned S32_LE
+                if (zone->job_ok && !zone->job_format.isDSD) {
+                    zone->diretta->setS24PackModeHint(DirettaRingBuffer::S24PackMode::MsbAligned);
+                }
+            } else {
+                zone->diretta->release();
+                zone->job_ok = true;
+            }
+            zone->job_done.store(true, std::memory_order_release);
+
+            uint64_t one = 1;
+            ssize_t ignored = write(m_notifyFd, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+
+    int m_notifyFd;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Zone*> m_queue;
+    bool m_stop = false;
+};
+
+class ZoneSupervisor {
+public:
+    static constexpr int IDLE_RELEASE_TIMEOUT_S = 5;
+    static constexpr int RESPAWN_DELAY_S = 3;
+    static constexpr int CHUNKS_PER_WAKE = 4;        // Fairness between zones
+    static constexpr int TICK_MS = 1000;             // Idle release, respawn
+
+    ZoneSupervisor(const Config& config, const std::vector<ZoneSpec>& specs, int output_bit_depth)
+        : m_config(config), m_outputBitDepth(output_bit_depth) {
+        for (const auto& spec : specs) {
+            m_zones.emplace_back(new Zone());
+            m_zones.back()->index = static_cast<uint32_t>(m_zones.size() - 1);
+            m_zones.back()->spec = spec;
+            if (m_zones.back()->spec.mac.empty()) {
+                m_zones.back()->spec.mac = zone_mac(spec.name);
+            }
+        }
+    }
+
+    ~ZoneSupervisor() {
+        for (int fd : {m_epollFd, m_eventFd, m_signalFd, m_tickFd, m_statsFd}) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    bool enable() {
+        for (auto& zone : m_zones) {
+            const ZoneSpec& spec = zone->spec;
+
+            DirettaConfig direttaConfig;
+            direttaConfig.threadMode = m_config.thread_mode;
+            direttaConfig.cycleTime = m_config.cycle_time;
+            direttaConfig.cycleTimeAuto = m_config.cycle_time_auto;
+            direttaConfig.transferMode = m_config.transfer_mode;
+            direttaConfig.mtu = m_config.mtu;
+            direttaConfig.hugePages = m_config.huge_pages;
+            direttaConfig.ntStores = m_config.nt_stores;
+            direttaConfig.targetLatencyMs = m_config.target_latency_ms;
+            direttaConfig.adaptiveBuffer = m_config.adaptive_buffer;
+            direttaConfig.latencyBudgetMs = m_config.latency_budget_ms;
+            direttaConfig.adaptiveMinMs = m_config.adaptive_min_ms;
+            direttaConfig.adaptiveMaxMs = m_config.adaptive_max_ms;
+            direttaConfig.stateDir = m_config.state_dir;
+            direttaConfig.adaptiveCycle = m_config.adaptive_cycle;
+            direttaConfig.adaptiveCycleMinUs = m_config.adaptive_cycle_min_us;
+            direttaConfig.adaptiveCycleMaxUs = m_config.adaptive_cycle_max_us;
+            direttaConfig.convertPool = &g_convert;
+            direttaConfig.workerPolicy = spec.worker;
+            direttaConfig.sdkPolicy = m_config.threads[ThreadRole::Sdk];
+            // Ring sized for this zone's -r maximum, not the global one
+            direttaConfig.maxSampleRate = 768000;
+            if (!spec.rates.empty()) {
+                unsigned long maxRate = std::strtoul(spec.rates.c_str(), nullptr, 10);
+                if (maxRate >= 44100 && maxRate <= MAX_SQUEEZELITE_RATE) {
+                    direttaConfig.maxSampleRate = static_cast<uint32_t>(maxRate);
+                }
+            }
+
+            zone->diretta = std::make_unique<DirettaSync>();
+            zone->diretta->setTargetIndex(spec.target);
+            if (m_config.mtu > 0) {
+                zone->diretta->setMTU(m_config.mtu);
+            }
+
+            LOG_INFO("[Zone " << spec.name << "] Initializing Diretta target "
+                     << (spec.target + 1) << " (worker "
+                     << describeThreadPolicy(spec.worker) << ")...");
+            if (!zone->diretta->enable(direttaConfig)) {
+                LOG_ERROR("[Zone " << spec.name << "] Failed to enable Diretta target "
+                          << (spec.target + 1) << ". Use -l to list available targets.");
+                return false;
+            }
+        }
+
+        // Pipe and conversion buffers are shared: the ingest thread handles
+        // one zone at a time
+        if (!m_ioArena.allocate(2 * PipeReader::BUFFER_BYTES + 2 * AudioArena::DEFAULT_ALIGNMENT)) {
+            LOG_ERROR("Failed to map I/O buffers: " << strerror(errno));
+            return false;
+        }
+        m_audioBuf = m_ioArena.carve(PipeReader::BUFFER_BYTES);
+        m_planarBuf = m_ioArena.carve(PipeReader::BUFFER_BYTES);
+
+        sigset_t signals = control_signals();
+        m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+        m_eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        m_signalFd = signalfd(-1, &signals, SFD_CLOEXEC | SFD_NONBLOCK);
+        m_tickFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        m_statsFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        if (m_epollFd < 0 || m_eventFd < 0 || m_signalFd < 0 || m_tickFd < 0 || m_statsFd < 0 ||
+            !loop_add(m_epollFd, m_eventFd, loop_tag(LoopSource::Jobs)) ||
+            !loop_add(m_epollFd, m_signalFd, loop_tag(LoopSource::Signal)) ||
+            !loop_add(m_epollFd, m_tickFd, loop_tag(LoopSource::Tick)) ||
+            !loop_add(m_epollFd, m_statsFd, loop_tag(LoopSource::StatsTimer))) {
+            LOG_ERROR("Failed to set up the zone event loop: " << strerror(errno));
+            return false;
+        }
+        // Space events stay in the set: they only fire after armSpaceEvent()
+        for (auto& zone : m_zones) {
+            loop_add(m_epollFd, zone->diretta->spaceEventFd(), loop_tag(LoopSource::Space, zone->index));
+        }
+        set_timer(m_tickFd, TICK_MS, TICK_MS);
+        if (m_config.stats_interval > 0) {
+            set_timer(m_statsFd, m_config.stats_interval * 1000, m_config.stats_interval * 1000);
+        }
+        return true;
+    }
+
+    int run() {
+        ZoneControl control(m_zones.size(), m_eventFd);
+        m_control = &control;
+        control.start();
+
+        for (auto& zone : m_zones) {
+            spawn(*zone);
+        }
+
+        // Two fds per zone (pipe, space event), plus jobs, signals and two timers
+        std::vector<struct epoll_event> events(2 * m_zones.size() + 4);
+
+        m_statsStart = std::chrono::steady_clock::now();
+        while (running) {
+            auto wait_start = std::chrono::steady_clock::now();
+            int n = epoll_wait(m_epollFd, events.data(), static_cast<int>(events.size()), -1);
+            m_waited += std::chrono::steady_clock::now() - wait_start;
+            if (n < 0 && errno != EINTR) {
+                LOG_ERROR("epoll_wait: " << strerror(errno));
+                break;
+            }
+
+            for (int i = 0; i < n && running; i++) {
+                uint64_t tag = events[i].data.u64;
+                switch (loop_source(tag)) {
+                case LoopSource::Pipe:
+                    service(*m_zones[loop_zone(tag)]);
+                    break;
+                case LoopSource::Space:
+                    resume(*m_zones[loop_zone(tag)]);
+                    break;
+                case LoopSource::Jobs:
+                    completeJobs();
+                    break;
+                case LoopSource::Signal:
+                    handleSignals();
+                    break;
+                case LoopSource::Tick:
+                    drain_fd(m_tickFd);
+                    tick(std::chrono::steady_clock::now());
+                    break;
+                case LoopSource::StatsTimer:
+                    drain_fd(m_statsFd);
+                    dumpStats();
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        shutdown();
+        m_control = nullptr;
+        control.stop();
+        return 0;
+    }
+
+private:
+    static size_t bytesPerFrame(const Zone& zone) {
+        return SQZ_BYTES_PER_SAMPLE * zone.hdr.channels;
+    }
+
+    void handleSignals() {
+        struct signalfd_siginfo info;
+        while (read(m_signalFd, &info, sizeof(info)) == sizeof(info)) {
+            if (info.ssi_signo == SIGUSR1) {
+                dumpStats();
+            } else if (info.ssi_signo == SIGCHLD) {
+                tick(std::chrono::steady_clock::now());    // Reap now, respawn on schedule
+            } else {
+                std::cout << "\nSignal " << info.ssi_signo << " received, shutting down..." << std::endl;
+                running = false;
+            }
+        }
+    }
+
+    // The worker has drained a throttled zone's ring below high water
+    void resume(Zone& zone) {
+        drain_fd(zone.diretta->spaceEventFd());
+        if (!zone.throttled) return;
+        zone.throttled = false;
+        zone.last_data = std::chrono::steady_clock::now();
+        arm(zone, true);
+        service(zone);
+    }
+
+    // Level-triggered membership: a busy or throttled zone is removed from
+    // the set (not just masked, which would still report EPOLLHUP)
+    void arm(Zone& zone, bool on) {
+        if (zone.fd < 0 || zone.armed == on) return;
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = loop_tag(LoopSource::Pipe, zone.index);
+        epoll_ctl(m_epollFd, on ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, zone.fd, &ev);
+        zone.armed = on;
+    }
+
+    void submit(Zone& zone, Zone::Job job, const AudioFormat& format = AudioFormat()) {
+        zone.job = job;
+        zone.job_format = format;
+        arm(zone, false);
+        m_control->submit(&zone);
+    }
+
+    void spawn(Zone& zone) {
+        Config zone_config = m_config;
+        zone_config.player_name = zone.spec.name;
+        zone_config.mac_address = zone.spec.mac;
+        zone_config.rates = zone.spec.rates;
+
+        int fd = -1;
+        pid_t pid = spawn_squeezelite(build_squeezelite_args(zone_config, "-"),
+                                      m_config.threads[ThreadRole::Squeezelite], fd);
+        auto now = std::chrono::steady_clock::now();
+        if (pid == -1) {
+            zone.respawn_at = now + std::chrono::seconds(RESPAWN_DELAY_S);
+            return;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        zone.pid = pid;
+        zone.fd = fd;
+        zone.reader = std::make_unique<PipeReader>(fd);
+        zone.have_format = false;
+        zone.last_data = zone.last_audio = now;
+        arm(zone, true);
+        LOG_INFO("[Zone " << zone.spec.name << "] Squeezelite started (PID: " << pid
+                 << ", MAC " << zone.spec.mac << ")");
+    }
+
+    // Pipe closed or stream unusable: drop the child, release the target and
+    // start a new squeezelite after RESPAWN_DELAY_S
+    void stopZone(Zone& zone) {
+        arm(zone, false);
+        zone.throttled = false;
+        close(zone.fd);
+        zone.fd = -1;
+        zone.reader.reset();
+        if (zone.pid > 0) {
+            kill(zone.pid, SIGTERM);    // Reaped in tick()
+        }
+        zone.have_format = false;
+        zone.respawn_at = std::chrono::steady_clock::now() + std::chrono::seconds(RESPAWN_DELAY_S);
+        if (zone.diretta_open) {
+            submit(zone, Zone::Job::Release);
+        }
+    }
+
+    void completeJobs() {
+        uint64_t count;
+        ssize_t ignored = read(m_eventFd, &count, sizeof(count));
+        (void)ignored;
+
+        for (auto& zone : m_zones) {
+            if (zone->job == Zone::Job::None ||
+                !zone->job_done.load(std::memory_order_acquire)) {
+                continue;
+            }
+            zone->job_done.store(false, std::memory_order_relaxed);
+            Zone::Job job = zone->job;
+            zone->job = Zone::Job::None;
+
+            if (job == Zone::Job::Release) {
+                zone->diretta_open = false;
+            } else if (zone->job_ok) {
+                zone->diretta_open = true;
+                zone->format = zone->job_format;
+                zone->last_audio = std::chrono::steady_clock::now();
+                LOG_INFO("[Zone " << zone->spec.name << "] [Ready] "
+                         << (zone->format.isDSD ? "DSD" : "PCM") << " at "
+                         << zone->format.sampleRate << "Hz");
+                // First playback: from here on the audio path should not allocate
+                RT_AUDIT_STEADY_STATE(true);
+            } else {
+                LOG_ERROR("[Zone " << zone->spec.name << "] Failed to open Diretta — "
+                          << "restarting zone in " << RESPAWN_DELAY_S << "s");
+                zone->diretta_open = false;
+                stopZone(*zone);
+                continue;
+            }
+
+            if (zone->fd >= 0) {
+                arm(*zone, true);
+                service(*zone);    // Data may have queued up meanwhile
+            }
+        }
+    }
+
+    // Read and forward what the zone's pipe has, up to CHUNKS_PER_WAKE chunks
+    void service(Zone& zone) {
+        int chunks = 0;
+        while (running && zone.fd >= 0 && zone.job == Zone::Job::None &&
+               !zone.throttled && chunks < CHUNKS_PER_WAKE) {
+            PipeReader& reader = *zone.reader;
+            auto now = std::chrono::steady_clock::now();
+
+            // A header needs all 16 bytes, audio at least one whole frame
+            uint8_t peek_buf[5];
+            size_t avail = reader.buffered();
+            bool header_next = avail >= sizeof(peek_buf) && reader.peek(peek_buf, sizeof(peek_buf)) &&
+                               memcmp(peek_buf, SQFH_SIGNATURE, sizeof(peek_buf)) == 0;
+            size_t need = (header_next || !zone.have_format) ? sizeof(SqFormatHeader)
+                                                              : bytesPerFrame(zone);
+            if (avail < need) {
+                ssize_t n = reader.fill();
+                if (n > 0) {
+                    zone.last_data = now;
+                    continue;
+                }
+                if (n == 0 || errno != EAGAIN) {
+                    LOG_WARN("[Zone " << zone.spec.name << "] Squeezelite pipe "
+                             << (n == 0 ? "closed" : strerror(errno))
+                             << " — restarting in " << RESPAWN_DELAY_S << "s");
+                    stopZone(zone);
+                }
+                return;    // Drained
+            }
+
+            if (header_next || !zone.have_format) {
+                SqFormatHeader hdr;
+                reader.readExact(&hdr, sizeof(hdr));    // Buffered: no I/O
+                if (!header_next || !isValidHeader(hdr)) {
+                    if (zone.have_format) {
+                        LOG_WARN("[Zone " << zone.spec.name
+                                 << "] False positive SQFH in audio data — ignoring");
+                        continue;
+                    }
+                    LOG_ERROR("[Zone " << zone.spec.name << "] Expected SQFH header — "
+                              << "stream desynchronized. Is squeezelite patched for v2.0?");
+                    stopZone(zone);
+                    return;
+                }
+
+                bool changed = !zone.have_format ||
+                               hdr.sample_rate != zone.hdr.sample_rate ||
+                               hdr.dsd_format != zone.hdr.dsd_format ||
+                               hdr.bit_depth != zone.hdr.bit_depth;
+                zone.hdr = hdr;
+                zone.have_format = true;
+                if (changed) {
+                    AudioFormat format = format_from_header(hdr, m_outputBitDepth);
+                    zone.chunk_bytes = chunk_bytes_for(hdr, format);
+                    if (m_config.latency_budget_ms > 0) {
+                        split_latency_budget(reader, *zone.diretta, hdr, format, m_config.latency_budget_ms,
+                                             budget_output_kb(zone.spec.rates, m_config.latency_budget_ms));
+                    } else {
+                        resize_pipe(reader, hdr, m_config.pipe_stall_ms);
+                    }
+                    LOG_INFO("[Zone " << zone.spec.name << "] [Format Change] "
+                             << (format.isDSD ? "DSD" : "PCM") << " at " << format.sampleRate << "Hz"
+                             << (format.isDSD ? "" : " / " + std::to_string(hdr.bit_depth) + "-bit"));
+                    submit(zone, Zone::Job::Open, format);
+                    return;
+                }
+                LOG_DEBUG("[Zone " << zone.spec.name << "] [Gapless] Same format, continuing stream");
+                continue;
+            }
+
+            // Consumer-driven flow control: stop reading (squeezelite blocks on
+            // the full pipe) until the worker has drained the ring
+            if (zone.diretta_open && zone.diretta->isPrefillComplete()) {
+                float level = zone.diretta->admissionLevel();
+                if (zone.diretta->getBufferLevel() > level && zone.diretta->armSpaceEvent(level)) {
+                    zone.throttled = true;
+                    arm(zone, false);
+                    return;
+                }
+            }
+
+            size_t bytes_per_frame = bytesPerFrame(zone);
+            size_t want = std::min(avail, zone.chunk_bytes) / bytes_per_frame * bytes_per_frame;
+            ssize_t bytes_read = reader.readUpTo(m_audioBuf, want);    // Buffered: no I/O
+            if (bytes_read <= 0) return;
+            size_t len = static_cast<size_t>(bytes_read);
+            size_t whole = len / bytes_per_frame * bytes_per_frame;
+            if (whole > 0 && whole < len) {
+                // Stopped at a signature inside a frame: keep the tail for later
+                reader.unread(len - whole);
+                len = whole;
+            }
+            chunks++;
+
+            if (!zone.diretta_open) {
+                if (isSilence(m_audioBuf, len)) continue;    // Discard silence
+                zone.last_audio = now;
+                // Same format resume: re-acquire, then send this chunk
+                LOG_INFO("[Zone " << zone.spec.name << "] Activity resumed — re-acquiring Diretta target");
+                reader.unread(len);
+                submit(zone, Zone::Job::Open, zone.format);
+                return;
+            }
+
+            if (send(zone, len)) {
+                zone.last_audio = now;
+            } else if (now - zone.last_audio >= std::chrono::seconds(IDLE_RELEASE_TIMEOUT_S)) {
+                LOG_INFO("[Zone " << zone.spec.name << "] Silence for " << IDLE_RELEASE_TIMEOUT_S
+                         << "s — releasing Diretta target for other sources");
+                submit(zone, Zone::Job::Release);
+                return;
+            }
+        }
+    }
+
+    // Returns false if the chunk was silence (from the conversion pass)
+    bool send(Zone& zone, size_t len) {
+        DSDFormatType dsd_type = static_cast<DSDFormatType>(zone.hdr.dsd_format);
+        size_t channels = zone.hdr.channels;
+        size_t bytes_per_frame = bytesPerFrame(zone);
+        size_t num_frames = len / bytes_per_frame;
+
+        uint32_t content = 0;
+        if (dsd_type == DSDFormatType::DOP) {
+            // DoP → Native DSD
+            size_t output_size = num_frames * 2 * channels;
+            content = convert_dop_to_native_dsd(m_audioBuf, m_planarBuf, num_frames, bytes_per_frame, channels);
+            zone.diretta->sendAudio(m_planarBuf, (output_size * 8) / channels);
+        } else if (dsd_type != DSDFormatType::NONE) {
+            // Native DSD: interleaved → planar with byte-swap
+            content = deinterleave_dsd_native(m_audioBuf, m_planarBuf, num_frames, bytes_per_frame, channels);
+            zone.diretta->sendAudio(m_planarBuf, (len * 8) / channels);
+        } else {
+            // PCM: send raw S32_LE — DirettaSync handles 32→24/16 conversion
+            if (zone.diretta->sendAudio(m_audioBuf, num_frames, &content) == 0) {
+                content = or_reduce_audio(m_audioBuf, len);    // Not pushed
+            }
+        }
+        zone.total_bytes += len;
+        m_inputBytes += len;
+        return content != 0;
+    }
+
+    // Once per TICK_MS: idle release, reaping and respawning children
+    void tick(std::chrono::steady_clock::time_point now) {
+        for (auto& zone : m_zones) {
+            if (zone->job != Zone::Job::None) continue;
+
+            if (zone->fd >= 0) {
+                if (zone->diretta_open && !zone->throttled &&
+                    now - zone->last_data >= std::chrono::seconds(IDLE_RELEASE_TIMEOUT_S)) {
+                    LOG_INFO("[Zone " << zone->spec.name << "] No activity for " << IDLE_RELEASE_TIMEOUT_S
+                             << "s — releasing Diretta target for other sources");
+                    submit(*zone, Zone::Job::Release);
+                }
+                continue;
+            }
+
+            if (zone->pid > 0 && waitpid(zone->pid, nullptr, WNOHANG) == zone->pid) {
+                zone->pid = -1;
+            }
+            if (zone->pid <= 0 && now >= zone->respawn_at && running) {
+                zone->restarts++;
+                spawn(*zone);
+            }
+        }
+    }
+
+    void dumpStats() {
+        std::cout << "\n════════════════════════════════════════" << std::endl;
+        std::cout << "[Zones] " << m_zones.size() << " zones" << std::endl;
+        std::cout << "════════════════════════════════════════" << std::endl;
+        auto now = std::chrono::steady_clock::now();
+        print_ingest_stats(std::chrono::duration<double>(now - m_statsStart).count(),
+                           std::chrono::duration<double>(m_waited).count(), m_inputBytes);
+        m_statsStart = now;
+        m_waited = std::chrono::steady_clock::duration::zero();
+        m_inputBytes = 0;
+        // A zone with a job pending belongs to the control thread, which may
+        // be inside its open() or release(): its DirettaSync is left alone
+        for (const auto& zone : m_zones) {
+            bool busy = zone->job != Zone::Job::None;
+            std::cout << "  " << std::left << std::setw(16) << zone->spec.name << std::right
+                      << " target " << (zone->spec.target + 1)
+                      << "  " << (busy ? "RECONFIGURING" :
+                                  zone->fd < 0 ? "DOWN" :
+                                  zone->diretta->isPlaying() ? "PLAYING" :
+                                  zone->diretta_open ? "OPEN" : "IDLE");
+            if (!busy && zone->diretta_open) {
+                const AudioFormat& fmt = zone->diretta->getFormat();
+                std::cout << "  " << fmt.sampleRate << "Hz/" << fmt.bitDepth << "bit "
+                          << (fmt.isDSD ? "DSD" : "PCM")
+                          << "  buffer " << std::fixed << std::setprecision(1)
+                          << (100.0f * zone->diretta->getBufferLevel()) << "%";
+            }
+            std::cout << "  " << (zone->total_bytes / 1024 / 1024) << " MB"
+                      << "  restarts " << zone->restarts << std::endl;
+        }
+        for (const auto& zone : m_zones) {
+            std::cout << "\n[Zone " << zone->spec.name << "]";
+            if (zone->reader) zone->reader->gauge().print(" ");
+            if (zone->job != Zone::Job::None) {
+                std::cout << "  Reconfiguring, statistics skipped" << std::endl;
+                continue;
+            }
+            zone->diretta->dumpStats();
+        }
+    }
+
+    void shutdown() {
+        for (auto& zone : m_zones) {
+            if (zone->pid > 0) kill(zone->pid, SIGTERM);
+        }
+        // Any job in flight finishes before the zones are torn down
+        for (auto& zone : m_zones) {
+            while (zone->job != Zone::Job::None &&
+                   !zone->job_done.load(std::memory_order_acquire)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        for (auto& zone : m_zones) {
+            arm(*zone, false);
+            if (zone->fd >= 0) close(zone->fd);
+            zone->fd = -1;
+            if (zone->pid > 0) waitpid(zone->pid, nullptr, 0);
+            zone->pid = -1;
+            if (zone->diretta_open) zone->diretta->release();
+            zone->diretta_open = false;
+            zone->diretta->disable();
+            LOG_INFO("[Zone " << zone->spec.name << "] Total streamed: "
+                     << (zone->total_bytes / 1024 / 1024) << " MB");
+        }
+    }
+
+    const Config& m_config;
+    int m_outputBitDepth;
+    std::vector<std::unique_ptr<Zone>> m_zones;
+    ZoneControl* m_control = nullptr;
+
+    AudioArena m_ioArena;
+    uint8_t* m_audioBuf = nullptr;
+    uint8_t* m_planarBuf = nullptr;
+
+    int m_epollFd = -1;
+    int m_eventFd = -1;
+    int m_signalFd = -1;
+    int m_tickFd = -1;
+    int m_statsFd = -1;
+
+    // Ingest load since the last dumpStats()
+    std::chrono::steady_clock::time_point m_statsStart;
+    std::chrono::steady_clock::duration m_waited{};
+    uint64_t m_inputBytes = 0;
+};
+
+// ================================================================
+// Fan-out (--fanout): followers play the main target's ring
+// ================================================================
+
+// Open the main target, then the followers in parallel (each open blocks on
+// its own target). A follower that fails, or negotiates a different sink
+// format than the main target, sits this track out.
+static bool open_outputs(const AudioFormat& format) {
+    if (!g_diretta->open(format)) {
+        return false;
+    }
+
+    // Each opener registers before the next starts: an open() placing the
+    // SDK's threads must not take another opener for one
+    std::vector<std::thread> openers;
+    for (const auto& follower : g_fanout) {
+        DirettaSync* f = follower.get();
+        std::promise<void> registered;
+        std::future<void> registeredFuture = registered.get_future();
+        openers.emplace_back([f, &format, registered = std::move(registered)]() mutable {
+            placeCurrentThread(("s2d-open" + std::to_string(f->getTargetIndex() + 1)).c_str(), ThreadPolicy());
+            registered.set_value();
+            if (!f->open(format)) {
+                LOG_WARN("[Fan-out] Target " << (f->getTargetIndex() + 1) << " failed to open");
+                f->release();
+            } else if (!f->fanoutFormatMatches()) {
+                LOG_WARN("[Fan-out] Target " << (f->getTargetIndex() + 1)
+                         << " negotiated a different sink format — skipped for this track");
+                f->release();
+            }
+        });
+        registeredFuture.wait();
+    }
+    for (auto& opener : openers) {
+        opener.join();
+    }
+    return true;
+}
+
+static void release_outputs() {
+    for (const auto& follower : g_fanout) {
+        follower->release();
+    }
+    g_diretta->release();
+}
+
+static void dump_stats() {
+    g_diretta->dumpStats();
+    for (const auto& follower : g_fanout) {
+        follower->dumpStats();
+    }
+}
+
+// ================================================================
+// Control loop (single-zone main thread)
+// ================================================================
+// Everything the main thread waits for goes through one epoll set: the
+// squeezelite pipe, the control signals, the idle release and statistics
+// timers and the worker's space event. The stream phases stay sequential;
+// where they wait, they call waitPipe() or waitSpace(), which handle
+// whatever else fires meanwhile.
+class ControlLoop {
+public:
+    static constexpr int IDLE_RELEASE_TIMEOUT_S = 5;
+
+    ~ControlLoop() {
+        for (int fd : {m_epollFd, m_signalFd, m_idleFd, m_statsFd}) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    bool init(int pipe_fd, int space_fd, unsigned int stats_interval_s) {
+        sigset_t signals = control_signals();
+        m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+        m_signalFd = signalfd(-1, &signals, SFD_CLOEXEC | SFD_NONBLOCK);
+        m_idleFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        m_statsFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        m_pipeFd = pipe_fd;
+        m_spaceFd = space_fd;
+        if (m_epollFd < 0 || m_signalFd < 0 || m_idleFd < 0 || m_statsFd < 0 ||
+            !loop_add(m_epollFd, space_fd, loop_tag(LoopSource::Space)) ||
+            !loop_add(m_epollFd, m_signalFd, loop_tag(LoopSource::Signal)) ||
+            !loop_add(m_epollFd, m_idleFd, loop_tag(LoopSource::IdleTimer)) ||
+            !loop_add(m_epollFd, m_statsFd, loop_tag(LoopSource::StatsTimer))) {
+            return false;
+        }
+        if (stats_interval_s > 0) {
+            set_timer(m_statsFd, stats_interval_s * 1000, stats_interval_s * 1000);
+        }
+        return true;
+    }
+
+    // Pipe statistics to report with the others
+    void setPipeGauge(PipeGauge* gauge) { m_pipeGauge = gauge; }
+
+    // Until the pipe is readable (true), or the caller has something to do:
+    // stopping, or the idle timeout expired (false)
+    bool waitPipe() {
+        watchPipe(true);
+        while (running && !m_idleExpired) {
+            if (dispatch(LoopSource::Pipe)) return true;
+        }
+        return false;
+    }
+
+    // Until the space event armed with DirettaSync::armSpaceEvent() fires
+    void waitSpace() {
+        watchPipe(false);    // Readable most of the time: would wake us right away
+        while (running && !dispatch(LoopSource::Space)) {}
+    }
+
+    // Idle release: runs while the target is held; audio pushes it back
+    // without a syscall, the timer re-arms itself for the remainder
+    void idleStart() {
+        m_lastActivity = std::chrono::steady_clock::now();
+        m_idleExpired = false;
+        m_idleArmed = true;
+        set_timer(m_idleFd, IDLE_RELEASE_TIMEOUT_S * 1000);
+    }
+
+    void idleStop() {
+        m_idleArmed = false;
+        m_idleExpired = false;
+        set_timer(m_idleFd, 0);
+    }
+
+    void activity() { m_lastActivity = std::chrono::steady_clock::now(); }
+
+    void countInput(size_t bytes) { m_inputBytes += bytes; }
+
+    bool idleExpired() {
+        bool expired = m_idleExpired;
+        m_idleExpired = false;
+        return expired;
+    }
+
+private:
+    // Removed from the set rather than masked, which would still report EPOLLHUP
+    void watchPipe(bool on) {
+        if (m_pipeWatched == on) return;
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = loop_tag(LoopSource::Pipe);
+        epoll_ctl(m_epollFd, on ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, m_pipeFd, &ev);
+        m_pipeWatched = on;
+    }
+
+    // One epoll_wait; true if `wanted` was among the events
+    bool dispatch(LoopSource wanted) {
+        struct epoll_event events[5];
+        auto wait_start = std::chrono::steady_clock::now();
+        int n = epoll_wait(m_epollFd, events, 5, -1);
+        m_waited += std::chrono::steady_clock::now() - wait_start;
+        if (n < 0) {
+            if (errno != EINTR) {
+                LOG_ERROR("epoll_wait: " << strerror(errno));
+                running = false;
+            }
+            return false;
+        }
+
+        bool found = false;
+        for (int i = 0; i < n; i++) {
+            LoopSource source = loop_source(events[i].data.u64);
+            switch (source) {
+            case LoopSource::Space:
+                drain_fd(m_spaceFd);    // Only fires after armSpaceEvent(), right before waitSpace()
+                break;
+            case LoopSource::Signal:
+                handleSignals();
+                break;
+            case LoopSource::IdleTimer:
+                drain_fd(m_idleFd);
+                idleTimer();
+                break;
+            case LoopSource::StatsTimer:
+                drain_fd(m_statsFd);
+                dumpStats();
+                break;
+            default:
+                break;
+            }
+            found = found || source == wanted;
+        }
+        return found;
+    }
+
+    void handleSignals() {
+        struct signalfd_siginfo info;
+        while (read(m_signalFd, &info, sizeof(info)) == sizeof(info)) {
+            if (info.ssi_signo == SIGUSR1) {
+                dumpStats();
+            } else if (info.ssi_signo == SIGCHLD) {
+                int status = 0;
+                if (squeezelite_pid > 0 && waitpid(squeezelite_pid, &status, WNOHANG) == squeezelite_pid) {
+                    squeezelite_pid = 0;
+                    if (running) {
+                        if (WIFSIGNALED(status)) {
+                            LOG_ERROR("Squeezelite killed by signal " << WTERMSIG(status));
+                        } else {
+                            LOG_INFO("Squeezelite exited (status " << WEXITSTATUS(status) << ")");
+                        }
+                    }
+                    running = false;
+                }
+            } else {
+                std::cout << "\nSignal " << info.ssi_signo << " received, shutting down..." << std::endl;
+                running = false;
+                if (squeezelite_pid > 0) {
+                    kill(squeezelite_pid, SIGTERM);
+                }
+            }
+        }
+    }
+
+    void dumpStats() {
+        dump_stats();
+        auto now = std::chrono::steady_clock::now();
+        print_ingest_stats(std::chrono::duration<double>(now - m_statsStart).count(),
+                           std::chrono::duration<double>(m_waited).count(), m_inputBytes);
+        if (m_pipeGauge) m_pipeGauge->print("");
+        m_statsStart = now;
+        m_waited = std::chrono::steady_clock::duration::zero();
+        m_inputBytes = 0;
+    }
+
+    void idleTimer() {
+        if (!m_idleArmed) return;
+        auto idle_for = std::chrono::steady_clock::now() - m_lastActivity;
+        auto timeout = std::chrono::seconds(IDLE_RELEASE_TIMEOUT_S);
+        if (idle_for < timeout) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(timeout - idle_for);
+            set_timer(m_idleFd, std::max<int64_t>(1, remaining.count()));
+            return;
+        }
+        m_idleArmed = false;
+        m_idleExpired = true;
+    }
+
+    int m_epollFd = -1;
+    int m_signalFd = -1;
+    int m_idleFd = -1;
+    int m_statsFd = -1;
+    int m_pipeFd = -1;
+    int m_spaceFd = -1;
+    bool m_pipeWatched = false;
+    PipeGauge* m_pipeGauge = nullptr;
+
+    std::chrono::steady_clock::time_point m_lastActivity;
+    bool m_idleArmed = false;
+    bool m_idleExpired = false;
+
+    // Ingest load since the last dumpStats()
+    std::chrono::steady_clock::time_point m_statsStart = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration m_waited{};
+    uint64_t m_inputBytes = 0;
+};
+
+// ================================================================
+// Main
+// ================================================================
+int main(int argc, char* argv[]) {
+    // Calibration runs start this binary in squeezelite's place
+    if (argc == 4 && std::strcmp(argv[1], "--test-signal") == 0) {
+        return runTestSignal(argv[2], argv[3]);
+    }
+
+    std::cout << "================================================================" << std::endl;
+    std::cout << "  squeeze2diretta v" << WRAPPER_VERSION << std::endl;
+    std::cout << "  Squeezelite to Diretta Bridge" << std::endl;
+    std::cout << "  Using DirettaSync from DirettaRendererUPnP v2.0" << std::endl;
+    std::cout << "  In-band format signaling (no stderr parsing)" << std::endl;
+    std::cout << "================================================================" << std::endl;
+    std::cout << std::endl;
+
+    // Parse arguments
+    Config config = parse_args(argc, argv);
+
+    // Benchmarks run standalone: no squeezelite, no Diretta target
+    if (!config.bench.empty()) {
+        BenchOptions benchOptions;
+        benchOptions.stateDir = config.state_dir;
+        return runBenchmark(config.bench, benchOptions);
+    }
+
+    // Calibration drives runs of this binary, one per setting tried
+    if (config.calibrate) {
+        if (!config.zones_file.empty()) {
+            LOG_ERROR("--calibrate is not supported with --zones");
+            return 1;
+        }
+        CalibrateOptions calibrateOptions;
+        calibrateOptions.baseArgs = calibration_base_args(argc, argv);
+        calibrateOptions.stateDir = config.state_dir;
+        calibrateOptions.families = config.calibrate_families;
+        calibrateOptions.threadModes = config.calibrate_thread_modes;
+        if (calibrateOptions.threadModes.empty()) {
+            calibrateOptions.threadModes.push_back(config.thread_mode);
+        }
+        calibrateOptions.seconds = config.calibrate_seconds;
+        calibrateOptions.dsdFormat = config.dsd_format;
+        if (!config.rates.empty()) {
+            unsigned long maxRate = std::strtoul(config.rates.c_str(), nullptr, 10);
+            if (maxRate >= 44100 && maxRate <= MAX_SQUEEZELITE_RATE) {
+                calibrateOptions.maxSampleRate = static_cast<uint32_t>(maxRate);
+            }
+        }
+        return runCalibration(calibrateOptions);
+    }
+
+    // Multi-zone mode: read the zone file before anything is started
+    std::vector<ZoneSpec> zones;
+    if (!config.zones_file.empty()) {
+        std::string error;
+        ZoneSpec defaults;
+        defaults.rates = config.rates;
+        defaults.worker = config.threads[ThreadRole::Worker];
+        if (!loadZoneFile(config.zones_file, defaults, zones, error)) {
+            LOG_ERROR("Invalid --zones file: " << error);
+            return 1;
+        }
+        // Followers read the single player's ring; zones each have their own
+        if (!config.fanout_targets.empty()) {
+            LOG_ERROR("--fanout is not supported with --zones");
+            return 1;
+        }
+    }
+
+    // Validate PCM output bit depth
+    const int output_bit_depth = config.sample_format;
+    if (output_bit_depth != 16 && output_bit_depth != 24 && output_bit_depth != 32) {
+        LOG_ERROR("Invalid sample format: " << output_bit_depth << " (must be 16, 24, or 32)");
+        return 1;
+    }
+
+    g_verbose = config.verbose;
+    if (config.verbose) {
+        g_logLevel = LogLevel::DEBUG;
+    } else if (config.quiet) {
+        g_logLevel = LogLevel::WARN;
+    }
+
+    if (g_verbose) {
+        g_logRing = new LogRing();
+    }
+
+    // List targets if requested
+    if (config.list_targets) {
+        DirettaSync::listTargets();
+        if (g_logRing) delete g_logRing;
+        return 0;
+    }
+
+    // Thread placement: report the plan, then place the threads we own.
+    // The main thread doubles as the ingest thread (pipe reader / producer);
+    // its kernel name is left alone since ps, pgrep and systemd show it.
+    {
+        std::ostringstream plan;
+        for (int i = 0; i < static_cast<int>(ThreadRole::COUNT); i++) {
+            ThreadRole role = static_cast<ThreadRole>(i);
+            plan << " " << threadRoleName(role) << "=" << describeThreadPolicy(config.threads[role]);
+        }
+        LOG_INFO("[Threads] Plan:" << plan.str());
+    }
+#ifdef RT_AUDIT
+    rtAuditInit(config.rt_audit_mode);
+#endif
+
+    // Lock memory before DirettaSync allocates its buffers and the other
+    // threads start, so all of it is resident from the beginning. The
+    // headroom check counts the targets driven and the threads they bring
+    // (ingest, log drain, conversion helpers, zone control).
+    if (config.lock_memory) {
+        unsigned int targets = zones.empty() ? static_cast<unsigned int>(1 + config.fanout_targets.size())
+                                             : static_cast<unsigned int>(zones.size());
+        unsigned int threads = 2 + static_cast<unsigned int>(config.convert_threads) + (zones.empty() ? 0 : 1) +
+                               targets * MemoryLock::THREADS_PER_TARGET;
+        lockProcessMemory(targets, threads);
+    }
+
+    placeCurrentThread("ingest", config.threads[ThreadRole::Ingest], true, false);
+    prefaultStack();
+
+    // Pin the memcpy_audio() strategy before any audio is copied: measured
+    // on the ingest thread's CPU once per machine, then read from the state dir
+    selectMemcpyStrategy(config.state_dir);
+    RT_AUDIT_THREAD("ingest");
+
+    // The patched squeezelite coalesces its stdout writes to this size, one
+    // PipeReader buffer per read() (smaller writes under a tight latency
+    // budget, so two still fit the pipe's share); set before any thread
+    // starts (setenv is not thread-safe), inherited by every squeezelite we spawn
+    g_pipe_write_bytes = config.latency_budget_ms > 0 ? budget_write_bytes(config.latency_budget_ms)
+                                                      : PipeReader::BUFFER_BYTES;
+    setenv("SQ_STDOUT_WRITE_BYTES", std::to_string(g_pipe_write_bytes).c_str(), 0);
+
+    // Control signals go to the event loop's signalfd: block them before
+    // any thread starts, so every thread inherits the mask
+    sigset_t signals = control_signals();
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    start_log_drain(config.threads[ThreadRole::LogDrain]);
+
+    if (config.convert_threads > 0) {
+        if (g_convert.start(config.convert_threads, config.threads[ThreadRole::Convert])) {
+            LOG_INFO("[Convert] Ingest thread + " << config.convert_threads
+                     << " conversion thread(s) for large chunks");
+        } else {
+            LOG_WARN("Conversion threads not started, converting on the ingest thread");
+        }
+    }
+
+    if (!zones.empty()) {
+        int status = 0;
+        {
+            ZoneSupervisor supervisor(config, zones, output_bit_depth);
+            LOG_INFO("Multi-zone mode: " << zones.size() << " zones from " << config.zones_file);
+            status = supervisor.enable() ? supervisor.run() : 1;
+        }
+        RT_AUDIT_STEADY_STATE(false);
+        stop_logging();
+        LOG_INFO("Stopped");
+#ifdef RT_AUDIT
+        if (rtAuditReport() > 0) {
+            return 3;
+        }
+#endif
+        return status;
+    }
+
+    // Create DirettaSync instance
+    g_diretta = std::make_unique<DirettaSync>();
+
+    DirettaConfig direttaConfig;
+    direttaConfig.threadMode = config.thread_mode;
+    direttaConfig.cycleTime = config.cycle_time;
+    direttaConfig.cycleTimeAuto = config.cycle_time_auto;
+    direttaConfig.transferMode = config.transfer_mode;
+    direttaConfig.mtu = config.mtu;
+    direttaConfig.hugePages = config.huge_pages;
+    direttaConfig.ntStores = config.nt_stores;
+    direttaConfig.targetLatencyMs = config.target_latency_ms;
+    direttaConfig.adaptiveBuffer = config.adaptive_buffer;
+    direttaConfig.latencyBudgetMs = config.latency_budget_ms;
+    direttaConfig.adaptiveMinMs = config.adaptive_min_ms;
+    direttaConfig.adaptiveMaxMs = config.adaptive_max_ms;
+    direttaConfig.stateDir = config.state_dir;
+    direttaConfig.adaptiveCycle = config.adaptive_cycle;
+    direttaConfig.adaptiveCycleMinUs = config.adaptive_cycle_min_us;
+    direttaConfig.adaptiveCycleMaxUs = config.adaptive_cycle_max_us;
+    direttaConfig.measureCallbacks = !config.calibrate_report.empty();
+    direttaConfig.convertPool = &g_convert;
+    direttaConfig.workerPolicy = config.threads[ThreadRole::Worker];
+    direttaConfig.sdkPolicy = config.threads[ThreadRole::Sdk];
+    direttaConfig.maxSampleRate = 768000;    // Squeezelite -r upper bound (see build_squeezelite_args)
+    if (!config.rates.empty()) {
+        unsigned long maxRate = std::strtoul(config.rates.c_str(), nullptr, 10);
+        if (maxRate >= 44100 && maxRate <= MAX_SQUEEZELITE_RATE) {
+            direttaConfig.maxSampleRate = static_cast<uint32_t>(maxRate);
+        }
+    }
+
+    if (config.diretta_target >= 0) {
+        g_diretta->setTargetIndex(config.diretta_target);
+    }
+    if (config.mtu > 0) {
+        g_diretta->setMTU(config.mtu);
+    }
+
+    LOG_INFO("Initializing Diretta...");
+
+    if (!g_diretta->enable(direttaConfig)) {
+        LOG_ERROR("Failed to enable Diretta. Check that a Diretta target is available.");
+        LOG_ERROR("Use -l to list available targets.");
+        stop_logging();
+        return 1;
+    }
+
+    LOG_INFO("Diretta enabled successfully");
+
+    for (int target : config.fanout_targets) {
+        auto follower = std::make_unique<DirettaSync>();
+        follower->setTargetIndex(target);
+        if (config.mtu > 0) {
+            follower->setMTU(config.mtu);
+        }
+        if (!g_diretta->addFanoutFollower(*follower) || !follower->enable(direttaConfig)) {
+            LOG_ERROR("Failed to enable fan-out target " << (target + 1));
+            for (const auto& f : g_fanout) {
+                f->disable();
+            }
+            g_fanout.clear();
+            g_diretta->disable();
+            stop_logging();
+            return 1;
+        }
+        LOG_INFO("Fan-out target " << (target + 1) << " enabled");
+        g_fanout.push_back(std::move(follower));
+    }
+
+    // Build squeezelite command
+    std::vector<std::string> squeezelite_args = build_squeezelite_args(config, "-");
+    if (!config.calibrate_signal.empty()) {
+        // Calibration run: this binary streams the test signal instead
+        squeezelite_args = {"/proc/self/exe", "--test-signal", config.calibrate_signal, config.dsd_format};
+    }
+    if (g_logLevel >= LogLevel::DEBUG) {
+        std::cout << "Squeezelite command: ";
+        for (const auto& arg : squeezelite_args) {
+            std::cout << arg << " ";
+        }
+        std::cout << std::endl;
+    }
+
+    // Fork and exec squeezelite, stdout (audio + headers) on a pipe
+    int fifo_fd = -1;
+    squeezelite_pid = spawn_squeezelite(squeezelite_args,
+                                        config.threads[ThreadRole::Squeezelite], fifo_fd);
+    if (squeezelite_pid == -1) {
+        g_diretta->disable();
+        stop_logging();
+        return 1;
+    }
+
+    LOG_INFO("Squeezelite started (PID: " << squeezelite_pid << ")");
+    LOG_INFO("Waiting for first track header...");
+    LOG_INFO("");
+
+    // ================================================================
+    // Main loop: synchronous header-based format detection
+    // ================================================================
+    // The patched squeezelite writes a 16-byte "SQFH" header to stdout
+    // only when the format changes (or for the first track). Same-format
+    // gapless transitions emit no header — audio flows uninterrupted.
+    // No stderr parsing or race conditions.
+    // ================================================================
+
+    // Non-blocking pipe: the reader waits in the control loop, not in read()
+    fcntl(fifo_fd, F_SETFL, fcntl(fifo_fd, F_GETFL) | O_NONBLOCK);
+    PipeReader reader(fifo_fd);
+
+    ControlLoop loop;
+    loop.setPipeGauge(&reader.gauge());
+    if (!loop.init(fifo_fd, g_diretta->spaceEventFd(), config.stats_interval)) {
+        LOG_ERROR("Failed to set up the event loop: " << strerror(errno));
+        running = false;    // Skip the main loop, clean up below
+    }
+
+    // Current format state
+    AudioFormat current_format;
+    DSDFormatType current_dsd_type = DSDFormatType::NONE;
+    unsigned int current_rate = 0;
+    uint8_t current_depth = 0;
+    bool diretta_open = false;
+
+    // Streaming state
+    uint64_t total_bytes = 0;
+    uint64_t total_frames = 0;
+
+    // Calibration run: what --calibrate-report gets
+    CalibrationReport calibration;
+
+    // Pipe and conversion buffers: fixed size, carved once from an arena,
+    // for the largest chunk (chunk_bytes_for()). DSD conversion output never
+    // exceeds its input, so that covers planar_buf for every format.
+    AudioArena io_arena;
+    if (!io_arena.allocate(2 * PipeReader::BUFFER_BYTES + 2 * AudioArena::DEFAULT_ALIGNMENT)) {
+        LOG_ERROR("Failed to map I/O buffers: " << strerror(errno));
+        running = false;    // Skip the main loop, clean up below
+    }
+    uint8_t* const audio_buf = io_arena.carve(PipeReader::BUFFER_BYTES);
+    uint8_t* const planar_buf = io_arena.carve(PipeReader::BUFFER_BYTES);
+    size_t chunk_bytes = PIPE_BUF_SIZE;
 
     // Persistent header state (survives false positive recovery)
     SqFormatHeader hdr{};
     DSDFormatType dsd_type = DSDFormatType::NONE;
     bool is_dsd = false;
 
-    while (running) {
-        // ============================================================
-        // Idle release: free Diretta target if no new track arrives
-        // ============================================================
-        if (diretta_open && !reader.waitForData(IDLE_RELEASE_TIMEOUT_S * 1000)) {
-            LOG_INFO("No activity for " << IDLE_RELEASE_TIMEOUT_S
-                     << "s — releasing Diretta target for other sources");
-            g_diretta->release();
-            diretta_open = false;
+    // ================================================================
+    // Idle release: free Diretta target after IDLE_RELEASE_TIMEOUT_S
+    // without audio (no data, or only silence)
+    // ================================================================
+    auto idle_release = [&]() {
+        LOG_INFO("No audio for " << ControlLoop::IDLE_RELEASE_TIMEOUT_S
+                 << "s — releasing Diretta target for other sources");
+        release_outputs();
+        diretta_open = false;
+        loop.idleStop();
+    };
+
+    // Pipe empty: wait in the control loop. Nothing is being sent meanwhile,
+    // so an idle expiry is acted on right away.
+    reader.setWaiter([&]() {
+        while (running) {
+            if (loop.waitPipe()) return true;
+            if (loop.idleExpired() && diretta_open) idle_release();
         }
+        return false;
+    });
 
+    while (running) {
         // ============================================================
         // Phase 1: Read format header (blocking)
         // ============================================================
@@ -710,21 +2610,9 @@ int main(int argc, char* argv[]) {
                                 hdr.bit_depth != current_depth);
 
         if (format_changed) {
-            // Calculate actual DSD bit rate and Diretta format
-            unsigned int actual_rate = hdr.sample_rate;
-            unsigned int bit_depth = static_cast<unsigned int>(output_bit_depth);
-
-            if (is_dsd) {
-                if (dsd_type == DSDFormatType::U32_BE || dsd_type == DSDFormatType::U32_LE) {
-                    // Native DSD: frame rate × 32 = DSD bit rate
-                    actual_rate = hdr.sample_rate * 32;
-                    bit_depth = 1;
-                } else if (dsd_type == DSDFormatType::DOP) {
-                    // DoP: carrier rate × 16 = DSD bit rate
-                    actual_rate = hdr.sample_rate * 16;
-                    bit_depth = 1;
-                }
-            }
+            // Diretta format: actual DSD bit rate, configured PCM output depth
+            AudioFormat format = format_from_header(hdr, output_bit_depth);
+            unsigned int actual_rate = format.sampleRate;
 
             if (dsd_type == DSDFormatType::DOP) {
                 LOG_INFO("\n[Format Change] DoP->DSD at " << actual_rate << "Hz"
@@ -742,23 +2630,24 @@ int main(int argc, char* argv[]) {
             // detecting the format change and doing the critical SDK close/reopen
             // needed for sample rate changes (e.g., 48kHz → 44.1kHz).
 
-            // Build AudioFormat for DirettaSync
-            AudioFormat format;
-            format.sampleRate = actual_rate;
-            format.bitDepth = bit_depth;
-            format.channels = hdr.channels;
-            format.isDSD = is_dsd;
-            format.isCompressed = false;
-
             if (is_dsd) {
-                format.dsdFormat = AudioFormat::DSDFormat::DFF;  // MSB (byte-swap in de-interleave)
                 LOG_DEBUG("[DSD Format] "
                           << (dsd_type == DSDFormatType::DOP ? "DoP->DSD" : "Native DSD")
                           << " as DFF (MSB)");
             }
 
+            auto transition_start = std::chrono::steady_clock::now();
+
+            // Before open(): squeezelite keeps writing while it runs
+            if (config.latency_budget_ms > 0) {
+                split_latency_budget(reader, *g_diretta, hdr, format, config.latency_budget_ms,
+                                     budget_output_kb(config.rates, config.latency_budget_ms));
+            } else {
+                resize_pipe(reader, hdr, config.pipe_stall_ms);
+            }
+
             // Open Diretta with new format
-            if (!g_diretta->open(format)) {
+            if (!open_outputs(format)) {
                 LOG_ERROR("Failed to open Diretta with new format");
                 running = false;
                 break;
@@ -770,7 +2659,10 @@ int main(int argc, char* argv[]) {
             }
 
             diretta_open = true;
+            loop.idleStart();
             current_format = format;
+            chunk_bytes = chunk_bytes_for(hdr, format);
+            LOG_DEBUG("[Chunk] " << chunk_bytes << " bytes per read");
             current_rate = hdr.sample_rate;
             current_dsd_type = dsd_type;
             current_depth = hdr.bit_depth;
@@ -799,7 +2691,7 @@ int main(int argc, char* argv[]) {
                     break;
                 }
 
-                ssize_t n = reader.readUpTo(audio_buf.data(), PIPE_BUF_SIZE);
+                ssize_t n = reader.readUpTo(audio_buf, chunk_bytes);
                 if (n <= 0) break;
 
                 size_t num_frames = static_cast<size_t>(n) / bytes_per_frame;
@@ -808,22 +2700,20 @@ int main(int argc, char* argv[]) {
                 if (is_dsd && dsd_type == DSDFormatType::DOP) {
                     size_t dsd_bytes_per_frame = 2 * hdr.channels;
                     size_t output_size = num_frames * dsd_bytes_per_frame;
-                    if (planar_buf.size() < output_size) planar_buf.resize(output_size);
-                    convert_dop_to_native_dsd(audio_buf.data(), planar_buf.data(),
+                    convert_dop_to_native_dsd(audio_buf, planar_buf,
                                                num_frames, bytes_per_frame, hdr.channels);
                     num_samples = (output_size * 8) / hdr.channels;
-                    g_diretta->sendAudio(planar_buf.data(), num_samples);
+                    g_diretta->sendAudio(planar_buf, num_samples);
                     burst_bytes += output_size;
                 } else if (is_dsd) {
-                    if (planar_buf.size() < static_cast<size_t>(n)) planar_buf.resize(n);
-                    deinterleave_dsd_native(audio_buf.data(), planar_buf.data(),
+                    deinterleave_dsd_native(audio_buf, planar_buf,
                                              num_frames, bytes_per_frame, hdr.channels);
                     num_samples = (static_cast<size_t>(n) * 8) / hdr.channels;
-                    g_diretta->sendAudio(planar_buf.data(), num_samples);
+                    g_diretta->sendAudio(planar_buf, num_samples);
                     burst_bytes += n;
                 } else {
                     num_samples = num_frames;
-                    g_diretta->sendAudio(audio_buf.data(), num_samples);
+                    g_diretta->sendAudio(audio_buf, num_samples);
                     burst_bytes += n;
                 }
             }
@@ -835,10 +2725,22 @@ int main(int argc, char* argv[]) {
                           << burst_elapsed.count() << "ms");
             }
 
+            // Transition: format header to prefill complete
+            if (g_diretta->isPrefillComplete()) {
+                double transition_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - transition_start).count();
+                calibration.transitionMs = std::max(calibration.transitionMs, transition_ms);
+                calibration.transitions++;
+                calibration.cycles[CycleTuning::rateKey(format.isDSD, format.sampleRate)] = g_diretta->cycleSettings();
+            }
+
             if (dsd_type == DSDFormatType::DOP) LOG_INFO("[Ready] DoP->DSD at " << actual_rate << "Hz");
             else if (is_dsd) LOG_INFO("[Ready] DSD at " << actual_rate << "Hz");
             else LOG_INFO("[Ready] PCM at " << actual_rate << "Hz");
 
+            // First playback: from here on the audio path should not allocate
+            RT_AUDIT_STEADY_STATE(true);
+
         } else {
             // Same format — gapless transition, no reopen needed
             LOG_DEBUG("[Gapless] Same format, continuing stream");
@@ -853,46 +2755,36 @@ int main(int argc, char* argv[]) {
         size_t bytes_per_frame = SQZ_BYTES_PER_SAMPLE * hdr.channels;
         unsigned int rate_for_timing = is_dsd ? hdr.sample_rate : current_format.sampleRate;
 
-        auto last_audio_time = std::chrono::steady_clock::now();
-
         while (running) {
+            // Idle timeout seen while waiting for ring space
+            if (loop.idleExpired() && diretta_open) {
+                idle_release();
+            }
+
             // Check for next track header (5-byte signature: magic + version)
             uint8_t peek_buf[5];
             if (reader.peek(peek_buf, 5) && memcmp(peek_buf, SQFH_SIGNATURE, 5) == 0) {
                 break;  // Next track — back to outer loop for header parsing
             }
 
-            ssize_t bytes_read = reader.readUpTo(audio_buf.data(), PIPE_BUF_SIZE);
+            ssize_t bytes_read = reader.readUpTo(audio_buf, chunk_bytes);
 
             if (bytes_read <= 0) {
                 if (bytes_read == 0) {
                     LOG_INFO("Squeezelite pipe closed");
-                } else if (errno != EINTR) {
+                } else if (running) {
                     LOG_ERROR("Error reading from pipe: " << strerror(errno));
                 }
                 running = false;
                 break;
             }
 
-            // Silence detection for idle target release
-            bool silence = isSilence(audio_buf.data(), static_cast<size_t>(bytes_read));
-            if (!silence) {
-                last_audio_time = std::chrono::steady_clock::now();
-            } else if (diretta_open) {
-                auto elapsed = std::chrono::steady_clock::now() - last_audio_time;
-                if (elapsed >= std::chrono::seconds(IDLE_RELEASE_TIMEOUT_S)) {
-                    LOG_INFO("Silence for " << IDLE_RELEASE_TIMEOUT_S
-                             << "s — releasing Diretta target for other sources");
-                    g_diretta->release();
-                    diretta_open = false;
-                }
-            }
-
             // While target is released, discard silence and wait for real audio
             if (!diretta_open) {
-                if (silence) {
+                if (isSilence(audio_buf, static_cast<size_t>(bytes_read))) {
                     continue;  // Discard silence
                 }
+                loop.activity();
                 // Non-silence: check if a new format header follows
                 uint8_t hdr_peek[5];
                 if (reader.peek(hdr_peek, 5) && memcmp(hdr_peek, SQFH_SIGNATURE, 5) == 0) {
@@ -900,13 +2792,13 @@ int main(int argc, char* argv[]) {
                 }
                 // Same format resume — re-acquire target
                 LOG_INFO("Activity resumed — re-acquiring Diretta target");
-                if (!g_diretta->open(current_format)) {
+                if (!open_outputs(current_format)) {
                     LOG_ERROR("Failed to re-acquire Diretta target");
                     running = false;
                     break;
                 }
                 diretta_open = true;
-                last_audio_time = std::chrono::steady_clock::now();
+                loop.idleStart();
             }
 
             size_t num_frames = static_cast<size_t>(bytes_read) / bytes_per_frame;
@@ -914,48 +2806,52 @@ int main(int argc, char* argv[]) {
 
             // Consumer-driven flow control: wait for space BEFORE pushing
             // push() is non-blocking and truncates if full — must wait first
-            // to avoid silently dropping audio data
+            // to avoid silently dropping audio data. The level is 75%, or
+            // what the fill-level controller sets (--target-latency,
+            // --adaptive-buffer)
             if (g_diretta->isPrefillComplete()) {
-                while (running) {
-                    float level = g_diretta->getBufferLevel();
-                    if (level <= RING_HIGH_WATER) break;
-                    std::unique_lock<std::mutex> lock(g_diretta->getFlowMutex());
-                    g_diretta->waitForSpace(lock, std::chrono::milliseconds(50));
+                float level = g_diretta->admissionLevel();
+                while (running && g_diretta->armSpaceEvent(level)) {
+                    loop.waitSpace();
                 }
             }
 
-            // Process and send based on format
+            // Process and send based on format. The conversion pass also
+            // reports silence (OR of the input words) for idle target release
+            uint32_t content = 0;
             if (current_format.isDSD && current_dsd_type == DSDFormatType::DOP) {
                 // DoP → Native DSD
                 size_t dsd_bytes_per_frame = 2 * hdr.channels;
                 size_t output_size = num_frames * dsd_bytes_per_frame;
-                if (planar_buf.size() < output_size) planar_buf.resize(output_size);
-                convert_dop_to_native_dsd(audio_buf.data(), planar_buf.data(),
-                                           num_frames, bytes_per_frame, hdr.channels);
+                content = convert_dop_to_native_dsd(audio_buf, planar_buf,
+                                                     num_frames, bytes_per_frame, hdr.channels);
                 num_samples = (output_size * 8) / hdr.channels;
-                g_diretta->sendAudio(planar_buf.data(), num_samples);
+                g_diretta->sendAudio(planar_buf, num_samples);
 
             } else if (current_format.isDSD) {
                 // Native DSD: interleaved → planar with byte-swap
-                if (planar_buf.size() < static_cast<size_t>(bytes_read)) {
-                    planar_buf.resize(bytes_read);
-                }
-                deinterleave_dsd_native(audio_buf.data(), planar_buf.data(),
-                                         num_frames, bytes_per_frame, hdr.channels);
+                content = deinterleave_dsd_native(audio_buf, planar_buf,
+                                                   num_frames, bytes_per_frame, hdr.channels);
                 num_samples = (static_cast<size_t>(bytes_read) * 8) / hdr.channels;
-                g_diretta->sendAudio(planar_buf.data(), num_samples);
+                g_diretta->sendAudio(planar_buf, num_samples);
 
             } else {
                 // PCM: send raw S32_LE — DirettaSync handles 32→24/16 conversion
                 num_samples = num_frames;
-                g_diretta->sendAudio(audio_buf.data(), num_samples);
+                if (g_diretta->sendAudio(audio_buf, num_samples, &content) == 0) {
+                    content = or_reduce_audio(audio_buf, static_cast<size_t>(bytes_read));    // Not pushed
+                }
+            }
+            if (content != 0) {
+                loop.activity();
             }
 
             total_bytes += static_cast<uint64_t>(bytes_read);
             total_frames += num_frames;
+            loop.countInput(static_cast<size_t>(bytes_read));
 
             // Progress (debug level, every ~10 seconds)
-            if (g_logLevel >= LogLevel::DEBUG && total_frames % (rate_for_timing * 10) < (PIPE_BUF_SIZE / bytes_per_frame)) {
+            if (g_logLevel >= LogLevel::DEBUG && total_frames % (rate_for_timing * 10) < (chunk_bytes / bytes_per_frame)) {
                 double seconds = static_cast<double>(total_frames) / static_cast<double>(rate_for_timing);
                 LOG_DEBUG("Streamed: " << std::fixed << std::setprecision(1)
                           << seconds << "s (" << (total_bytes / 1024 / 1024) << " MB)");
@@ -965,14 +2861,27 @@ int main(int argc, char* argv[]) {
     }
 
     // Cleanup
+    RT_AUDIT_STEADY_STATE(false);
     LOG_INFO("");
     LOG_INFO("Shutting down...");
 
     if (diretta_open) {
-        g_diretta->release();
+        release_outputs();
         diretta_open = false;
     }
+    for (const auto& follower : g_fanout) {
+        follower->disable();
+    }
+    if (!config.calibrate_report.empty()) {
+        calibration.target = g_diretta->targetName();
+        calibration.callbacks = g_diretta->callbackResult();
+        std::string error;
+        if (!calibration.save(config.calibrate_report, error)) {
+            LOG_ERROR("Could not write the calibration report: " << error);
+        }
+    }
     g_diretta->disable();
+    g_fanout.clear();
     g_diretta.reset();
 
     close(fifo_fd);
@@ -982,14 +2891,18 @@ int main(int argc, char* argv[]) {
         waitpid(squeezelite_pid, nullptr, 0);
     }
 
-    if (g_logRing) {
-        delete g_logRing;
-        g_logRing = nullptr;
-    }
+    stop_logging();
 
     LOG_INFO("Stopped");
     LOG_INFO("Total streamed: " << total_frames << " frames ("
               << (total_bytes / 1024 / 1024) << " MB)");
 
+#ifdef RT_AUDIT
+    // Non-zero exit status so scripted runs catch RT-path allocations
+    if (rtAuditReport() > 0) {
+        return 3;
+    }
+#endif
+
     return 0;
 }
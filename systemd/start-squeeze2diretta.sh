@@ -22,6 +22,8 @@ DSD_FORMAT="${DSD_FORMAT:-u32be}"
 PAUSE_ON_START="${PAUSE_ON_START:-no}"
 SAMPLE_FORMAT="${SAMPLE_FORMAT:-32}"
 VERBOSE="${VERBOSE:-}"
+THREAD_PLACEMENT="${THREAD_PLACEMENT:-}"
+ZONES_FILE="${ZONES_FILE:-}"
 EXTRA_OPTS="${EXTRA_OPTS:-}"
 SQUEEZE2DIRETTA="$INSTALL_DIR/squeeze2diretta"
 SQUEEZELITE="$INSTALL_DIR/squeezelite"
@@ -30,8 +32,13 @@ SQUEEZELITE="$INSTALL_DIR/squeezelite"
 CMD="$SQUEEZE2DIRETTA"
 CMD="$CMD --squeezelite $SQUEEZELITE"
 CMD="$CMD -s $LMS_SERVER"
-CMD="$CMD --target $TARGET"
-CMD="$CMD -n $PLAYER_NAME"
+if [ -n "$ZONES_FILE" ]; then
+    # Player names and targets come from the zone file
+    CMD="$CMD --zones $ZONES_FILE"
+else
+    CMD="$CMD --target $TARGET"
+    CMD="$CMD -n $PLAYER_NAME"
+fi
 CMD="$CMD -r $MAX_SAMPLE_RATE"
 
 # DSD format
@@ -53,6 +60,11 @@ if [ -n "$VERBOSE" ]; then
     CMD="$CMD $VERBOSE"
 fi
 
+# Thread placement (one --thread option per entry)
+for spec in $THREAD_PLACEMENT; do
+    CMD="$CMD --thread $spec"
+done
+
 # Extra options
 if [ -n "$EXTRA_OPTS" ]; then
     CMD="$CMD $EXTRA_OPTS"
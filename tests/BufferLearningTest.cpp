@@ -0,0 +1,90 @@
+/**
+ * @file BufferLearningTest.cpp
+ * @brief Learned ring latency targets: rate families and persisted state
+ */
+
+#include "Check.h"
+#include "BufferLearning.h"
+
+#include <sys/stat.h>
+
+TEST(bufferRateFamilies) {
+    struct Case {
+        bool dsd;
+        uint32_t rate;
+        const char* family;
+    } cases[] = {
+        {false, 44100, "pcm48k"},     {false, 48000, "pcm48k"},
+        {false, 88200, "pcm96k"},     {false, 96000, "pcm96k"},
+        {false, 176400, "pcm192k"},   {false, 192000, "pcm192k"},
+        {false, 352800, "pcm384k"},   {false, 705600, "pcm768k"},
+        {false, 768000, "pcm768k"},   {false, 1536000, "pcm1536k"},
+        {true, 2822400, "dsd64"},     {true, 3072000, "dsd64"},
+        {true, 5644800, "dsd128"},    {true, 11289600, "dsd256"},
+        {true, 22579200, "dsd512"},   {true, 45158400, "dsd1024"},
+    };
+    for (const Case& c : cases) {
+        std::string family = BufferLearning::rateFamily(c.dsd, c.rate);
+        if (family != c.family) {
+            Check::fail(__FILE__, __LINE__, std::to_string(c.rate) + ": expected " + c.family + ", got " + family);
+        }
+    }
+}
+
+TEST(bufferNothingLearned) {
+    BufferLearning learning;
+    learning.open("", "t");
+    CHECK(learning.learnedMs("pcm48k") == 0);
+    learning.remember("pcm48k", 40, 3.0, 1.0);
+    CHECK(learning.learnedMs("pcm48k") == 40);
+    // No state directory: learned for this run only
+    std::string error;
+    CHECK(learning.save(error));
+}
+
+TEST(bufferUnchangedIsNotWritten) {
+    std::string dir = Check::tempDir();
+    BufferLearning learning;
+    learning.open(dir, "t");
+    std::string error;
+    CHECK(learning.save(error));
+    struct stat st;
+    CHECK(stat((dir + "/buffer.state").c_str(), &st) != 0);
+}
+
+TEST(bufferStateRoundTrip) {
+    std::string dir = Check::tempDir();
+    std::string error;
+    {
+        BufferLearning a;
+        a.open(dir, "Target 1");
+        a.remember("pcm192k", 60, 12.34, 0.5);
+        a.remember("dsd512", 120, 20.0, 2.0);
+        CHECK(a.save(error));
+
+        // Another zone in the same file
+        BufferLearning b;
+        b.open(dir, "Target 2");
+        b.remember("pcm192k", 35, 5.0, 0.2);
+        CHECK(b.save(error));
+    }
+
+    BufferLearning a;
+    a.open(dir, "Target 1");
+    CHECK(a.learnedMs("pcm192k") == 60);
+    CHECK(a.learnedMs("dsd512") == 120);
+    CHECK(a.learnedMs("pcm48k") == 0);
+
+    BufferLearning b;
+    b.open(dir, "Target 2");
+    CHECK(b.learnedMs("pcm192k") == 35);
+    CHECK(b.learnedMs("dsd512") == 0);
+
+    // Settling again at the same place changes nothing; a new target does
+    a.remember("pcm192k", 60, 12.3, 0.5);
+    a.remember("pcm192k", 50, 12.3, 0.5);
+    CHECK(a.save(error));
+    BufferLearning again;
+    again.open(dir, "Target 1");
+    CHECK(again.learnedMs("pcm192k") == 50);
+}
@@ -0,0 +1,42 @@
+/**
+ * @file Check.h
+ * @brief Minimal test registry for the units that need no SDK (make check)
+ *
+ * TEST(name) { ... } registers a test; CHECK() and CHECK_NEAR() record a
+ * failure with its location and carry on, so one run lists every failure.
+ */
+
+#ifndef SQUEEZE2DIRETTA_TESTS_CHECK_H
+#define SQUEEZE2DIRETTA_TESTS_CHECK_H
+
+#include <cmath>
+#include <string>
+
+namespace Check {
+    using TestFn = void (*)();
+
+    bool add(const char* name, TestFn fn);
+    void fail(const char* file, int line, const std::string& what);
+
+    // Fresh directory under $TMPDIR (or /tmp) for state file tests
+    std::string tempDir();
+}
+
+#define TEST(name) \
+    static void name(); \
+    static const bool name##_registered = Check::add(#name, name); \
+    static void name()
+
+#define CHECK(cond) do { \
+    if (!(cond)) Check::fail(__FILE__, __LINE__, #cond); \
+} while (0)
+
+#define CHECK_NEAR(a, b, eps) do { \
+    double check_a_ = (a), check_b_ = (b); \
+    if (!(std::fabs(check_a_ - check_b_) <= (eps))) { \
+        Check::fail(__FILE__, __LINE__, #a " == " #b " (" + std::to_string(check_a_) + " vs " \
+                    + std::to_string(check_b_) + ")"); \
+    } \
+} while (0)
+
+#endif // SQUEEZE2DIRETTA_TESTS_CHECK_H
@@ -0,0 +1,150 @@
+/**
+ * @file CycleTuningTest.cpp
+ * @brief Cycle time / transfer mode trials: scoring, neighbours, settling
+ */
+
+#include "Check.h"
+#include "CycleTuning.h"
+
+namespace {
+
+using Settings = CycleTuning::Settings;
+
+Settings settings(unsigned int cycleUs, int mode) {
+    Settings s;
+    s.cycleUs = cycleUs;
+    s.mode = mode;
+    return s;
+}
+
+CycleTuning::Result session(double jitterUs, uint32_t underruns = 0) {
+    CycleTuning::Result r;
+    r.seconds = 60.0;
+    r.jitterUs = jitterUs;
+    r.underruns = underruns;
+    return r;
+}
+
+const std::string KEY = CycleTuning::rateKey(false, 192000);
+
+} // namespace
+
+TEST(cycleScore) {
+    CycleTuning::Result r;
+    r.seconds = 120.0;
+    r.jitterUs = 5.0;
+    r.lateCallbacks = 6;    // 3 per minute, 10us each
+    r.underruns = 1;        // 0.5 per minute, 1000us each
+    CHECK_NEAR(CycleTuning::score(r), 5.0 + 30.0 + 500.0, 1e-9);
+    CHECK(KEY == "pcm192000");
+    CHECK(CycleTuning::rateKey(true, 22579200) == "dsd22579200");
+}
+
+TEST(cycleShortSessionsDoNotCount) {
+    CycleTuning tuning;
+    tuning.open("", "t", 0, 0, {0, 1, 2});
+    Settings base = settings(1000, 0);
+    CycleTuning::Result r = session(5.0);
+    r.seconds = CycleTuning::MIN_SESSION_S - 1.0;
+    CHECK(!tuning.report(KEY, base, base, r));
+    CHECK(tuning.next(KEY, base) == base);
+    CHECK(tuning.describe(KEY) == "no result yet");
+}
+
+TEST(cycleTriesNeighboursThenSettles) {
+    CycleTuning tuning;
+    tuning.open("", "t", 0, 0, {0, 1, 2});
+    Settings base = settings(1000, 0);
+
+    CHECK(tuning.next(KEY, base) == base);
+    CHECK(tuning.report(KEY, base, base, session(20.0)));
+    // Shorter cycle first, then longer, then the other modes
+    CHECK(tuning.next(KEY, base) == settings(900, 0));
+
+    // Shorter is better: the search moves there
+    CHECK(tuning.report(KEY, settings(900, 0), base, session(10.0)));
+    CHECK(tuning.next(KEY, base) == settings(810, 0));
+
+    // Every neighbour of 900/FixAuto is worse; 1000/FixAuto was tried already
+    Settings expected[] = {settings(810, 0), settings(990, 0), settings(900, 1), settings(900, 2)};
+    for (const Settings& s : expected) {
+        CHECK(tuning.next(KEY, base) == s);
+        CHECK(tuning.report(KEY, s, base, session(15.0)));
+    }
+    CHECK(tuning.next(KEY, base) == settings(900, 0));
+    CHECK(tuning.describe(KEY).find("settled") != std::string::npos);
+
+    // Repeat sessions on the best follow its score
+    CHECK(tuning.report(KEY, settings(900, 0), base, session(14.0)));
+    CHECK(tuning.describe(KEY).find("score 12.0") != std::string::npos);
+}
+
+TEST(cycleSettlesAfterMaxTrials) {
+    CycleTuning tuning;
+    tuning.open("", "t", 0, 0, {0, 1, 2});
+    Settings base = settings(1000, 0);
+    tuning.report(KEY, base, base, session(100.0));
+
+    // Every trial improves, so the queue never runs dry
+    int trials = 0;
+    while (tuning.describe(KEY).find("settled") == std::string::npos && trials < 100) {
+        trials++;
+        tuning.report(KEY, tuning.next(KEY, base), base, session(100.0 - trials));
+    }
+    CHECK(trials == CycleTuning::MAX_TRIALS);
+}
+
+TEST(cycleNeighboursStayInBounds) {
+    CycleTuning tuning;
+    tuning.open("", "t", 950, 1050, {0});
+    Settings base = settings(1000, 0);
+    tuning.report(KEY, base, base, session(20.0));
+    CHECK(tuning.next(KEY, base) == settings(950, 0));
+    tuning.report(KEY, settings(950, 0), base, session(30.0));
+    CHECK(tuning.next(KEY, base) == settings(1050, 0));
+    tuning.report(KEY, settings(1050, 0), base, session(30.0));
+    // Only mode 0 allowed: nothing left to try
+    CHECK(tuning.next(KEY, base) == base);
+    CHECK(tuning.describe(KEY).find("settled") != std::string::npos);
+}
+
+TEST(cycleSettleFromCalibration) {
+    CycleTuning tuning;
+    tuning.open("", "t", 0, 0, {0, 1, 2});
+    tuning.settle(KEY, settings(750, 2), 1000, 3.5);
+    CHECK(tuning.next(KEY, settings(1000, 0)) == settings(750, 2));
+    CHECK(tuning.describe(KEY) == "best 750us VarMax (score 3.5), settled");
+}
+
+TEST(cycleStateRoundTrip) {
+    std::string dir = Check::tempDir();
+    Settings base = settings(1000, 0);
+    std::string error;
+    {
+        CycleTuning tuning;
+        tuning.open(dir, "Target #1", 0, 0, {0, 1, 2});
+        tuning.report(KEY, base, base, session(20.0));
+        tuning.report(KEY, settings(900, 0), base, session(30.0));
+        CHECK(tuning.save(error));
+
+        CycleTuning other;
+        other.open(dir, "Target #2", 0, 0, {0, 1, 2});
+        other.settle(KEY, settings(1200, 1), 1000, 8.0);
+        CHECK(other.save(error));
+    }
+
+    // Mid-search: best kept, tried settings not queued again
+    CycleTuning tuning;
+    tuning.open(dir, "Target #1", 0, 0, {0, 1, 2});
+    CHECK(tuning.describe(KEY) == "best 1000us FixAuto (score 20.0), trial 1/8, 3 to try");
+    CHECK(tuning.next(KEY, base) == settings(1100, 0));
+
+    // The other target's entry survived the first one's save
+    CycleTuning other;
+    other.open(dir, "Target #2", 0, 0, {0, 1, 2});
+    CHECK(other.next(KEY, base) == settings(1200, 1));
+
+    CycleTuning unknown;
+    unknown.open(dir, "Target #3", 0, 0, {0, 1, 2});
+    CHECK(unknown.next(KEY, base) == base);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file FillControlTest.cpp
+ * @brief Fill-level controller arithmetic (FillControl::step)
+ */
+
+#include "Check.h"
+#include "FillControl.h"
+
+namespace {
+
+constexpr double GAIN = 0.25;
+constexpr double BIAS_MAX = 0.25;
+
+FillControl::Period period(double meanFill, double pushed, double consumed, uint64_t gatedWaits) {
+    FillControl::Period p;
+    p.targetBytes = 10000.0;
+    p.meanFill = meanFill;
+    p.pushedBytes = pushed;
+    p.consumedBytes = consumed;
+    p.pushes = 10;
+    p.gatedWaits = gatedWaits;
+    p.minGate = 5000.0;
+    p.maxGate = 20000.0;
+    return p;
+}
+
+} // namespace
+
+TEST(fillGatedPeriodTrims) {
+    FillControl::State state;
+    // Fill 2000 below target while gated: a quarter of the error is trimmed in
+    double gate = FillControl::step(state, period(8000.0, 20000.0, 20000.0, 3), GAIN, BIAS_MAX);
+    CHECK_NEAR(state.trim, 500.0, 1e-9);
+    CHECK_NEAR(state.rateRatio, 1.0, 1e-9);
+    CHECK_NEAR(state.rateBias, 0.0, 1e-9);
+    // target - half an average push (1000) + trim
+    CHECK_NEAR(gate, 9500.0, 1e-9);
+
+    // The trim integrates, up to half the target
+    for (int i = 0; i < 100; i++) {
+        gate = FillControl::step(state, period(8000.0, 20000.0, 20000.0, 3), GAIN, BIAS_MAX);
+    }
+    CHECK_NEAR(state.trim, 5000.0, 1e-9);
+    CHECK_NEAR(gate, 14000.0, 1e-9);
+}
+
+TEST(fillUngatedPeriodDoesNotWindUp) {
+    FillControl::State state;
+    state.trim = 300.0;
+    // A producer slower than real time was never gated: the trim holds, the
+    // push/pop ratio (0.75) raises the level, capped at a quarter of the target
+    double gate = FillControl::step(state, period(4000.0, 15000.0, 20000.0, 0), GAIN, BIAS_MAX);
+    CHECK_NEAR(state.trim, 300.0, 1e-9);
+    CHECK_NEAR(state.rateRatio, 0.75, 1e-9);
+    CHECK_NEAR(state.rateBias, 2500.0, 1e-9);
+    CHECK_NEAR(gate, 10000.0 - 750.0 + 300.0 + 2500.0, 1e-9);
+
+    // Gated again: the bias decays by half per period
+    FillControl::step(state, period(10000.0, 20000.0, 20000.0, 1), GAIN, BIAS_MAX);
+    CHECK_NEAR(state.rateBias, 1250.0, 1e-9);
+    FillControl::step(state, period(10000.0, 20000.0, 20000.0, 1), GAIN, BIAS_MAX);
+    CHECK_NEAR(state.rateBias, 625.0, 1e-9);
+}
+
+TEST(fillProducerAheadLowersTheLevel) {
+    FillControl::State state;
+    // Pushing 10% faster than the pops, ungated: lean down by the drift
+    FillControl::step(state, period(10000.0, 22000.0, 20000.0, 0), GAIN, BIAS_MAX);
+    CHECK_NEAR(state.rateBias, -2000.0, 1e-9);
+}
+
+TEST(fillGateBounds) {
+    FillControl::State state;
+    // Far above target while gated: clamped to the lower bound
+    state.trim = -4900.0;
+    double gate = FillControl::step(state, period(30000.0, 20000.0, 20000.0, 1), GAIN, BIAS_MAX);
+    CHECK_NEAR(gate, 5000.0, 1e-9);
+
+    FillControl::Period p = period(0.0, 0.0, 0.0, 0);
+    p.maxGate = 8000.0;
+    state = FillControl::State();
+    CHECK_NEAR(FillControl::step(state, p, GAIN, BIAS_MAX), 8000.0, 1e-9);
+    // Nothing popped: no ratio, no bias
+    CHECK_NEAR(state.rateRatio, 0.0, 1e-9);
+    CHECK_NEAR(state.rateBias, 0.0, 1e-9);
+    CHECK_NEAR(FillControl::halfPush(p), 0.0, 1e-9);
+}
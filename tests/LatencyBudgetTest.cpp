@@ -0,0 +1,55 @@
+/**
+ * @file LatencyBudgetTest.cpp
+ * @brief --latency-budget split (LatencyBudget::outputKb, plan, ringMs)
+ */
+
+#include "Check.h"
+#include "LatencyBudget.h"
+
+TEST(budgetOutputKb) {
+    // A quarter of 1 s at 768 kHz S32 stereo: 1536000 bytes
+    CHECK(LatencyBudget::outputKb(768000.0, 1000) == 1500);
+    // Never below the floor
+    CHECK(LatencyBudget::outputKb(768000.0, 100) == LatencyBudget::OUTPUT_MIN_KB);
+    CHECK(LatencyBudget::outputKb(44100.0, 1000) == LatencyBudget::OUTPUT_MIN_KB);
+}
+
+TEST(budgetSplitAtTheSizingRate) {
+    // Output buffer sized at 768 kHz and played at 768 kHz: exactly its quarter
+    LatencyBudget::Split split = LatencyBudget::plan(1000, 1500, 768000, 20.0);
+    CHECK_NEAR(split.outputMs, 250.0, 1e-9);
+    CHECK_NEAR(split.availableMs, 750.0, 1e-9);
+    CHECK_NEAR(split.pipeMs, 250.0, 1e-9);
+
+    // The pipe got what it asked for: the ring takes the rest, the total is the budget
+    double ring = LatencyBudget::ringMs(split, 250.0);
+    CHECK_NEAR(ring, 500.0, 1e-9);
+    CHECK_NEAR(split.outputMs + 250.0 + ring, 1000.0, 1e-9);
+
+    // The pipe was rounded up past the budget: the ring keeps its need
+    CHECK_NEAR(LatencyBudget::ringMs(split, 745.0), 20.0, 1e-9);
+}
+
+TEST(budgetSplitAtALowerRate) {
+    // Same bytes hold twice the time at 384 kHz: 500 ms of output buffer
+    LatencyBudget::Split split = LatencyBudget::plan(1000, 1500, 384000, 100.0);
+    CHECK_NEAR(split.outputMs, 500.0, 1e-9);
+    CHECK_NEAR(split.pipeMs, 250.0, 1e-9);
+    CHECK_NEAR(LatencyBudget::ringMs(split, 250.0), 250.0, 1e-9);
+
+    // Little left: the ring's need comes before the pipe's quarter
+    split = LatencyBudget::plan(1000, 1500, 384000, 400.0);
+    CHECK_NEAR(split.pipeMs, 100.0, 1e-9);
+    CHECK_NEAR(LatencyBudget::ringMs(split, 100.0), 400.0, 1e-9);
+}
+
+TEST(budgetCannotBeMet) {
+    // At 44.1 kHz the 512 KB floor alone is ~1.5 s: nothing is left, the
+    // pipe share goes negative (the wrapper asks for its floor) and the ring
+    // keeps its need
+    LatencyBudget::Split split = LatencyBudget::plan(300, LatencyBudget::OUTPUT_MIN_KB, 44100, 20.0);
+    CHECK(split.outputMs > 1480.0 && split.outputMs < 1490.0);
+    CHECK(split.availableMs < 0.0);
+    CHECK(split.pipeMs < 0.0);
+    CHECK_NEAR(LatencyBudget::ringMs(split, 50.0), 20.0, 1e-9);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file ThreadPolicyTest.cpp
+ * @brief --thread spec parsing (parseThreadPolicy, parseThreadAssignment)
+ */
+
+#include "Check.h"
+#include "ThreadPolicy.h"
+
+TEST(policyFifoWithCpu) {
+    ThreadPolicy p;
+    std::string error;
+    CHECK(parseThreadPolicy("fifo:60@2", p, error));
+    CHECK(p.policy == SchedPolicy::Fifo);
+    CHECK(p.priority == 60);
+    CHECK(p.cpus == std::vector<int>({2}));
+}
+
+TEST(policyOtherNiceAndCpuList) {
+    ThreadPolicy p;
+    std::string error;
+    CHECK(parseThreadPolicy("other:-5@1,3", p, error));
+    CHECK(p.policy == SchedPolicy::Other);
+    CHECK(p.priority == -5);
+    CHECK(p.cpus == std::vector<int>({1, 3}));
+
+    CHECK(parseThreadPolicy("rr:10", p, error));
+    CHECK(p.policy == SchedPolicy::RoundRobin);
+    CHECK(p.cpus.empty());
+}
+
+TEST(policyCpusOnly) {
+    ThreadPolicy p;
+    std::string error;
+    CHECK(parseThreadPolicy("@1-3,5", p, error));
+    CHECK(p.policy == SchedPolicy::Inherit);
+    CHECK(p.cpus == std::vector<int>({1, 2, 3, 5}));
+    CHECK(!p.isInherit());
+}
+
+TEST(policyDeadline) {
+    ThreadPolicy p;
+    std::string error;
+    CHECK(parseThreadPolicy("deadline:200/1000", p, error));
+    CHECK(p.policy == SchedPolicy::Deadline);
+    CHECK(p.dlRuntimeUs == 200);
+    CHECK(p.dlPeriodUs == 1000);
+    CHECK(!p.isDeadlineAuto());
+
+    CHECK(parseThreadPolicy("deadline:auto", p, error));
+    CHECK(p.isDeadlineAuto());
+}
+
+TEST(policyRejectsBadSpecs) {
+    const char* bad[] = {
+        "fifo", "fifo:0", "fifo:100", "rr:x", "other:20", "other:-21",
+        "deadline:2000/1000", "deadline:0/1000", "deadline:100", "idle",
+        "@", "@3-1", "@a", "fifo:50@",
+    };
+    for (const char* spec : bad) {
+        ThreadPolicy p = ThreadPolicy::fifo(42);
+        std::string error;
+        bool ok = parseThreadPolicy(spec, p, error);
+        if (ok) Check::fail(__FILE__, __LINE__, std::string("accepted '") + spec + "'");
+        CHECK(!error.empty());
+        // A rejected spec leaves the policy alone
+        CHECK(p.policy == SchedPolicy::Fifo && p.priority == 42);
+    }
+}
+
+TEST(assignmentRoles) {
+    ThreadPlacement placement;
+    std::string error;
+    CHECK(placement[ThreadRole::Worker].policy == SchedPolicy::Fifo);
+    CHECK(placement[ThreadRole::Worker].priority == 50);
+
+    CHECK(parseThreadAssignment("convert=@1,3", placement, error));
+    CHECK(placement[ThreadRole::Convert].cpus == std::vector<int>({1, 3}));
+    CHECK(parseThreadAssignment("worker=deadline:auto", placement, error));
+    CHECK(placement[ThreadRole::Worker].isDeadlineAuto());
+    CHECK(parseThreadAssignment("log=other:5", placement, error));
+    CHECK(placement[ThreadRole::LogDrain].priority == 5);
+}
+
+TEST(assignmentRejects) {
+    ThreadPlacement placement;
+    std::string error;
+    CHECK(!parseThreadAssignment("worker", placement, error));
+    CHECK(!parseThreadAssignment("sdk=deadline:auto", placement, error));
+    CHECK(error.find("only available for the worker") != std::string::npos);
+    CHECK(!parseThreadAssignment("squeezelite=deadline:100/1000", placement, error));
+    CHECK(!parseThreadAssignment("ingest=fifo:0", placement, error));
+    CHECK(error.compare(0, 8, "ingest: ") == 0);
+
+    // The message lists every role
+    CHECK(!parseThreadAssignment("decoder=fifo:10", placement, error));
+    for (int i = 0; i < static_cast<int>(ThreadRole::COUNT); i++) {
+        CHECK(error.find(threadRoleName(static_cast<ThreadRole>(i))) != std::string::npos);
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file ZoneFileTest.cpp
+ * @brief Zone file parsing (parseZones, loadZoneFile)
+ */
+
+#include "Check.h"
+#include "ZoneFile.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+ZoneSpec defaults() {
+    ZoneSpec d;
+    d.rates = "192000";
+    d.worker = ThreadPolicy::fifo(50);
+    return d;
+}
+
+bool parse(const std::string& text, std::vector<ZoneSpec>& zones, std::string& error) {
+    std::istringstream in(text);
+    return parseZones(in, "zones", defaults(), zones, error);
+}
+
+} // namespace
+
+TEST(zonesValid) {
+    std::vector<ZoneSpec> zones;
+    std::string error;
+    CHECK(parse("# two rooms\n"
+                "name=\"Living Room\" target=1   # main system\n"
+                "\n"
+                "name=Kitchen\ttarget=3 mac=02:00:00:00:00:01 rates=96000 worker=fifo:70@2\r\n",
+                zones, error));
+    CHECK(zones.size() == 2);
+    if (zones.size() != 2) return;
+
+    CHECK(zones[0].name == "Living Room");
+    CHECK(zones[0].target == 0);
+    CHECK(zones[0].mac.empty());
+    CHECK(zones[0].rates == "192000");
+    CHECK(zones[0].worker.priority == 50);
+
+    CHECK(zones[1].name == "Kitchen");
+    CHECK(zones[1].target == 2);
+    CHECK(zones[1].mac == "02:00:00:00:00:01");
+    CHECK(zones[1].rates == "96000");
+    CHECK(zones[1].worker.priority == 70);
+    CHECK(zones[1].worker.cpus == std::vector<int>({2}));
+}
+
+TEST(zonesRejects) {
+    struct Case {
+        const char* text;
+        const char* message;
+    } cases[] = {
+        {"name=A\n", "zones:1: name= and target= are required"},
+        {"target=1\n", "zones:1: name= and target= are required"},
+        {"name=A target=0\n", "zones:1: invalid target '0'"},
+        {"name=A target=1x\n", "zones:1: invalid target '1x'"},
+        {"name=A target=1 room=3\n", "zones:1: unknown key 'room'"},
+        {"name=A target=1 loud\n", "zones:1: expected key=value, got 'loud'"},
+        {"name=A target=1 worker=fifo:0\n", "zones:1: worker=fifo:0: "},
+        {"name=A target=1\n# comment\nname=A target=2\n", "zones:3: duplicate zone name 'A'"},
+        {"name=A target=1\nname=B target=1\n", "zones:2: target 1 already used by 'A'"},
+        {"\n# nothing here\n", "zones: no zones defined"},
+    };
+    for (const Case& c : cases) {
+        std::vector<ZoneSpec> zones;
+        std::string error;
+        CHECK(!parse(c.text, zones, error));
+        if (error.compare(0, std::string(c.message).size(), c.message) != 0) {
+            Check::fail(__FILE__, __LINE__, "expected '" + std::string(c.message) + "', got '" + error + "'");
+        }
+    }
+}
+
+TEST(zonesFromFile) {
+    std::string dir = Check::tempDir();
+    std::string path = dir + "/zones.conf";
+    std::ofstream(path) << "name=Study target=2\n";
+
+    std::vector<ZoneSpec> zones;
+    std::string error;
+    CHECK(loadZoneFile(path, defaults(), zones, error));
+    CHECK(zones.size() == 1 && zones[0].target == 1);
+
+    zones.clear();
+    CHECK(!loadZoneFile(dir + "/missing.conf", defaults(), zones, error));
+    CHECK(error.find("cannot open") == 0);
+}
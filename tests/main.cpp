@@ -0,0 +1,78 @@
+/**
+ * @file main.cpp
+ * @brief Runs every registered test; exit status 1 if any check failed
+ */
+
+#include "Check.h"
+#include "LogLevel.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <ftw.h>
+
+// The units under test log through LOG_*; keep the output to failures
+LogLevel g_logLevel = LogLevel::ERROR;
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    Check::TestFn fn;
+};
+
+std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+const char* g_current = "";
+int g_failures = 0;
+std::vector<std::string> g_tempDirs;
+
+int removeEntry(const char* path, const struct stat*, int, struct FTW*) {
+    return std::remove(path);
+}
+
+} // namespace
+
+namespace Check {
+
+bool add(const char* name, TestFn fn) {
+    registry().push_back({name, fn});
+    return true;
+}
+
+void fail(const char* file, int line, const std::string& what) {
+    std::cerr << file << ":" << line << ": " << g_current << ": " << what << std::endl;
+    g_failures++;
+}
+
+std::string tempDir() {
+    const char* base = std::getenv("TMPDIR");
+    std::string pattern = std::string(base && *base ? base : "/tmp") + "/s2d-test-XXXXXX";
+    std::vector<char> path(pattern.begin(), pattern.end());
+    path.push_back('\0');
+    if (!mkdtemp(path.data())) {
+        fail(__FILE__, __LINE__, "mkdtemp " + pattern);
+        return "";
+    }
+    g_tempDirs.push_back(path.data());
+    return path.data();
+}
+
+} // namespace Check
+
+int main() {
+    for (const TestCase& test : registry()) {
+        g_current = test.name;
+        test.fn();
+    }
+    for (const std::string& dir : g_tempDirs) {
+        nftw(dir.c_str(), removeEntry, 8, FTW_DEPTH | FTW_PHYS);
+    }
+    std::cout << registry().size() << " tests, " << g_failures << " failed checks" << std::endl;
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file squeezelite-testgen.cpp
+ * @brief Stand-in for the patched squeezelite that streams a test signal
+ *
+ * Writes the same stream the patched squeezelite produces on stdout (a
+ * 16-byte "SQFH" format header, then S32_LE frames) at real-time pace, so
+ * the wrapper's ingest path can be exercised at rates no LMS library has at
+ * hand, DSD1024 in particular:
+ *
+ *   S2D_TESTGEN=dsd1024 squeeze2diretta --squeezelite ./squeezelite-testgen \
+ *       --target 1 -r 1536000 -D :u32be
+ *
+ * Squeezelite arguments are accepted and ignored, except -D, which selects
+ * the DSD container like squeezelite does (no value: DoP, :u32le, :u32be).
+ *
+ * Environment:
+ *   S2D_TESTGEN          Signal: pcm44k, pcm96k, pcm192k, pcm384k, pcm768k,
+ *                        dsd64, dsd128, dsd256, dsd512, dsd1024 (default)
+ *   S2D_TESTGEN_SECONDS  Stream length, 0 = until killed (default)
+ *   S2D_TESTGEN_PACE     Speed relative to real time (default 1.0;
+ *                        0 = as fast as the pipe takes it)
+ *   SQ_STDOUT_WRITE_BYTES  Bytes per write(), whole frames, as in the
+ *                        patched squeezelite (set by the wrapper; default
+ *                        10 ms of audio)
+ *
+ * Needs neither the Diretta SDK nor the wrapper's sources, only the stream
+ * format and test signals it shares with them (diretta/SqStream.cpp).
+ */
+
+#include "SqStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+struct Signal {
+    const char* name;
+    uint32_t rate;           // PCM sample rate or DSD bit rate
+    bool dsd;
+};
+
+const Signal SIGNALS[] = {
+    {"pcm44k",  44100,    false},
+    {"pcm96k",  96000,    false},
+    {"pcm192k", 192000,   false},
+    {"pcm384k", 384000,   false},
+    {"pcm768k", 768000,   false},
+    {"dsd64",   2822400,  true},
+    {"dsd128",  5644800,  true},
+    {"dsd256",  11289600, true},
+    {"dsd512",  22579200, true},
+    {"dsd1024", 45158400, true},
+};
+
+double envDouble(const char* name, double fallback) {
+    const char* value = std::getenv(name);
+    return (value && *value) ? std::atof(value) : fallback;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace SqStream;
+
+    // -D without a value means DoP, as in squeezelite
+    DsdContainer container = DOP;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-D") != 0) continue;
+        if (i + 1 < argc && argv[i + 1][0] == ':') {
+            container = std::strcmp(argv[i + 1], ":u32le") == 0 ? U32_LE : U32_BE;
+        }
+    }
+
+    const char* wanted = std::getenv("S2D_TESTGEN");
+    if (!wanted || !*wanted) wanted = "dsd1024";
+    const Signal* signal = nullptr;
+    for (const Signal& s : SIGNALS) {
+        if (std::strcmp(s.name, wanted) == 0) signal = &s;
+    }
+    if (!signal) {
+        std::fprintf(stderr, "squeezelite-testgen: unknown signal '%s'\n", wanted);
+        return 1;
+    }
+
+    double seconds = envDouble("S2D_TESTGEN_SECONDS", 0.0);
+    double pace = envDouble("S2D_TESTGEN_PACE", 1.0);
+
+    SqFormatHeader hdr = testHeader(signal->dsd, signal->rate, container);
+    std::vector<uint8_t> loop = signal->dsd ? renderDsd(signal->rate, container) : renderPcm(signal->rate);
+
+    const size_t frameBytes = CHANNELS * 4;
+    const double bytesPerSecond = double(hdr.sample_rate) * frameBytes;
+    size_t writeBytes = static_cast<size_t>(envDouble("SQ_STDOUT_WRITE_BYTES", 0.0)) / frameBytes * frameBytes;
+    if (writeBytes == 0) {
+        writeBytes = static_cast<size_t>(bytesPerSecond * WRITE_MS / 1000.0) / frameBytes * frameBytes;
+    }
+    const uint64_t totalBytes = seconds > 0.0
+        ? static_cast<uint64_t>(seconds * bytesPerSecond) / frameBytes * frameBytes : 0;
+
+    std::fprintf(stderr, "squeezelite-testgen: %s, header rate %u, container %u, %.2f MB/s\n",
+                 signal->name, hdr.sample_rate, hdr.dsd_format, bytesPerSecond / 1e6);
+
+    std::signal(SIGPIPE, SIG_DFL);
+    fcntl(STDOUT_FILENO, F_SETPIPE_SZ, static_cast<int>(2 * writeBytes));
+
+    // Like squeezelite, the header goes out in the same writev() as the
+    // first audio; a write that wraps the loop takes more iovecs, not more writes
+    auto start = std::chrono::steady_clock::now();
+    uint64_t written = 0;
+    size_t offset = 0;
+    bool headerPending = true;
+    std::vector<struct iovec> iov;
+    while (totalBytes == 0 || written < totalBytes) {
+        size_t len = writeBytes;
+        if (totalBytes != 0) len = static_cast<size_t>(std::min<uint64_t>(len, totalBytes - written));
+        iov.clear();
+        if (headerPending) {
+            iov.push_back({&hdr, sizeof(hdr)});
+            headerPending = false;
+        }
+        while (len > 0) {
+            size_t part = std::min(len, loop.size() - offset);
+            iov.push_back({loop.data() + offset, part});
+            offset = (offset + part) % loop.size();
+            written += part;
+            len -= part;
+        }
+        if (!writeAll(STDOUT_FILENO, iov.data(), static_cast<int>(iov.size()))) return 0;   // Reader went away
+        if (pace > 0.0) {
+            auto due = start + std::chrono::duration<double>(written / bytesPerSecond / pace);
+            std::this_thread::sleep_until(std::chrono::time_point_cast<std::chrono::steady_clock::duration>(due));
+        }
+    }
+    return 0;
+}